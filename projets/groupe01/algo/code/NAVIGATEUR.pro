@@ -1,5 +1,6 @@
 QT       += core gui widgets # Modules Qt de base, GUI et Widgets sont essentiels
 QT       += webenginewidgets # Crucial pour QWebEngineView
+QT       += network # Cache HTTP local (QNetworkAccessManager) et serveur de test (QTcpServer)
 RC_ICONS = C:/Users/Lenovo/OneDrive/Documenten/NAVIGATEUR/apps_web_browser_15742.ico
 
 # Définit le nom de l'exécutable cible
@@ -14,15 +15,64 @@ CONFIG += release
 
 # Fichiers d'entrée
 SOURCES += \
+    benchmarks.cpp \
+    bookmarksdialog.cpp \
+    bookmarkstore.cpp \
+    browsertab.cpp \
+    cacheschemehandler.cpp \
+    contentfilter.cpp \
+    diagnosticsdialog.cpp \
+    downloadmanager.cpp \
+    downloadsdialog.cpp \
+    filterengine.cpp \
+    fulltextindex.cpp \
+    httpcache.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    navigationlog.cpp \
+    omniboxindex.cpp \
+    pageindexer.cpp \
+    processmemory.cpp \
+    requestinterceptor.cpp \
+    searchschemehandler.cpp \
+    sessionhistory.cpp \
+    sessionstore.cpp \
+    standinserver.cpp \
+    urltrie.cpp \
+    webcookiejar.cpp
 
 HEADERS += \
-    mainwindow.h
+    benchmarks.h \
+    bookmarksdialog.h \
+    bookmarkstore.h \
+    browsertab.h \
+    cacheschemehandler.h \
+    contentfilter.h \
+    diagnosticsdialog.h \
+    downloadmanager.h \
+    downloadsdialog.h \
+    filterengine.h \
+    fulltextindex.h \
+    httpcache.h \
+    mainwindow.h \
+    navigationlog.h \
+    omniboxindex.h \
+    pageindexer.h \
+    processmemory.h \
+    requestinterceptor.h \
+    searchschemehandler.h \
+    sessionhistory.h \
+    sessionstore.h \
+    standinserver.h \
+    urltrie.h \
+    webcookiejar.h
 
 FORMS += \
     mainwindow.ui
 
+# Mesure de la mémoire des processus de rendu (GetProcessMemoryInfo)
+win32: LIBS += -lpsapi
+
 # Optionnel : Ajoute une icône d'application pour Windows.
 # Assurez-vous que le chemin vers votre fichier .ico est correct.
 # RC_ICONS = C:/Chemin/Vers/Votre/Icone/apps_web_browser_15742.ico
@@ -0,0 +1,725 @@
+// benchmarks.cpp
+#include "benchmarks.h"
+
+#include "bookmarkstore.h"
+#include "browsertab.h"
+#include "downloadmanager.h"
+#include "filterengine.h"
+#include "fulltextindex.h"
+#include "httpcache.h"
+#include "mainwindow.h"
+#include "pageindexer.h"
+#include "processmemory.h"
+#include "sessionstore.h"
+#include "standinserver.h"
+#include "urltrie.h"
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace {
+
+// Laisse tourner la boucle d'événements pendant ms millisecondes
+void settle(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+// Page locale assez lourde pour que chaque onglet ait un coût mémoire représentatif
+bool writeTestPage(const QString &path, int index)
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out << "<!DOCTYPE html><html><head><title>Page " << index << "</title></head><body>\n";
+    for (int i = 0; i < 2000; ++i) {
+        out << "<p>Paragraphe " << i << " de la page " << index
+            << " : Lorem ipsum dolor sit amet, consectetur adipiscing elit.</p>\n";
+    }
+    out << "<script>window.cache = new Array(200000).fill(" << index << ");</script>\n";
+    out << "</body></html>\n";
+    return true;
+}
+
+// Attend la fin (terminé ou en échec) du téléchargement id, ou que stopAt octets soient reçus
+DownloadManager::State waitForDownload(DownloadManager &manager, int id, qint64 stopAt = -1)
+{
+    QEventLoop loop;
+    auto check = [&]() {
+        const DownloadManager::Info info = manager.info(id);
+        if (info.state == DownloadManager::Finished || info.state == DownloadManager::Failed
+            || (stopAt >= 0 && info.receivedBytes >= stopAt)) {
+            loop.quit();
+        }
+    };
+    QObject::connect(&manager, &DownloadManager::downloadChanged, &loop, check);
+    QTimer::singleShot(0, &loop, check);
+    loop.exec();
+    return manager.info(id).state;
+}
+
+QByteArray fileSha256(const QString &path)
+{
+    QFile file(path);
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!file.open(QFile::ReadOnly) || !hash.addData(&file)) {
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+double mebibytes(qint64 bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+// Vocabulaire des règles de filtrage synthétiques et des URL ordinaires
+const char *const kAdWords[] = {"ad", "ads", "adserver", "banner", "track", "tracker", "pixel", "beacon",
+                                "analytics", "promo", "sponsor", "affiliate", "click", "impression",
+                                "popunder", "adframe", "metrics", "tag", "sync", "stats"};
+const char *const kWebWords[] = {"static", "assets", "images", "img", "js", "css", "api", "v1", "v2", "content",
+                                 "uploads", "media", "article", "news", "user", "profile", "search", "thumb",
+                                 "video", "player", "bundle", "vendor", "main", "app", "fonts", "docs", "wiki",
+                                 "shop", "cart", "product", "blog", "category", "page"};
+
+// Syllabes des mots des pages synthétiques (quelques-unes accentuées, comme en français)
+const char *const kSyllables[] = {"ba", "ce", "di", "fo", "gu", "la", "mé", "ni", "po", "ré", "sa", "te", "vi", "zo",
+                                  "on", "an", "eu", "ou", "ai", "tion", "ment", "ver", "con", "pre", "dé", "tra"};
+
+template <size_t N>
+std::string pick(std::mt19937 &rng, const char *const (&words)[N])
+{
+    return words[rng() % N];
+}
+
+// Centile p (0..1) d'une série de durées, en millisecondes
+double percentileMs(QVector<qint64> nanos, double p)
+{
+    if (nanos.isEmpty()) {
+        return 0;
+    }
+    std::sort(nanos.begin(), nanos.end());
+    const qsizetype rank = qMin(nanos.size() - 1, static_cast<qsizetype>(std::ceil(p * nanos.size())) - 1);
+    return nanos[qMax<qsizetype>(0, rank)] / 1e6;
+}
+
+} // namespace
+
+namespace Benchmarks {
+
+int omnibox(int entryCount)
+{
+    QTextStream out(stdout);
+    if (entryCount <= 0) {
+        out << "Paramètres invalides\n";
+        return 1;
+    }
+
+    // Une URL par page, 2 000 hôtes, visites étalées sur un an ; les pages les plus
+    // consultées (loi de Zipf approchée) reçoivent plusieurs visites
+    std::mt19937 rng(26);
+    const double now = 1.7e9;
+    std::vector<std::string> urls;
+    urls.reserve(entryCount);
+    const qint64 memoryBefore = ProcessMemory::residentBytes();
+    UrlTrie trie;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < entryCount; ++i) {
+        std::string url = "https://" + pick(rng, kWebWords) + std::to_string(rng() % 2000) + ".ictu.local/"
+                          + pick(rng, kWebWords) + "/" + pick(rng, kWebWords) + "-" + std::to_string(i);
+        const int visits = 1 + int(20 / (1 + rng() % 64));
+        for (int v = 0; v < visits; ++v) {
+            trie.recordVisit(url, now - double(rng() % (365 * 24 * 3600)));
+        }
+        trie.setTitle(url, pick(rng, kWebWords) + " " + pick(rng, kAdWords) + " " + std::to_string(i % 1000));
+        urls.push_back(std::move(url));
+    }
+    const qint64 buildNs = timer.nsecsElapsed();
+    const qint64 memoryAfter = ProcessMemory::residentBytes();
+
+    // Saisie d'une adresse ou d'un mot de titre, un caractère à la fois : chaque préfixe est
+    // une recherche des 10 meilleures suggestions, comme dans la barre d'adresse
+    QVector<qint64> latencies;
+    size_t found = 0;
+    for (int typed = 0; typed < 2000; ++typed) {
+        std::string text = typed % 2 ? UrlTrie::normalizeUrl(urls[rng() % urls.size()]) : pick(rng, kWebWords);
+        text.resize(std::min<size_t>(text.size(), 24));
+        for (size_t length = 1; length <= text.size(); ++length) {
+            timer.restart();
+            found += trie.complete(text.substr(0, length), 10).size();
+            latencies.append(timer.nsecsElapsed());
+        }
+    }
+
+    const double p99 = percentileMs(latencies, 0.99);
+    out << "entrées indexées          : " << trie.size() << " en " << QString::number(buildNs / 1e6, 'f', 0) << " ms, "
+        << QString::number(mebibytes(memoryAfter - memoryBefore), 'f', 1) << " Mio\n";
+    out << "recherches                : " << latencies.size() << " (" << found / qMax<qsizetype>(1, latencies.size())
+        << " suggestions en moyenne)\n";
+    out << "latence p50 / p99 / max   : " << QString::number(percentileMs(latencies, 0.5), 'f', 3) << " / "
+        << QString::number(p99, 'f', 3) << " / " << QString::number(percentileMs(latencies, 1.0), 'f', 3) << " ms"
+        << (p99 < 2.0 ? " (objectif 2 ms atteint)" : " (objectif 2 ms DÉPASSÉ)") << "\n";
+    return p99 < 2.0 ? 0 : 1;
+}
+
+int tabMemory(MainWindow &window, int tabCount)
+{
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "Impossible de créer le dossier temporaire\n";
+        return 1;
+    }
+
+    // Le budget est désactivé pendant le remplissage : c'est la mesure qui décharge
+    window.setTabMemoryBudget(std::numeric_limits<qint64>::max());
+
+    int loaded = 0;
+    QEventLoop allLoaded;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < tabCount; ++i) {
+        const QString path = dir.filePath(QString("page%1.html").arg(i));
+        if (!writeTestPage(path, i)) {
+            out << "Impossible d'écrire " << path << "\n";
+            return 1;
+        }
+        BrowserTab *tab = window.openTab(QUrl::fromLocalFile(path), i == 0);
+        QObject::connect(tab, &BrowserTab::loadFinished, &allLoaded, [&loaded, &allLoaded, tabCount]() {
+            if (++loaded == tabCount) {
+                allLoaded.quit();
+            }
+        });
+    }
+    QTimer::singleShot(120000, &allLoaded, &QEventLoop::quit); // Garde-fou
+    allLoaded.exec();
+    const qint64 loadMs = timer.elapsed();
+    settle(2000);
+
+    const qint64 before = ProcessMemory::residentBytes();
+    const int discarded = window.discardBackgroundTabs(tabCount);
+    settle(3000); // Les processus de rendu se terminent de façon asynchrone
+    const qint64 after = ProcessMemory::residentBytes();
+
+    out << "onglets ouverts      : " << tabCount << " (" << loaded << " chargés en " << loadMs << " ms)\n";
+    out << "mémoire avant        : " << QString::number(mebibytes(before), 'f', 1) << " Mio\n";
+    out << "onglets déchargés    : " << discarded << "\n";
+    out << "mémoire après        : " << QString::number(mebibytes(after), 'f', 1) << " Mio\n";
+    out << "mémoire libérée      : " << QString::number(mebibytes(before - after), 'f', 1) << " Mio\n";
+    return loaded == tabCount ? 0 : 1;
+}
+
+int sessionStartup(int tabCount)
+{
+    const int pagesPerTab = 10;
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "Impossible de créer le dossier temporaire\n";
+        return 1;
+    }
+
+    // Session synthétique : chaque onglet a 10 pages locales dans son historique
+    SessionData session;
+    for (int t = 0; t < tabCount; ++t) {
+        TabState tab;
+        for (int p = 0; p < pagesPerTab; ++p) {
+            const int page = (t + p) % pagesPerTab;
+            const QString path = dir.filePath(QString("page%1.html").arg(page));
+            if (t == 0 && !writeTestPage(path, page)) {
+                out << "Impossible d'écrire " << path << "\n";
+                return 1;
+            }
+            HistoryEntry entry;
+            entry.url = QUrl::fromLocalFile(path);
+            entry.title = QString("Page %1").arg(page);
+            entry.scrollPosition = QPointF(0, 40.0 * p);
+            tab.entries.append(entry);
+        }
+        tab.currentIndex = pagesPerTab - 1;
+        session.tabs.append(tab);
+    }
+    session.activeTab = tabCount / 2;
+
+    const QString sessionPath = dir.filePath("session.bin");
+    QElapsedTimer timer;
+    timer.start();
+    if (!SessionStore::writeFile(sessionPath, session)) {
+        out << "Impossible d'écrire la session\n";
+        return 1;
+    }
+    const qint64 writeUs = timer.nsecsElapsed() / 1000;
+
+    timer.restart();
+    SessionData reloaded;
+    const bool readOk = SessionStore::readFile(sessionPath, reloaded);
+    const qint64 readUs = timer.nsecsElapsed() / 1000;
+
+    // Démarrage : construction de la fenêtre (restauration comprise) puis premier affichage
+    timer.restart();
+    MainWindow window(nullptr, sessionPath);
+    window.show();
+    const qint64 restoreMs = timer.elapsed();
+
+    QEventLoop firstPage;
+    if (BrowserTab *active = window.currentTab()) {
+        QObject::connect(active, &BrowserTab::loadFinished, &firstPage, &QEventLoop::quit);
+    }
+    QTimer::singleShot(30000, &firstPage, &QEventLoop::quit); // Garde-fou
+    firstPage.exec();
+    const qint64 firstPageMs = timer.elapsed();
+
+    int liveTabs = 0;
+    for (int i = 0; i < window.tabCount(); ++i) {
+        liveTabs += window.tabAt(i)->isLive() ? 1 : 0;
+    }
+
+    out << "onglets dans la session : " << tabCount << " (" << tabCount * pagesPerTab << " entrées d'historique)\n";
+    out << "taille du fichier       : " << QFile(sessionPath).size() << " octets\n";
+    out << "écriture / lecture      : " << writeUs << " µs / " << readUs << " µs" << (readOk ? "" : " (ÉCHEC)") << "\n";
+    out << "fenêtre restaurée en    : " << restoreMs << " ms\n";
+    out << "onglet actif affiché en : " << firstPageMs << " ms\n";
+    out << "onglets chargés         : " << liveTabs << " / " << window.tabCount() << "\n";
+    return readOk && liveTabs == 1 ? 0 : 1;
+}
+
+int httpCache(int requestCount)
+{
+    const int pageCount = 200;
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    StandInServer server;
+    if (!dir.isValid() || !server.start()) {
+        out << "Impossible de préparer le dossier temporaire ou le serveur local\n";
+        return 1;
+    }
+    server.setLatency(20);
+
+    // Pages de 15 à 40 Kio ; une sur deux n'a pas de durée de vie (revalidation par ETag)
+    for (int i = 0; i < pageCount; ++i) {
+        QByteArray body = "<!DOCTYPE html><html><head><title>Page " + QByteArray::number(i) + "</title></head><body>\n";
+        const int paragraphs = 300 + (i % 5) * 150;
+        for (int p = 0; p < paragraphs; ++p) {
+            body += "<p>Paragraphe " + QByteArray::number(p) + " de la page " + QByteArray::number(i)
+                  + " de l'intranet.</p>\n";
+        }
+        body += "</body></html>\n";
+        server.setResource(QString("/page%1.html").arg(i), body, "text/html; charset=utf-8", i % 2 ? -1 : 300);
+    }
+
+    // Séquence de Zipf (s = 1) : quelques pages reviennent sans cesse, comme sur l'intranet
+    std::vector<double> weights(pageCount);
+    for (int i = 0; i < pageCount; ++i) {
+        weights[i] = 1.0 / (i + 1);
+    }
+    std::mt19937 rng(42);
+    std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+    QVector<QUrl> sequence;
+    sequence.reserve(requestCount);
+    for (int i = 0; i < requestCount; ++i) {
+        sequence.append(server.url(QString("/page%1.html").arg(zipf(rng))));
+    }
+
+    // 1. Sans cache : chaque requête va au serveur
+    QNetworkAccessManager network;
+    QVector<qint64> direct;
+    direct.reserve(requestCount);
+    int failures = 0;
+    QElapsedTimer timer;
+    for (const QUrl &url : sequence) {
+        timer.start();
+        QNetworkReply *reply = network.get(QNetworkRequest(url));
+        QEventLoop loop;
+        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+        direct.append(timer.nsecsElapsed());
+        failures += reply->error() == QNetworkReply::NoError ? 0 : 1;
+        reply->deleteLater();
+    }
+    const qint64 directServerRequests = server.requestCount();
+
+    // 2. Avec le cache : le rappel peut être immédiat, la boucle n'est lancée que si besoin
+    HttpCache cache(dir.filePath("cache"), qint64(64) * 1024 * 1024);
+    cache.setCachedOrigins({server.url("/").toString()});
+    QVector<qint64> cached;
+    cached.reserve(requestCount);
+    for (const QUrl &url : sequence) {
+        bool done = false;
+        QEventLoop loop;
+        timer.start();
+        cache.fetch(url, [&done, &loop, &failures](const HttpCache::Response &response) {
+            if (response.stream) {
+                response.stream->deleteLater();
+            }
+            failures += response.ok ? 0 : 1;
+            done = true;
+            loop.quit();
+        });
+        if (!done) {
+            loop.exec();
+        }
+        cached.append(timer.nsecsElapsed());
+    }
+    const qint64 cachedServerRequests = server.requestCount() - directServerRequests;
+
+    out << "requêtes                 : " << requestCount << " sur " << pageCount << " pages (Zipf, 20 ms de latence)\n";
+    out << "sans cache  p50 / p99    : " << QString::number(percentileMs(direct, 0.50), 'f', 2) << " / "
+        << QString::number(percentileMs(direct, 0.99), 'f', 2) << " ms\n";
+    out << "avec cache  p50 / p99    : " << QString::number(percentileMs(cached, 0.50), 'f', 2) << " / "
+        << QString::number(percentileMs(cached, 0.99), 'f', 2) << " ms\n";
+    out << "succès du cache          : " << cache.hits() << " ("
+        << QString::number(100.0 * cache.hits() / qMax(1, requestCount), 'f', 1) << " %)\n";
+    out << "revalidations (304)      : " << cache.revalidations() << "\n";
+    out << "téléchargements complets : " << cache.misses() << "\n";
+    out << "requêtes reçues serveur  : " << directServerRequests << " sans cache, " << cachedServerRequests << " avec\n";
+    out << "taille du cache          : " << QString::number(mebibytes(cache.sizeBytes()), 'f', 1) << " Mio\n";
+    out << "échecs                   : " << failures << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
+int filterMatching(int ruleCount, int urlCount)
+{
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!dir.isValid() || ruleCount <= 0 || urlCount <= 0) {
+        out << "Paramètres invalides ou dossier temporaire impossible à créer\n";
+        return 1;
+    }
+
+    // Liste synthétique aux proportions d'EasyList : surtout des domaines, puis des chemins,
+    // quelques règles à options, à jokers, et des exceptions
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<std::string> blockedHosts;
+    std::string list = "[Adblock Plus 2.0]\n! Liste synthétique\n";
+    for (int i = 0; i < ruleCount; ++i) {
+        const int kind = percent(rng);
+        const std::string host = pick(rng, kAdWords) + std::to_string(rng() % 100000) + (percent(rng) < 70 ? ".com" : ".net");
+        if (kind < 75) {
+            list += "||" + host + "^\n";
+            blockedHosts.push_back(host);
+        } else if (kind < 90) {
+            list += "/" + pick(rng, kAdWords) + "-" + std::to_string(rng() % 100000) + "/\n";
+        } else if (kind < 95) {
+            list += "||" + host + "/" + pick(rng, kAdWords) + "^$third-party,script\n";
+        } else if (kind < 98) {
+            list += "/" + pick(rng, kAdWords) + std::to_string(rng() % 1000) + "/*/" + pick(rng, kAdWords) + ".gif\n";
+        } else {
+            list += "@@||" + host + "/" + pick(rng, kWebWords) + "/\n";
+        }
+    }
+    if (blockedHosts.empty()) {
+        blockedHosts.push_back("ads.example.com");
+    }
+
+    // URL ordinaires, dont 5 % vers un domaine de la liste
+    std::vector<std::string> urls;
+    urls.reserve(urlCount);
+    for (int i = 0; i < urlCount; ++i) {
+        const std::string host = percent(rng) < 5 ? "cdn." + blockedHosts[rng() % blockedHosts.size()]
+                                                  : "www." + pick(rng, kWebWords) + std::to_string(rng() % 10000) + ".org";
+        urls.push_back("https://" + host + "/" + pick(rng, kWebWords) + "/" + pick(rng, kWebWords) + "-"
+                       + std::to_string(rng() % 100000) + ".js?v=" + std::to_string(rng() % 1000));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    FilterEngine compiled;
+    compiled.addList(list);
+    compiled.compile();
+    const qint64 compileMs = timer.elapsed();
+
+    const std::string cachePath = QFile::encodeName(dir.filePath("filters.bin")).toStdString();
+    if (!compiled.save(cachePath, 1)) {
+        out << "Impossible d'écrire la forme compilée\n";
+        return 1;
+    }
+    timer.restart();
+    FilterEngine engine;
+    const bool loaded = engine.load(cachePath, 1);
+    const qint64 loadUs = timer.nsecsElapsed() / 1000;
+
+    // Meilleur de trois passages : la première passe sert aussi à chauffer les caches
+    qint64 bestNs = std::numeric_limits<qint64>::max();
+    size_t blocked = 0;
+    for (int pass = 0; pass < 3; ++pass) {
+        blocked = 0;
+        timer.restart();
+        for (const std::string &url : urls) {
+            blocked += engine.shouldBlock(url, "www.news.org", FilterEngine::Script) ? 1 : 0;
+        }
+        bestNs = qMin(bestNs, timer.nsecsElapsed());
+    }
+
+    out << "règles retenues / ignorées : " << compiled.ruleCount() << " / " << compiled.ignoredCount() << "\n";
+    out << "analyse et compilation     : " << compileMs << " ms\n";
+    out << "forme compilée             : " << QString::number(mebibytes(QFileInfo(dir.filePath("filters.bin")).size()), 'f', 1)
+        << " Mio, relue en " << loadUs << " µs" << (loaded ? "" : " (ÉCHEC)") << "\n";
+    out << "URL testées / bloquées     : " << urlCount << " / " << blocked << "\n";
+    out << "décision par requête       : " << QString::number(double(bestNs) / urlCount, 'f', 1) << " ns\n";
+    return loaded ? 0 : 1;
+}
+
+int fullTextSearch(int pageCount)
+{
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!dir.isValid() || pageCount <= 0) {
+        out << "Paramètres invalides ou dossier temporaire impossible à créer\n";
+        return 1;
+    }
+
+    // Vocabulaire de 50 000 mots, fréquences selon une loi de Zipf (comme une langue naturelle)
+    const int vocabularySize = 50000;
+    const int wordsPerPage = 800;
+    std::mt19937 rng(42);
+    QStringList vocabulary;
+    for (int i = 0; i < vocabularySize; ++i) {
+        std::string word; // i écrit en base 26, une syllabe par chiffre : mots tous différents
+        for (int v = i;; v /= 26) {
+            word += kSyllables[v % 26];
+            if (v < 26) {
+                break;
+            }
+        }
+        vocabulary.append(QString::fromStdString(word));
+    }
+    std::vector<double> cumulative(vocabularySize);
+    double total = 0;
+    for (int i = 0; i < vocabularySize; ++i) {
+        total += 1.0 / (i + 1);
+        cumulative[size_t(i)] = total;
+    }
+    std::uniform_real_distribution<double> draw(0, total);
+    auto randomWord = [&]() -> const QString & {
+        return vocabulary[int(std::lower_bound(cumulative.begin(), cumulative.end(), draw(rng)) - cumulative.begin())];
+    };
+
+    FullTextIndex index(QFile::encodeName(dir.path()).toStdString());
+    index.open();
+    qint64 textBytes = 0;
+    qint64 tokenizeNs = 0;
+    qint64 worstStepNs = 0;
+    QElapsedTimer timer;
+    QElapsedTimer step;
+    timer.start();
+    for (int page = 0; page < pageCount; ++page) {
+        QString text;
+        for (int w = 0; w < wordsPerPage; ++w) {
+            text += randomWord();
+            text += (w % 15 == 14) ? QStringLiteral(". ") : QStringLiteral(" ");
+        }
+        textBytes += text.toUtf8().size();
+
+        step.start();
+        const std::vector<std::string> tokens = PageIndexer::tokenize(text);
+        tokenizeNs += step.nsecsElapsed();
+        index.addDocument("https://intranet.ictu.local/page/" + std::to_string(page), "Page " + std::to_string(page),
+                          std::string(), uint64_t(page) + 1, tokens);
+        // Même politique que PageIndexer::runSlice : un segment toutes les 64 pages, puis une fusion
+        if (index.bufferedDocuments() >= 64) {
+            step.start();
+            index.flush();
+            index.mergeStep();
+            worstStepNs = qMax(worstStepNs, step.nsecsElapsed());
+        }
+    }
+    index.flush();
+    while (index.mergeStep()) {
+    }
+    const qint64 indexNs = timer.nsecsElapsed();
+
+    QVector<qint64> queryNanos;
+    for (int q = 0; q < 1000; ++q) {
+        const QString query = randomWord() + ' ' + randomWord();
+        timer.restart();
+        index.search(PageIndexer::tokenize(query), 10);
+        queryNanos.append(timer.nsecsElapsed());
+    }
+
+    const double seconds = indexNs / 1e9;
+    out << "pages indexées            : " << pageCount << " (" << wordsPerPage << " mots chacune)\n";
+    out << "débit                     : " << QString::number(pageCount / seconds, 'f', 0) << " pages/s, "
+        << QString::number(mebibytes(textBytes) / seconds, 'f', 1) << " Mio/s de texte\n";
+    out << "part du découpage en mots : " << QString::number(100.0 * tokenizeNs / indexNs, 'f', 0) << " %\n";
+    out << "pire écriture + fusion    : " << QString::number(worstStepNs / 1e6, 'f', 1) << " ms\n";
+    out << "texte / index sur disque  : " << QString::number(mebibytes(textBytes), 'f', 1) << " / "
+        << QString::number(mebibytes(qint64(index.diskBytes())), 'f', 1) << " Mio (" << index.segmentCount() << " segments)\n";
+    out << "recherche (2 mots) p50    : " << QString::number(percentileMs(queryNanos, 0.5), 'f', 2) << " ms\n";
+    out << "recherche (2 mots) p99    : " << QString::number(percentileMs(queryNanos, 0.99), 'f', 2) << " ms\n";
+    return 0;
+}
+
+int downloads(int sizeMiB)
+{
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    StandInServer server;
+    if (!dir.isValid() || !server.start() || sizeMiB <= 0) {
+        out << "Paramètres invalides, ou dossier temporaire ou serveur local impossible à préparer\n";
+        return 1;
+    }
+    const qint64 bandwidth = 4 * 1024 * 1024;
+    server.setLatency(20);
+    server.setBandwidth(bandwidth);
+
+    QByteArray body(qint64(sizeMiB) * 1024 * 1024, Qt::Uninitialized);
+    std::mt19937 rng(42);
+    for (char &c : body) {
+        c = static_cast<char>(rng());
+    }
+    server.setResource("/fichier.bin", body, "application/octet-stream");
+    const QByteArray expected = QCryptographicHash::hash(body, QCryptographicHash::Sha256);
+    const QUrl url = server.url("/fichier.bin");
+
+    int errors = 0;
+    auto report = [&](const QString &label, const QString &path, DownloadManager::State state, qint64 nanos) {
+        const bool ok = state == DownloadManager::Finished && fileSha256(path) == expected;
+        errors += ok ? 0 : 1;
+        out << label << QString::number(nanos / 1e9, 'f', 2) << " s, "
+            << QString::number(mebibytes(body.size()) / (nanos / 1e9), 'f', 1) << " Mio/s"
+            << (ok ? "" : " (CONTENU INCORRECT)") << "\n";
+    };
+
+    QElapsedTimer timer;
+    for (int segments : {1, 4}) {
+        DownloadManager manager;
+        manager.setMaxSegments(segments);
+        const QString path = dir.filePath(QString("fichier-%1.bin").arg(segments));
+        timer.start();
+        const int id = manager.enqueue(url, path);
+        const DownloadManager::State state = waitForDownload(manager, id);
+        report(QString("%1 plage(s) en parallèle      : ").arg(segments), path, state, timer.nsecsElapsed());
+    }
+
+    // Interruption à 40 % (le gestionnaire est détruit, comme à la fermeture du navigateur),
+    // puis reprise par un nouveau gestionnaire à partir du fichier partiel
+    const QString path = dir.filePath("fichier-reprise.bin");
+    qint64 before = 0;
+    {
+        DownloadManager manager;
+        const int id = manager.enqueue(url, path);
+        waitForDownload(manager, id, body.size() * 4 / 10);
+        before = manager.info(id).receivedBytes;
+    }
+    DownloadManager manager;
+    manager.restoreInterrupted(dir.path());
+    const QList<int> restored = manager.downloads();
+    if (restored.size() != 1) {
+        out << "reprise                      : fichier partiel introuvable\n";
+        return 1;
+    }
+    manager.resume(restored.first());
+    const qint64 resumedFrom = manager.info(restored.first()).receivedBytes;
+    timer.start();
+    const DownloadManager::State state = waitForDownload(manager, restored.first());
+    out << "reprise : reçu avant l'arrêt  " << QString::number(mebibytes(before), 'f', 1) << " Mio, repris à "
+        << QString::number(mebibytes(resumedFrom), 'f', 1) << " Mio\n";
+    report("reprise (reste du fichier)   : ", path, state, timer.nsecsElapsed());
+    return errors == 0 ? 0 : 1;
+}
+
+
+int bookmarks(int bookmarkCount)
+{
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!dir.isValid() || bookmarkCount <= 0) {
+        out << "Paramètres invalides ou dossier temporaire impossible à créer\n";
+        return 1;
+    }
+
+    // Fichier HTML Netscape : 20 dossiers de premier niveau, des sous-dossiers de 50 liens,
+    // une centaine d'hôtes (les liens d'un même hôte partagent le début de leur URL)
+    const QString htmlPath = dir.filePath("favoris.html");
+    {
+        QFile file(htmlPath);
+        if (!file.open(QFile::WriteOnly | QFile::Text)) {
+            out << "Impossible d'écrire " << htmlPath << "\n";
+            return 1;
+        }
+        QTextStream html(&file);
+        html << "<!DOCTYPE NETSCAPE-Bookmark-file-1>\n<TITLE>Bookmarks</TITLE>\n<H1>Bookmarks</H1>\n<DL><p>\n";
+        for (int i = 0; i < bookmarkCount; ++i) {
+            if (i % 1000 == 0) {
+                html << (i ? "</DL><p>\n</DL><p>\n" : "") << "<DT><H3 ADD_DATE=\"1700000000\">Dossier " << i / 1000
+                     << "</H3>\n<DL><p>\n<DT><H3>Sous-dossier 0</H3>\n<DL><p>\n";
+            } else if (i % 50 == 0) {
+                html << "</DL><p>\n<DT><H3>Sous-dossier " << (i % 1000) / 50 << "</H3>\n<DL><p>\n";
+            }
+            html << "<DT><A HREF=\"https://site" << i % 97 << ".ictu.local/documents/page-" << i
+                 << ".html\" ADD_DATE=\"" << 1700000000 + i << "\">Page " << i << " &amp; annexes</A>\n";
+        }
+        html << "</DL><p>\n</DL><p>\n</DL><p>\n";
+    }
+
+    const qint64 memoryBefore = ProcessMemory::residentBytes();
+    QElapsedTimer timer;
+    BookmarkStore store(dir.filePath("bookmarks.bin"));
+    QFile html(htmlPath);
+    html.open(QFile::ReadOnly);
+    timer.start();
+    const int imported = store.importNetscape(&html, BookmarkStore::kRootId);
+    const qint64 importNs = timer.nsecsElapsed();
+    const qint64 memoryAfter = ProcessMemory::residentBytes();
+    store.saveNow();
+
+    timer.restart();
+    BookmarkStore reloaded(dir.filePath("bookmarks.bin"));
+    const bool loaded = reloaded.load();
+    const qint64 loadNs = timer.nsecsElapsed();
+
+    // Comme en navigation réelle, la plupart des pages consultées ne sont pas des favoris
+    const int lookups = 100000;
+    QStringList urls;
+    for (int i = 0; i < 1000; ++i) {
+        const int page = int(qint64(i) * 7919 % (4 * bookmarkCount)); // Un quart seulement sont des favoris
+        urls.append(QString("https://site%1.ictu.local/documents/page-%2.html").arg(page % 97).arg(page));
+    }
+    int hits = 0;
+    timer.restart();
+    for (int i = 0; i < lookups; ++i) {
+        hits += reloaded.isBookmarked(urls[i % urls.size()]) ? 1 : 0;
+    }
+    const qint64 lookupNs = timer.nsecsElapsed();
+
+    timer.restart();
+    QFile exported(dir.filePath("export.html"));
+    exported.open(QFile::WriteOnly | QFile::Truncate);
+    reloaded.exportNetscape(&exported);
+    exported.close();
+    const qint64 exportNs = timer.nsecsElapsed();
+
+    out << "favoris importés          : " << imported << " en " << QString::number(importNs / 1e6, 'f', 1) << " ms ("
+        << QString::number(imported / (importNs / 1e9), 'f', 0) << " liens/s)\n";
+    out << "mémoire de l'arbre        : " << QString::number(mebibytes(memoryAfter - memoryBefore), 'f', 1) << " Mio\n";
+    out << "HTML / bookmarks.bin      : " << QString::number(mebibytes(QFileInfo(htmlPath).size()), 'f', 2) << " / "
+        << QString::number(mebibytes(QFileInfo(dir.filePath("bookmarks.bin")).size()), 'f', 2) << " Mio\n";
+    out << "relecture de bookmarks.bin: " << (loaded ? QString::number(loadNs / 1e6, 'f', 1) + " ms" : QString("échec"))
+        << " (" << reloaded.count() << " liens)\n";
+    out << "test « favori ? »         : " << QString::number(double(lookupNs) / lookups, 'f', 0) << " ns ("
+        << hits * 100 / lookups << " % de favoris)\n";
+    out << "export HTML               : " << QString::number(exportNs / 1e6, 'f', 1) << " ms, "
+        << QString::number(mebibytes(QFileInfo(dir.filePath("export.html")).size()), 'f', 2) << " Mio\n";
+    return loaded && imported == bookmarkCount && reloaded.count() == bookmarkCount ? 0 : 1;
+}
+
+} // namespace Benchmarks
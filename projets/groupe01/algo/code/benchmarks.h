@@ -0,0 +1,45 @@
+// benchmarks.h
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+class MainWindow;
+
+// Mesures de performance lancées depuis la ligne de commande (voir main.cpp).
+// Chaque fonction affiche ses résultats sur la sortie standard et renvoie le code de sortie.
+namespace Benchmarks {
+
+// Remplit l'index d'autocomplétion avec entryCount URL visitées sur un an (titres compris),
+// puis mesure la saisie caractère par caractère : latence des recherches, objectif 2 ms au p99
+int omnibox(int entryCount);
+
+// Ouvre tabCount onglets sur des pages locales file:///, mesure la mémoire résidente,
+// décharge les onglets en arrière-plan puis mesure à nouveau
+int tabMemory(MainWindow &window, int tabCount);
+
+// Crée une session de tabCount onglets (10 pages d'historique chacun), puis mesure la
+// (dé)sérialisation et le temps de démarrage jusqu'à l'affichage de l'onglet actif
+int sessionStartup(int tabCount);
+
+// Rejoue requestCount requêtes (distribution de Zipf sur 200 pages) vers un serveur local
+// simulant 20 ms de latence, sans puis avec le cache HTTP : taux de succès et latences
+int httpCache(int requestCount);
+
+// Compile ruleCount règles de filtrage synthétiques (proportions d'EasyList), mesure la
+// relecture de leur forme binaire, puis le temps de décision sur urlCount URL
+int filterMatching(int ruleCount, int urlCount);
+
+// Indexe pageCount pages synthétiques (vocabulaire de Zipf) comme le fait le PageIndexer :
+// débit, pire durée d'une écriture ou d'une fusion de segments, taille sur disque, latence des recherches
+int fullTextSearch(int pageCount);
+
+// Télécharge un fichier de sizeMiB Mio depuis un serveur local limité à 4 Mio/s par connexion :
+// une plage puis quatre en parallèle, puis une interruption suivie d'une reprise ; vérifie le contenu
+int downloads(int sizeMiB);
+
+// Importe un fichier HTML Netscape de bookmarkCount favoris (dossiers imbriqués), puis mesure
+// la relecture du format binaire, le test "cette URL est-elle un favori ?" et l'export
+int bookmarks(int bookmarkCount);
+
+} // namespace Benchmarks
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,197 @@
+// bookmarksdialog.cpp
+#include "bookmarksdialog.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QStyle>
+#include <QTreeWidget>
+#include <QTreeWidgetItemIterator>
+#include <QVBoxLayout>
+
+#include "bookmarkstore.h"
+
+BookmarksDialog::BookmarksDialog(BookmarkStore *store, QWidget *parent)
+    : QDialog(parent)
+    , store(store)
+    , tree(new QTreeWidget(this))
+{
+    setWindowTitle("Favoris");
+    resize(700, 500);
+
+    tree->setColumnCount(2);
+    tree->setHeaderLabels({"Titre", "Adresse"});
+    tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    connect(tree, &QTreeWidget::itemDoubleClicked, this, [this](QTreeWidgetItem *item) {
+        const BookmarkStore::Node &node = this->store->node(item->data(0, Qt::UserRole).toInt());
+        if (!node.folder) {
+            emit openRequested(QUrl(node.url));
+        }
+    });
+
+    auto *folderButton = new QPushButton("Nouveau dossier", this);
+    auto *renameButton = new QPushButton("Renommer", this);
+    auto *moveButton = new QPushButton("Déplacer…", this);
+    auto *removeButton = new QPushButton("Supprimer", this);
+    auto *importButton = new QPushButton("Importer…", this);
+    auto *exportButton = new QPushButton("Exporter…", this);
+    connect(folderButton, &QPushButton::clicked, this, &BookmarksDialog::newFolder);
+    connect(renameButton, &QPushButton::clicked, this, &BookmarksDialog::renameSelected);
+    connect(moveButton, &QPushButton::clicked, this, &BookmarksDialog::moveSelected);
+    connect(removeButton, &QPushButton::clicked, this, &BookmarksDialog::removeSelected);
+    connect(importButton, &QPushButton::clicked, this, &BookmarksDialog::importFile);
+    connect(exportButton, &QPushButton::clicked, this, &BookmarksDialog::exportFile);
+
+    auto *buttons = new QHBoxLayout;
+    buttons->addWidget(folderButton);
+    buttons->addWidget(renameButton);
+    buttons->addWidget(moveButton);
+    buttons->addWidget(removeButton);
+    buttons->addStretch();
+    buttons->addWidget(importButton);
+    buttons->addWidget(exportButton);
+    auto *layout = new QVBoxLayout(this);
+    layout->addWidget(tree);
+    layout->addLayout(buttons);
+
+    rebuild();
+    connect(store, &BookmarkStore::changed, this, &BookmarksDialog::rebuild);
+}
+
+// Reconstruit l'arbre en gardant la sélection ; l'identifiant du nœud est gardé dans la première colonne
+void BookmarksDialog::rebuild()
+{
+    const int selected = selectedId();
+    tree->clear();
+    addItems(tree->invisibleRootItem(), BookmarkStore::kRootId);
+    for (QTreeWidgetItemIterator it(tree); selected != BookmarkStore::kRootId && *it; ++it) {
+        if ((*it)->data(0, Qt::UserRole).toInt() == selected) {
+            tree->setCurrentItem(*it);
+            break;
+        }
+    }
+}
+
+void BookmarksDialog::addItems(QTreeWidgetItem *parentItem, int folder)
+{
+    for (int id : store->node(folder).children) {
+        const BookmarkStore::Node &node = store->node(id);
+        auto *item = new QTreeWidgetItem(parentItem, {node.title, node.url});
+        item->setData(0, Qt::UserRole, id);
+        if (node.folder) {
+            item->setIcon(0, style()->standardIcon(QStyle::SP_DirIcon));
+            addItems(item, id);
+        }
+    }
+}
+
+int BookmarksDialog::selectedId() const
+{
+    const QTreeWidgetItem *item = tree->currentItem();
+    return item ? item->data(0, Qt::UserRole).toInt() : BookmarkStore::kRootId;
+}
+
+int BookmarksDialog::selectedFolder() const
+{
+    const int id = selectedId();
+    return store->node(id).folder ? id : store->node(id).parent;
+}
+
+void BookmarksDialog::newFolder()
+{
+    const QString title = QInputDialog::getText(this, "Nouveau dossier", "Nom du dossier :");
+    if (!title.trimmed().isEmpty()) {
+        store->addFolder(selectedFolder(), title.trimmed());
+    }
+}
+
+void BookmarksDialog::renameSelected()
+{
+    const int id = selectedId();
+    if (id == BookmarkStore::kRootId) {
+        return;
+    }
+    bool ok = false;
+    const QString title = QInputDialog::getText(this, "Renommer", "Titre :", QLineEdit::Normal,
+                                                store->node(id).title, &ok);
+    if (ok && !title.trimmed().isEmpty()) {
+        store->rename(id, title.trimmed());
+    }
+}
+
+// Les dossiers sont proposés par leur chemin complet ("Favoris / Travail / Projets")
+void BookmarksDialog::moveSelected()
+{
+    const int id = selectedId();
+    if (id == BookmarkStore::kRootId) {
+        return;
+    }
+    QStringList paths;
+    QVector<int> folders;
+    QVector<QPair<int, QString>> pending{{BookmarkStore::kRootId, store->node(BookmarkStore::kRootId).title}};
+    while (!pending.isEmpty()) {
+        const QPair<int, QString> folder = pending.takeFirst();
+        if (folder.first == id) {
+            continue; // Ni le dossier lui-même ni son contenu
+        }
+        folders.append(folder.first);
+        paths.append(folder.second);
+        for (int child : store->node(folder.first).children) {
+            if (store->node(child).folder) {
+                pending.append({child, folder.second + " / " + store->node(child).title});
+            }
+        }
+    }
+    bool ok = false;
+    const QString path = QInputDialog::getItem(this, "Déplacer", "Dossier de destination :", paths, 0, false, &ok);
+    if (ok) {
+        store->move(id, folders[paths.indexOf(path)]);
+    }
+}
+
+void BookmarksDialog::removeSelected()
+{
+    const int id = selectedId();
+    if (id == BookmarkStore::kRootId) {
+        return;
+    }
+    if (store->node(id).folder && !store->node(id).children.isEmpty()
+        && QMessageBox::question(this, "Supprimer", "Supprimer le dossier « " + store->node(id).title
+                                                        + " » et tout son contenu ?") != QMessageBox::Yes) {
+        return;
+    }
+    store->remove(id);
+}
+
+void BookmarksDialog::importFile()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "Importer des favoris", QString(),
+                                                      "Favoris HTML (*.html *.htm)");
+    if (path.isEmpty()) {
+        return;
+    }
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        QMessageBox::warning(this, "Erreur de fichier", "Impossible de lire le fichier : " + file.errorString());
+        return;
+    }
+    const int count = store->importNetscape(&file, selectedFolder());
+    QMessageBox::information(this, "Importer des favoris", QString("%1 favoris importés.").arg(count));
+}
+
+void BookmarksDialog::exportFile()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "Exporter les favoris", "favoris.html",
+                                                      "Favoris HTML (*.html)");
+    if (path.isEmpty()) {
+        return;
+    }
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || !store->exportNetscape(&file)) {
+        QMessageBox::warning(this, "Erreur de fichier", "Impossible d'écrire le fichier : " + file.errorString());
+    }
+}
@@ -0,0 +1,40 @@
+// bookmarksdialog.h
+#ifndef BOOKMARKSDIALOG_H
+#define BOOKMARKSDIALOG_H
+
+#include <QDialog>
+#include <QUrl>
+
+class BookmarkStore;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+// Gestion des favoris : arbre des dossiers, renommage, déplacement, suppression,
+// import et export au format HTML Netscape. Un double-clic ouvre le lien.
+class BookmarksDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit BookmarksDialog(BookmarkStore *store, QWidget *parent = nullptr);
+
+signals:
+    void openRequested(const QUrl &url);
+
+private:
+    BookmarkStore *store;
+    QTreeWidget *tree;
+
+    void rebuild();
+    void addItems(QTreeWidgetItem *parentItem, int folder);
+    int selectedId() const;
+    int selectedFolder() const; // Dossier choisi, ou dossier du lien choisi
+    void newFolder();
+    void renameSelected();
+    void moveSelected();
+    void removeSelected();
+    void importFile();
+    void exportFile();
+};
+
+#endif // BOOKMARKSDIALOG_H
@@ -0,0 +1,573 @@
+// bookmarkstore.cpp
+#include "bookmarkstore.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace {
+const quint32 kMagic = 0x49435442; // "ICTB"
+const quint16 kVersion = 1;
+const int kHeaderSize = 6;         // kMagic + kVersion
+const int kSaveDelayMs = 1000;     // Regroupe les modifications rapprochées en une seule écriture
+const int kImportChunk = 64 * 1024; // Caractères lus à la fois lors d'un import
+const int kMaxTagLength = 1 << 20;  // Au-delà, la balise est considérée comme corrompue et ignorée
+
+void putVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char(value | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+bool getVarint(const char *&p, const char *end, quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        const quint8 byte = quint8(*p++);
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void putBytes(QByteArray &out, const QByteArray &bytes)
+{
+    putVarint(out, quint64(bytes.size()));
+    out.append(bytes);
+}
+
+bool getBytes(const char *&p, const char *end, QByteArray &bytes)
+{
+    quint64 size = 0;
+    if (!getVarint(p, end, size) || size > quint64(end - p)) {
+        return false;
+    }
+    bytes = QByteArray(p, qsizetype(size));
+    p += size;
+    return true;
+}
+
+// Écarts de dates signés : zigzag pour que les petites valeurs négatives restent courtes
+quint64 zigzag(qint64 v) { return (quint64(v) << 1) ^ quint64(v >> 63); }
+qint64 unzigzag(quint64 v) { return qint64(v >> 1) ^ -qint64(v & 1); }
+
+// Valeur de l'attribut name="..." d'une balise (nom insensible à la casse), vide si absent
+QString attribute(QStringView tag, QLatin1String name)
+{
+    for (qsizetype at = tag.indexOf(name, 0, Qt::CaseInsensitive); at >= 0;
+         at = tag.indexOf(name, at + 1, Qt::CaseInsensitive)) {
+        const qsizetype value = at + name.size();
+        if (at > 0 && tag[at - 1].isSpace() && value + 1 < tag.size() && tag[value] == '='
+            && tag[value + 1] == '"') {
+            const qsizetype close = tag.indexOf('"', value + 2);
+            return tag.mid(value + 2, close < 0 ? -1 : close - value - 2).toString();
+        }
+    }
+    return QString();
+}
+
+QString decodeEntities(const QString &text)
+{
+    if (!text.contains('&')) {
+        return text;
+    }
+    QString result;
+    result.reserve(text.size());
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const qsizetype semicolon = text[i] == '&' ? text.indexOf(';', i) : -1;
+        if (semicolon < 0 || semicolon - i > 10) {
+            result += text[i];
+            continue;
+        }
+        const QStringView entity = QStringView(text).mid(i + 1, semicolon - i - 1);
+        if (entity == u"amp") {
+            result += '&';
+        } else if (entity == u"lt") {
+            result += '<';
+        } else if (entity == u"gt") {
+            result += '>';
+        } else if (entity == u"quot") {
+            result += '"';
+        } else if (entity == u"apos") {
+            result += '\'';
+        } else if (entity.startsWith('#')) {
+            bool ok = false;
+            const uint code = entity.startsWith(u"#x", Qt::CaseInsensitive) ? entity.mid(2).toUInt(&ok, 16)
+                                                                              : entity.mid(1).toUInt(&ok);
+            if (!ok || code == 0 || code > 0x10FFFF) {
+                result += text[i];
+                continue;
+            }
+            const char32_t character = code;
+            result += QString::fromUcs4(&character, 1);
+        } else {
+            result += text[i];
+            continue;
+        }
+        i = semicolon;
+    }
+    return result;
+}
+
+} // namespace
+
+BookmarkStore::BookmarkStore(const QString &filePath, QObject *parent)
+    : QObject(parent)
+    , filePath(filePath)
+{
+    Node root;
+    root.folder = true;
+    root.title = "Favoris";
+    nodes.append(root);
+
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(kSaveDelayMs);
+    connect(&saveTimer, &QTimer::timeout, this, &BookmarkStore::saveNow);
+}
+
+BookmarkStore::~BookmarkStore()
+{
+    if (saveTimer.isActive()) {
+        saveNow();
+    }
+}
+
+bool BookmarkStore::load()
+{
+    QFile file(filePath);
+    if (filePath.isEmpty() || !file.open(QFile::ReadOnly)) {
+        return false; // Pas encore de favoris : premier lancement
+    }
+    QVector<Node> loaded;
+    if (!deserialize(file.readAll(), loaded)) {
+        return false; // Fichier corrompu : on garde un arbre vide
+    }
+    nodes = loaded;
+    rebuildIndex();
+    emit changed();
+    return true;
+}
+
+bool BookmarkStore::saveNow()
+{
+    saveTimer.stop();
+    if (filePath.isEmpty()) {
+        return false;
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+    file.write(serialize(nodes));
+    return file.commit();
+}
+
+void BookmarkStore::scheduleSave()
+{
+    if (!filePath.isEmpty()) {
+        saveTimer.start();
+    }
+    emit changed();
+}
+
+void BookmarkStore::rebuildIndex()
+{
+    urlCounts.clear();
+    bookmarkCount = 0;
+    for (const Node &node : nodes) {
+        if (!node.folder && !node.removed) {
+            ++urlCounts[urlKey(node.url)];
+            ++bookmarkCount;
+        }
+    }
+}
+
+QString BookmarkStore::urlKey(const QString &url)
+{
+    qsizetype end = url.indexOf('#');
+    if (end < 0) {
+        end = url.size();
+    }
+    while (end > 0 && url[end - 1] == '/') {
+        --end;
+    }
+    return url.left(end);
+}
+
+int BookmarkStore::append(int parent, Node node)
+{
+    const int id = nodes.size();
+    node.parent = parent;
+    if (node.addedSecs <= 0) {
+        node.addedSecs = QDateTime::currentSecsSinceEpoch();
+    }
+    nodes.append(node);
+    nodes[parent].children.append(id);
+    if (!node.folder) {
+        countUrl(nodes[id], 1);
+    }
+    return id;
+}
+
+// Tient à jour la table des URL ; seules l'entrée d'une URL dans les favoris et sa sortie sont signalées
+void BookmarkStore::countUrl(const Node &node, int delta)
+{
+    const QString key = urlKey(node.url);
+    const int count = urlCounts.value(key) + delta;
+    bookmarkCount += delta;
+    if (count <= 0) {
+        urlCounts.remove(key);
+        emit bookmarkedChanged(node.url, node.title, false, node.addedSecs);
+        return;
+    }
+    urlCounts.insert(key, count);
+    if (count == 1) {
+        emit bookmarkedChanged(node.url, node.title, true, node.addedSecs);
+    }
+}
+
+int BookmarkStore::addFolder(int parent, const QString &title)
+{
+    if (!isValid(parent) || !nodes[parent].folder) {
+        parent = kRootId;
+    }
+    Node node;
+    node.folder = true;
+    node.title = title;
+    const int id = append(parent, node);
+    scheduleSave();
+    return id;
+}
+
+int BookmarkStore::addBookmark(int parent, const QString &url, const QString &title, qint64 addedSecs)
+{
+    if (!isValid(parent) || !nodes[parent].folder) {
+        parent = kRootId;
+    }
+    Node node;
+    node.url = url;
+    node.title = title.isEmpty() ? url : title;
+    node.addedSecs = addedSecs;
+    const int id = append(parent, node);
+    scheduleSave();
+    return id;
+}
+
+void BookmarkStore::rename(int id, const QString &title)
+{
+    if (!isValid(id) || id == kRootId || nodes[id].title == title) {
+        return;
+    }
+    nodes[id].title = title;
+    scheduleSave();
+}
+
+bool BookmarkStore::move(int id, int parent)
+{
+    if (!isValid(id) || id == kRootId || !isValid(parent) || !nodes[parent].folder) {
+        return false;
+    }
+    for (int ancestor = parent; ancestor >= 0; ancestor = nodes[ancestor].parent) {
+        if (ancestor == id) {
+            return false; // Un dossier ne peut pas entrer dans son propre sous-arbre
+        }
+    }
+    nodes[nodes[id].parent].children.removeOne(id);
+    nodes[id].parent = parent;
+    nodes[parent].children.append(id);
+    scheduleSave();
+    return true;
+}
+
+void BookmarkStore::remove(int id)
+{
+    if (!isValid(id) || id == kRootId) {
+        return;
+    }
+    nodes[nodes[id].parent].children.removeOne(id);
+
+    QVector<int> pending{id};
+    while (!pending.isEmpty()) {
+        Node &node = nodes[pending.takeLast()];
+        pending += node.children;
+        if (!node.folder) {
+            countUrl(node, -1);
+        }
+        // Le nœud garde sa place (les identifiants restent stables) mais libère son contenu
+        node.removed = true;
+        node.title.clear();
+        node.url.clear();
+        node.children.clear();
+    }
+    scheduleSave();
+}
+
+// Parcours linéaire : seulement sur une action de l'utilisateur (retirer le favori de la page)
+int BookmarkStore::findBookmark(const QString &url) const
+{
+    if (!isBookmarked(url)) {
+        return -1;
+    }
+    const QString key = urlKey(url);
+    for (int id = 0; id < nodes.size(); ++id) {
+        if (!nodes[id].folder && !nodes[id].removed && urlKey(nodes[id].url) == key) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+void BookmarkStore::bookmarks(QStringList &urls, QStringList &titles, QVector<qint64> &addedSecs) const
+{
+    urls.clear();
+    titles.clear();
+    addedSecs.clear();
+    for (const Node &node : nodes) {
+        if (!node.folder && !node.removed) {
+            urls.append(node.url);
+            titles.append(node.title);
+            addedSecs.append(node.addedSecs);
+        }
+    }
+}
+
+// Lecture en flux : un tampon de kImportChunk caractères est découpé en balises et en texte.
+// Seuls comptent <DL> / </DL> (entrée et sortie d'un dossier), <H3>titre</H3> (un dossier)
+// et <A HREF="...">titre</A> (un lien) ; tout le reste est ignoré.
+int BookmarkStore::importNetscape(QIODevice *device, int parent)
+{
+    if (!isValid(parent) || !nodes[parent].folder) {
+        parent = kRootId;
+    }
+    QTextStream in(device);
+    in.setEncoding(QStringConverter::Utf8);
+
+    QVector<int> folders{parent}; // Dossiers ouverts par <DL>
+    int pendingFolder = -1;       // Dossier dont le <H3> vient d'être lu, ouvert par le <DL> suivant
+    Node current;                 // Dossier ou lien en cours de lecture
+    bool inTitle = false;         // Entre <H3> et </H3>, ou entre <A> et </A>
+    int imported = 0;
+
+    QString buffer;
+    qsizetype pos = 0;
+    while (true) {
+        const qsizetype lt = buffer.indexOf('<', pos);
+        const qsizetype gt = lt < 0 ? -1 : buffer.indexOf('>', lt);
+        if (gt < 0) {
+            // Fin du tampon : le texte est conservé s'il fait partie d'un titre, la balise
+            // incomplète est reportée au début du tampon suivant
+            const qsizetype keep = lt < 0 ? buffer.size() : lt;
+            if (inTitle) {
+                current.title += QStringView(buffer).mid(pos, keep - pos);
+            }
+            if (in.atEnd()) {
+                break;
+            }
+            buffer = (lt < 0 || buffer.size() - lt > kMaxTagLength) ? QString() : buffer.mid(lt);
+            buffer += in.read(kImportChunk);
+            pos = 0;
+            continue;
+        }
+        if (inTitle) {
+            current.title += QStringView(buffer).mid(pos, lt - pos);
+        }
+        pos = gt + 1;
+
+        const QStringView tag = QStringView(buffer).mid(lt + 1, gt - lt - 1).trimmed();
+        qsizetype nameEnd = 0;
+        while (nameEnd < tag.size() && !tag[nameEnd].isSpace()) {
+            ++nameEnd;
+        }
+        const QStringView name = tag.left(nameEnd);
+
+        if (name.compare(u"DL", Qt::CaseInsensitive) == 0) {
+            folders.append(pendingFolder >= 0 ? pendingFolder : folders.last());
+            pendingFolder = -1;
+        } else if (name.compare(u"/DL", Qt::CaseInsensitive) == 0) {
+            if (folders.size() > 1) {
+                folders.removeLast();
+            }
+        } else if (name.compare(u"H3", Qt::CaseInsensitive) == 0 || name.compare(u"A", Qt::CaseInsensitive) == 0) {
+            current = Node();
+            current.folder = name.size() == 2;
+            current.url = attribute(tag, QLatin1String("HREF"));
+            current.addedSecs = attribute(tag, QLatin1String("ADD_DATE")).toLongLong();
+            inTitle = true;
+        } else if (inTitle && name.compare(u"/H3", Qt::CaseInsensitive) == 0 && current.folder) {
+            current.title = decodeEntities(current.title.trimmed());
+            pendingFolder = append(folders.last(), current);
+            inTitle = false;
+        } else if (inTitle && name.compare(u"/A", Qt::CaseInsensitive) == 0 && !current.folder) {
+            current.url = decodeEntities(current.url);
+            current.title = decodeEntities(current.title.trimmed());
+            if (!current.url.isEmpty()) {
+                if (current.title.isEmpty()) {
+                    current.title = current.url;
+                }
+                append(folders.last(), current);
+                ++imported;
+            }
+            inTitle = false;
+        }
+    }
+    scheduleSave();
+    return imported;
+}
+
+// Écriture en flux, dossier par dossier, sans construire le document en mémoire
+bool BookmarkStore::exportNetscape(QIODevice *device) const
+{
+    QTextStream out(device);
+    out.setEncoding(QStringConverter::Utf8);
+    out << "<!DOCTYPE NETSCAPE-Bookmark-file-1>\n"
+           "<META HTTP-EQUIV=\"Content-Type\" CONTENT=\"text/html; charset=UTF-8\">\n"
+           "<TITLE>Bookmarks</TITLE>\n"
+           "<H1>Bookmarks</H1>\n"
+           "<DL><p>\n";
+
+    // Pile des dossiers ouverts : (dossier, prochain enfant à écrire)
+    QVector<QPair<int, int>> stack{{kRootId, 0}};
+    while (!stack.isEmpty()) {
+        const Node &folder = nodes[stack.last().first];
+        const int index = stack.last().second++;
+        const QString indent(stack.size() * 4, ' ');
+        if (index >= folder.children.size()) {
+            stack.removeLast();
+            out << QString(stack.size() * 4, ' ') << "</DL><p>\n";
+            continue;
+        }
+        const int id = folder.children[index];
+        const Node &node = nodes[id];
+        if (node.folder) {
+            out << indent << "<DT><H3 ADD_DATE=\"" << node.addedSecs << "\">" << node.title.toHtmlEscaped() << "</H3>\n"
+                << indent << "<DL><p>\n";
+            stack.append({id, 0});
+        } else {
+            out << indent << "<DT><A HREF=\"" << node.url.toHtmlEscaped() << "\" ADD_DATE=\"" << node.addedSecs << "\">"
+                << node.title.toHtmlEscaped() << "</A>\n";
+        }
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+QByteArray BookmarkStore::serialize(const QVector<Node> &nodes)
+{
+    QByteArray data;
+    QDataStream header(&data, QIODevice::WriteOnly);
+    header << kMagic << kVersion;
+
+    QByteArray previousUrl;
+    qint64 previousAdded = 0;
+    putVarint(data, quint64(nodes[kRootId].children.size()));
+    QVector<int> pending(nodes[kRootId].children.rbegin(), nodes[kRootId].children.rend());
+    while (!pending.isEmpty()) {
+        const Node &node = nodes[pending.takeLast()];
+        data.append(char(node.folder ? 1 : 0));
+        putVarint(data, zigzag(node.addedSecs - previousAdded));
+        previousAdded = node.addedSecs;
+        putBytes(data, node.title.toUtf8());
+        if (node.folder) {
+            putVarint(data, quint64(node.children.size()));
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                pending.append(*it); // Ordre préfixe : le premier enfant est écrit juste après son dossier
+            }
+            continue;
+        }
+        // Les liens d'un même dossier partagent souvent leur début (schéma, hôte, chemin)
+        const QByteArray url = node.url.toUtf8();
+        qsizetype common = 0;
+        const qsizetype limit = qMin(url.size(), previousUrl.size());
+        while (common < limit && url[common] == previousUrl[common]) {
+            ++common;
+        }
+        putVarint(data, quint64(common));
+        putBytes(data, url.mid(common));
+        previousUrl = url;
+    }
+    return data;
+}
+
+bool BookmarkStore::deserialize(const QByteArray &data, QVector<Node> &nodes)
+{
+    if (data.size() < kHeaderSize) {
+        return false;
+    }
+    QDataStream header(data);
+    quint32 magic = 0;
+    quint16 version = 0;
+    header >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        return false;
+    }
+
+    const char *p = data.constData() + kHeaderSize;
+    const char *const end = data.constData() + data.size();
+    QVector<Node> result(1);
+    result[kRootId].folder = true;
+    result[kRootId].title = "Favoris";
+
+    // Chaque nœud occupe au moins 4 octets : un nombre d'enfants plus grand trahit un fichier corrompu
+    auto plausible = [&](quint64 children) { return children <= quint64(end - p) / 4; };
+    quint64 rootChildren = 0;
+    if (!getVarint(p, end, rootChildren) || !plausible(rootChildren)) {
+        return false;
+    }
+    QVector<QPair<int, quint64>> open{{kRootId, rootChildren}}; // (dossier, enfants restant à lire)
+    QByteArray url;
+    qint64 added = 0;
+    while (!open.isEmpty()) {
+        if (open.last().second == 0) {
+            open.removeLast();
+            continue;
+        }
+        --open.last().second;
+        if (p >= end) {
+            return false;
+        }
+        Node node;
+        node.folder = *p++ != 0;
+        node.parent = open.last().first;
+        quint64 delta = 0;
+        QByteArray title;
+        if (!getVarint(p, end, delta) || !getBytes(p, end, title)) {
+            return false;
+        }
+        added += unzigzag(delta);
+        node.addedSecs = added;
+        node.title = QString::fromUtf8(title);
+
+        quint64 count = 0;
+        if (node.folder) {
+            if (!getVarint(p, end, count) || !plausible(count)) {
+                return false;
+            }
+        } else {
+            QByteArray suffix;
+            if (!getVarint(p, end, count) || count > quint64(url.size()) || !getBytes(p, end, suffix)) {
+                return false;
+            }
+            url = url.left(qsizetype(count)) + suffix;
+            node.url = QString::fromUtf8(url);
+        }
+        const int id = result.size();
+        result[node.parent].children.append(id);
+        result.append(node);
+        if (node.folder) {
+            open.append({id, count});
+        }
+    }
+    if (p != end) {
+        return false;
+    }
+    nodes = result;
+    return true;
+}
@@ -0,0 +1,99 @@
+// bookmarkstore.h
+#ifndef BOOKMARKSTORE_H
+#define BOOKMARKSTORE_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+class QIODevice;
+
+// Favoris : arbre de dossiers et de liens, enregistré dans un fichier binaire compact.
+//
+// Le test "cette URL est-elle dans les favoris ?" est fait à chaque changement d'URL d'un
+// onglet : il passe par une table de hachage des URL (nombre de favoris par URL), en temps
+// constant quelle que soit la taille de l'arbre.
+//
+// Format du fichier (bookmarks.bin) : en-tête "ICTB" + version, puis les nœuds en ordre
+// préfixe. Entiers en varint, chaînes en UTF-8 ; chaque URL ne stocke que ce qui la distingue
+// de l'URL précédente (longueur du préfixe commun + suffixe), les dates d'ajout sont codées en
+// écart avec la précédente. Un dossier indique seulement son nombre d'enfants.
+//
+// L'import et l'export au format HTML Netscape (celui de tous les navigateurs) se font en flux :
+// le fichier est lu et écrit par blocs, jamais chargé en entier en mémoire.
+//
+// Comme SessionStore, les modifications sont regroupées avant une écriture par QSaveFile.
+class BookmarkStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kRootId = 0; // Dossier racine, toujours présent
+
+    struct Node {
+        int parent = -1;
+        bool folder = false;
+        bool removed = false;
+        QString title;
+        QString url;           // Vide pour un dossier
+        qint64 addedSecs = 0;  // Date d'ajout (secondes depuis l'époque Unix)
+        QVector<int> children; // Dans l'ordre d'affichage
+    };
+
+    // Avec un chemin vide, rien n'est lu ni écrit (mesures)
+    explicit BookmarkStore(const QString &filePath, QObject *parent = nullptr);
+    ~BookmarkStore(); // Écrit les modifications encore en attente
+
+    bool load();
+    bool saveNow();
+
+    const Node &node(int id) const { return nodes[id]; }
+    bool isValid(int id) const { return id >= 0 && id < nodes.size() && !nodes[id].removed; }
+    int count() const { return bookmarkCount; } // Nombre de liens (hors dossiers)
+
+    int addFolder(int parent, const QString &title);
+    int addBookmark(int parent, const QString &url, const QString &title, qint64 addedSecs = 0);
+    void rename(int id, const QString &title);
+    // Déplace id (et son sous-arbre) à la fin du dossier parent ; refusé vers son propre sous-arbre
+    bool move(int id, int parent);
+    void remove(int id); // Supprime aussi le contenu d'un dossier
+
+    // Temps constant : consulté à chaque urlChanged
+    bool isBookmarked(const QString &url) const { return urlCounts.contains(urlKey(url)); }
+    // Premier favori de l'URL (-1 si aucun), pour le retirer depuis la barre d'adresse
+    int findBookmark(const QString &url) const;
+    // Tous les liens (URL, titre, date d'ajout), pour initialiser l'index d'autocomplétion
+    void bookmarks(QStringList &urls, QStringList &titles, QVector<qint64> &addedSecs) const;
+
+    // Import en flux d'un fichier HTML Netscape dans le dossier parent ; renvoie le nombre de liens
+    int importNetscape(QIODevice *device, int parent);
+    bool exportNetscape(QIODevice *device) const;
+
+    static QByteArray serialize(const QVector<Node> &nodes);
+    static bool deserialize(const QByteArray &data, QVector<Node> &nodes);
+
+signals:
+    void changed(); // Arbre modifié (ajout, suppression, renommage, déplacement)
+    // Une URL entre dans les favoris ou en sort (premier ajout, dernière suppression)
+    void bookmarkedChanged(const QString &url, const QString &title, bool bookmarked, qint64 addedSecs);
+
+private:
+    QString filePath;
+    QVector<Node> nodes;           // Indexés par identifiant ; les nœuds supprimés restent marqués
+    QHash<QString, int> urlCounts; // Clé d'URL -> nombre de favoris qui la portent
+    int bookmarkCount = 0;
+    QTimer saveTimer;
+
+    int append(int parent, Node node);
+    void countUrl(const Node &node, int delta);
+    void scheduleSave();
+    void rebuildIndex();
+
+    // Clé de recherche : l'URL sans fragment ni barre oblique finale
+    static QString urlKey(const QString &url);
+};
+
+#endif // BOOKMARKSTORE_H
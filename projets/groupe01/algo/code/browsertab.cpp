@@ -0,0 +1,352 @@
+// browsertab.cpp
+#include "browsertab.h"
+
+#include <QDataStream>     // Sérialisation de QWebEngineHistory pour les instantanés de page
+#include <QDateTime>
+#include <QVariant>
+#include <QVBoxLayout>
+#include <QWebEngineHistory>
+#include <QWebEngineNavigationRequest> // Détection des redirections
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+#include <QWebEngineScript>
+#include <QWebEngineView>
+
+namespace {
+// Taille maximale de l'historique retour/avance et mémoire allouée aux instantanés de page
+const int kHistoryMaxEntries = 100;
+const qint64 kHistoryMemoryBudget = 16 * 1024 * 1024;
+
+// Seuils de loadProgress enregistrés (pourcentages), dans l'ordre de NavigationTiming::progressMs
+const int kProgressPercent[NavigationTiming::kProgressSteps] = {25, 50, 75, 100};
+
+// Entrée "navigation" de l'API Navigation Timing, en millisecondes depuis son début (startTime = 0)
+const char *const kNavigationTimingScript = R"(
+(function () {
+    var n = performance.getEntriesByType('navigation')[0];
+    if (!n) return null;
+    return {
+        dns: n.domainLookupEnd - n.domainLookupStart,
+        connect: n.connectEnd - n.connectStart,
+        ttfb: n.responseStart,
+        responseEnd: n.responseEnd,
+        domInteractive: n.domInteractive,
+        domContentLoaded: n.domContentLoadedEventEnd,
+        loadEvent: n.loadEventStart,
+        transferSize: n.transferSize
+    };
+})()
+)";
+
+// Les valeurs nulles de l'API signifient "pas encore atteint" : elles deviennent inconnues (-1)
+double timingValue(const QVariantMap &values, const char *key)
+{
+    const QVariant value = values.value(key);
+    return value.isValid() && value.toDouble() > 0 ? value.toDouble() : -1;
+}
+}
+
+BrowserTab::BrowserTab(QWebEngineProfile *profile, QWidget *parent)
+    : QWidget(parent)
+    , profile(profile)
+    , layout(new QVBoxLayout(this))
+    , sessionHistory(kHistoryMaxEntries, kHistoryMemoryBudget) // Historique borné en taille et en mémoire
+    , lastActivated(QDateTime::currentMSecsSinceEpoch())
+{
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+}
+
+QWebEngineView *BrowserTab::ensureView()
+{
+    if (webView) {
+        return webView;
+    }
+
+    webView = new QWebEngineView(this);
+    webView->setPage(new QWebEnginePage(profile, webView));
+    webView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    layout->addWidget(webView);
+
+    connect(webView, &QWebEngineView::urlChanged, this, [this](const QUrl &url) {
+        // C'est le seul endroit qui modifie l'historique : saisie, liens, redirections et
+        // retour/avance passent tous par ici, une seule fois par page affichée.
+        const HistoryEntry *current = sessionHistory.current();
+        if (current && current->url == url) {
+            // Retour/avance arrivé sur la page attendue, rechargement ou onglet réactivé
+        } else if (engineHistoryPending && !redirectPending) {
+            followEngineHistory(url); // Retour/avance demandé par la page ou son menu contextuel
+        } else if (historyNavigationPending || redirectPending) {
+            sessionHistory.replaceCurrent(url); // Redirection : la page remplace l'entrée courante
+        } else {
+            sessionHistory.navigate(url); // Nouvelle page : l'historique "avant" est effacé
+            emit pageVisited(url);
+        }
+        historyNavigationPending = false;
+        engineHistoryPending = false;
+        redirectPending = false;
+        committedInCurrentLoad = true;
+        emit urlChanged(url);
+        emit historyChanged();
+    });
+
+    connect(webView, &QWebEngineView::titleChanged, this, &BrowserTab::titleChanged);
+
+    // Avant de quitter une page, on mémorise son état pour un retour instantané
+    connect(webView, &QWebEngineView::loadStarted, this, [this]() {
+        // Début de la mesure ; une navigation précédente non terminée est abandonnée
+        timing = NavigationTiming();
+        timing.startedAtMSecs = QDateTime::currentMSecsSinceEpoch();
+        timing.requestToStartMs = loadRequested.isValid() ? loadRequested.nsecsElapsed() / 1e6 : -1;
+        loadRequested.invalidate();
+        navigationClock.start();
+        nextProgressStep = 0;
+        timingActive = true;
+
+        committedInCurrentLoad = false;
+        if (!historyNavigationPending) {
+            snapshotCurrentPage();
+        }
+    });
+    // Une redirection émise par une page déjà affichée (meta refresh, location.replace) la remplace.
+    // Les redirections serveur arrivent avant l'affichage et ne produisent qu'un seul urlChanged.
+    // Un retour/avance que le moteur lance lui-même (menu contextuel, history.back()) déplace la
+    // page courante de l'historique de session au lieu d'y empiler une nouvelle entrée.
+    connect(webView->page(), &QWebEnginePage::navigationRequested, this, [this](QWebEngineNavigationRequest &request) {
+        if (!request.isMainFrame()) {
+            return;
+        }
+        if (request.navigationType() == QWebEngineNavigationRequest::RedirectNavigation) {
+            redirectPending = redirectPending || committedInCurrentLoad;
+        } else {
+            engineHistoryPending = request.navigationType() == QWebEngineNavigationRequest::BackForwardNavigation
+                                   && !historyNavigationPending;
+        }
+    });
+    connect(webView, &QWebEngineView::loadProgress, this, [this](int progress) {
+        while (timingActive && nextProgressStep < NavigationTiming::kProgressSteps
+               && progress >= kProgressPercent[nextProgressStep]) {
+            timing.progressMs[nextProgressStep++] = navigationClock.nsecsElapsed() / 1e6;
+        }
+    });
+    // Une fois la page revenue, on restaure sa position de défilement
+    connect(webView, &QWebEngineView::loadFinished, this, [this](bool ok) {
+        finishTiming(ok);
+        if (ok && scrollRestorePending) {
+            webView->page()->runJavaScript(QString("window.scrollTo(%1, %2);")
+                                               .arg(pendingScrollPosition.x())
+                                               .arg(pendingScrollPosition.y()));
+        }
+        scrollRestorePending = false;
+        emit loadFinished(ok);
+    });
+
+    return webView;
+}
+
+void BrowserTab::load(const QUrl &url)
+{
+    loadRequested.start();
+    ensureView()->load(url);
+}
+
+// Complète la mesure avec l'API Navigation Timing de la page (lue dans un monde JavaScript
+// isolé, hors d'atteinte des scripts de la page), puis la publie
+void BrowserTab::finishTiming(bool ok)
+{
+    if (!timingActive) {
+        return;
+    }
+    timingActive = false;
+    timing.loadFinishedMs = navigationClock.nsecsElapsed() / 1e6;
+    timing.url = webView->url();
+    timing.ok = ok;
+    if (!ok) {
+        emit navigationTimed(timing);
+        return;
+    }
+    const NavigationTiming measured = timing;
+    webView->page()->runJavaScript(kNavigationTimingScript, QWebEngineScript::ApplicationWorld,
+                                   [this, measured](const QVariant &result) {
+        NavigationTiming t = measured;
+        const QVariantMap values = result.toMap();
+        t.dnsMs = values.contains("dns") ? values.value("dns").toDouble() : -1;
+        t.connectMs = values.contains("connect") ? values.value("connect").toDouble() : -1;
+        t.ttfbMs = timingValue(values, "ttfb");
+        t.responseEndMs = timingValue(values, "responseEnd");
+        t.domInteractiveMs = timingValue(values, "domInteractive");
+        t.domContentLoadedMs = timingValue(values, "domContentLoaded");
+        t.loadEventMs = timingValue(values, "loadEvent");
+        t.transferBytes = values.contains("transferSize") ? values.value("transferSize").toLongLong() : -1;
+        emit navigationTimed(t);
+    });
+}
+
+void BrowserTab::goBack()
+{
+    if (sessionHistory.canGoBack()) {
+        snapshotCurrentPage(); // Mémorise la page quittée pour un "Avance" instantané
+        navigateHistory(sessionHistory.goBack(), false);
+    }
+}
+
+void BrowserTab::goForward()
+{
+    if (sessionHistory.canGoForward()) {
+        snapshotCurrentPage(); // Mémorise la page quittée pour un "Retour" instantané
+        navigateHistory(sessionHistory.goForward(), true);
+    }
+}
+
+QUrl BrowserTab::url() const
+{
+    const HistoryEntry *current = sessionHistory.current();
+    return current ? current->url : QUrl();
+}
+
+QString BrowserTab::title() const
+{
+    if (webView && !webView->title().isEmpty()) {
+        return webView->title();
+    }
+    const HistoryEntry *current = sessionHistory.current();
+    return current ? current->title : QString();
+}
+
+TabState BrowserTab::saveState()
+{
+    if (isLive()) {
+        snapshotCurrentPage(); // Défilement et historique du moteur à jour
+    }
+
+    // Seul l'instantané de la page courante est gardé : il suffit à reconstruire tout
+    // l'historique du moteur pour cet onglet, et garde le fichier de session compact
+    TabState state;
+    state.currentIndex = sessionHistory.currentIndex();
+    state.entries.reserve(sessionHistory.size());
+    for (int i = 0; i < sessionHistory.size(); ++i) {
+        HistoryEntry entry = sessionHistory.at(i);
+        if (i != state.currentIndex) {
+            entry.pageState.clear();
+        }
+        state.entries.append(entry);
+    }
+    return state;
+}
+
+void BrowserTab::restoreState(const TabState &state)
+{
+    sessionHistory.restore(state.entries, state.currentIndex);
+    emit historyChanged();
+    if (const HistoryEntry *current = sessionHistory.current()) {
+        emit titleChanged(current->title);
+    }
+}
+
+void BrowserTab::activate()
+{
+    lastActivated = QDateTime::currentMSecsSinceEpoch();
+    if (!webView) {
+        const HistoryEntry *current = sessionHistory.current();
+        if (!current) {
+            return; // Onglet vierge
+        }
+        // Onglet restauré, activé pour la première fois : l'historique est déjà connu,
+        // urlChanged ne doit rien empiler
+        historyNavigationPending = true;
+        scrollRestorePending = true;
+        pendingScrollPosition = current->scrollPosition;
+        if (!current->pageState.isEmpty()) {
+            QDataStream in(current->pageState);
+            in >> *ensureView()->history(); // Le moteur retrouve aussi son propre retour/avance
+        } else {
+            ensureView()->load(current->url);
+        }
+    } else if (isDiscarded()) {
+        // Le moteur a gardé l'historique de la page : il la recharge à l'identique
+        webView->page()->setLifecycleState(QWebEnginePage::LifecycleState::Active);
+    }
+}
+
+bool BrowserTab::discard()
+{
+    // L'onglet affiché ne peut pas être déchargé (le moteur le refuse d'ailleurs)
+    if (!webView || isVisible() || isDiscarded()) {
+        return false;
+    }
+
+    snapshotCurrentPage();
+    if (const HistoryEntry *current = sessionHistory.current()) {
+        scrollRestorePending = true;
+        pendingScrollPosition = current->scrollPosition;
+    }
+    webView->page()->setLifecycleState(QWebEnginePage::LifecycleState::Discarded);
+    return true;
+}
+
+bool BrowserTab::isDiscarded() const
+{
+    return webView && webView->page()->lifecycleState() == QWebEnginePage::LifecycleState::Discarded;
+}
+
+// Mémorise l'état de la page courante : titre, défilement et historique du moteur sérialisé
+void BrowserTab::snapshotCurrentPage()
+{
+    if (!webView || sessionHistory.isEmpty()) {
+        return;
+    }
+    QByteArray state;
+    QDataStream out(&state, QIODevice::WriteOnly);
+    out << *webView->history();
+    sessionHistory.snapshotCurrent(webView->title(), webView->page()->scrollPosition(), state);
+}
+
+// Le moteur est revenu (ou allé) de lui-même sur url : la page courante devient l'entrée de
+// l'historique de session la plus proche qui porte cette URL. Une entrée déjà évincée de
+// l'historique de session remplace simplement la page courante.
+void BrowserTab::followEngineHistory(const QUrl &url)
+{
+    const int cursor = sessionHistory.currentIndex();
+    for (int step = 1; cursor - step >= 0 || cursor + step < sessionHistory.size(); ++step) {
+        if (cursor - step >= 0 && sessionHistory.at(cursor - step).url == url) {
+            for (int i = 0; i < step; ++i) {
+                sessionHistory.goBack();
+            }
+            return;
+        }
+        if (cursor + step < sessionHistory.size() && sessionHistory.at(cursor + step).url == url) {
+            for (int i = 0; i < step; ++i) {
+                sessionHistory.goForward();
+            }
+            return;
+        }
+    }
+    sessionHistory.replaceCurrent(url);
+}
+
+// Affiche une entrée de l'historique de session, par le moyen le plus rapide disponible
+void BrowserTab::navigateHistory(const HistoryEntry &target, bool forward)
+{
+    historyNavigationPending = true;
+    scrollRestorePending = true;
+    pendingScrollPosition = target.scrollPosition;
+
+    QWebEngineHistory *engineHistory = ensureView()->history();
+    const QWebEngineHistoryItem neighbour = forward ? engineHistory->forwardItem() : engineHistory->backItem();
+    if (neighbour.isValid() && neighbour.url() == target.url) {
+        // Le moteur connaît encore la page voisine : retour/avance instantané (cache de pages)
+        if (forward) {
+            webView->forward();
+        } else {
+            webView->back();
+        }
+    } else if (!target.pageState.isEmpty()) {
+        // Restaure l'historique du moteur tel qu'il était sur cette page ; il la réaffiche
+        QDataStream in(target.pageState);
+        in >> *engineHistory;
+    } else {
+        webView->load(target.url); // Instantané évincé par le budget mémoire : simple rechargement
+    }
+
+    emit historyChanged();
+}
@@ -0,0 +1,94 @@
+// browsertab.h
+#ifndef BROWSERTAB_H
+#define BROWSERTAB_H
+
+#include <QElapsedTimer>
+#include <QPointF>
+#include <QUrl>
+#include <QWidget>
+
+#include "navigationlog.h"  // NavigationTiming : mesures de chaque navigation
+#include "sessionhistory.h" // Chaque onglet possède son propre historique de session
+#include "sessionstore.h"   // TabState : état sauvegardé d'un onglet
+
+class QVBoxLayout;
+class QWebEngineProfile;
+class QWebEngineView;
+
+// Un onglet du navigateur : une vue web créée à la demande et son historique de session.
+// Un onglet en arrière-plan peut être "déchargé" : son processus de rendu est libéré mais
+// le moteur conserve l'état de la page, qui est rechargée à la prochaine activation.
+class BrowserTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BrowserTab(QWebEngineProfile *profile, QWidget *parent = nullptr);
+
+    // Charge une URL saisie par l'utilisateur (l'historique est mis à jour par urlChanged)
+    void load(const QUrl &url);
+    void goBack();
+    void goForward();
+    bool canGoBack() const { return sessionHistory.canGoBack(); }
+    bool canGoForward() const { return sessionHistory.canGoForward(); }
+
+    QUrl url() const;
+    QString title() const;
+    const SessionHistory &history() const { return sessionHistory; }
+    QWebEngineView *view() const { return webView; } // nullptr tant que l'onglet n'a rien chargé
+
+    // Sauvegarde/restauration de session. Un onglet restauré ne crée sa vue web et ne
+    // charge sa page qu'à sa première activation.
+    TabState saveState();
+    void restoreState(const TabState &state);
+
+    // L'onglet devient l'onglet courant : une page déchargée ou restaurée est chargée ici
+    void activate();
+    qint64 lastActivatedMSecs() const { return lastActivated; }
+
+    // Libère le processus de rendu d'un onglet en arrière-plan ; false si ce n'est pas possible
+    bool discard();
+    bool isDiscarded() const;
+    bool isLive() const { return webView && !isDiscarded(); }
+
+signals:
+    void urlChanged(const QUrl &url);   // La page affichée a changé (y compris retour/avance)
+    void pageVisited(const QUrl &url);  // Nouvelle entrée dans l'historique de l'onglet
+    void titleChanged(const QString &title);
+    void historyChanged();              // canGoBack()/canGoForward() ont pu changer
+    void loadFinished(bool ok);
+    // Mesures d'une navigation terminée (après lecture de l'API Navigation Timing de la page)
+    void navigationTimed(const NavigationTiming &timing);
+
+private:
+    QWebEngineProfile *profile;
+    QVBoxLayout *layout;
+    QWebEngineView *webView = nullptr;
+    SessionHistory sessionHistory;
+    qint64 lastActivated;
+
+    bool historyNavigationPending = false; // Un retour/avance est en cours : urlChanged ne doit rien empiler
+    bool engineHistoryPending = false;     // Retour/avance lancé par le moteur : urlChanged déplace la page courante
+    bool redirectPending = false;          // La prochaine URL remplace la page courante (redirection)
+    bool committedInCurrentLoad = false;   // La page du chargement en cours est déjà affichée
+    bool scrollRestorePending = false;     // Restaurer pendingScrollPosition à la fin du chargement
+    QPointF pendingScrollPosition;
+
+    // Mesure de la navigation en cours
+    QElapsedTimer loadRequested;     // Démarré par load() : délai jusqu'à loadStarted
+    QElapsedTimer navigationClock;   // Démarré à loadStarted
+    NavigationTiming timing;
+    bool timingActive = false;
+    int nextProgressStep = 0;
+    void finishTiming(bool ok);
+
+    QWebEngineView *ensureView();
+    // Mémorise défilement et état du moteur de la page courante avant de la quitter
+    void snapshotCurrentPage();
+    // Suit dans l'historique de session un retour/avance lancé par le moteur
+    void followEngineHistory(const QUrl &url);
+    // Affiche une entrée de l'historique, instantanément si possible
+    void navigateHistory(const HistoryEntry &target, bool forward);
+};
+
+#endif // BROWSERTAB_H
@@ -0,0 +1,77 @@
+// cacheschemehandler.cpp
+#include "cacheschemehandler.h"
+
+#include <QBuffer>
+#include <QMap>
+#include <QPointer>
+#include <QWebEngineUrlRequestJob>
+
+#include "httpcache.h"
+
+CacheSchemeHandler::CacheSchemeHandler(HttpCache *cache, QObject *parent)
+    : QWebEngineUrlSchemeHandler(parent)
+    , cache(cache)
+{
+}
+
+void CacheSchemeHandler::requestStarted(QWebEngineUrlRequestJob *job)
+{
+    const QUrl originUrl = cache->toOriginUrl(job->requestUrl());
+
+    // La réponse peut arriver après l'abandon de la requête par le moteur (page fermée...)
+    QPointer<QWebEngineUrlRequestJob> guard(job);
+    const HttpCache::Callback replyTo = [this, guard](const HttpCache::Response &response) {
+        if (!guard) {
+            if (response.stream) {
+                response.stream->deleteLater();
+            }
+            return;
+        }
+        if (!response.ok) {
+            guard->fail(QWebEngineUrlRequestJob::RequestFailed);
+            return;
+        }
+        // Redirection (page de connexion...) : le moteur la suit, vers le cache si la cible
+        // est elle aussi une origine mise en cache
+        if (response.redirectUrl.isValid()) {
+            guard->redirect(cache->isCachedOrigin(response.redirectUrl) ? HttpCache::toCacheUrl(response.redirectUrl)
+                                                                         : response.redirectUrl);
+            return;
+        }
+        // Gros fichier : le moteur lit la réponse réseau elle-même, au rythme où elle arrive
+        if (response.stream) {
+            response.stream->setParent(guard);
+            guard->reply(response.mimeType, response.stream);
+            return;
+        }
+        auto *buffer = new QBuffer(guard);
+        buffer->setData(response.body);
+        buffer->open(QIODevice::ReadOnly);
+        guard->reply(response.mimeType, buffer);
+    };
+
+    // Requêtes non idempotentes : jamais par le cache. Un formulaire de page ou de cadre est
+    // redirigé vers l'origine par RequestInterceptor ; un fetch() ou un XMLHttpRequest ne peut
+    // pas l'être sans devenir une requête vers une autre origine (CORS), il est donc transmis
+    // à l'origine d'ici, avec sa méthode, ses en-têtes et son corps.
+    if (job->requestMethod() != "GET") {
+        QMap<QByteArray, QByteArray> headers;
+        const QMap<QByteArray, QByteArray> requestHeaders = job->requestHeaders();
+        for (auto it = requestHeaders.constBegin(); it != requestHeaders.constEnd(); ++it) {
+            const QByteArray name = it.key().toLower();
+            if (name == "host" || name == "content-length" || name == "cookie") {
+                continue; // Fixés par le gestionnaire réseau du cache et son pot de cookies
+            }
+            if (name == "origin" || name == "referer") {
+                headers.insert(it.key(), cache->toOriginUrl(QUrl::fromEncoded(it.value())).toEncoded());
+            } else {
+                headers.insert(it.key(), it.value());
+            }
+        }
+        QIODevice *body = job->requestBody();
+        cache->send(originUrl, job->requestMethod(), headers, body ? body->readAll() : QByteArray(), replyTo);
+        return;
+    }
+
+    cache->fetch(originUrl, replyTo);
+}
@@ -0,0 +1,24 @@
+// cacheschemehandler.h
+#ifndef CACHESCHEMEHANDLER_H
+#define CACHESCHEMEHANDLER_H
+
+#include <QWebEngineUrlSchemeHandler>
+
+class HttpCache;
+
+// Sert les URL du schéma HttpCache::kScheme à partir du cache HTTP local ; les requêtes non GET
+// d'une page servie par le cache (fetch(), XMLHttpRequest) sont transmises à l'origine
+class CacheSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+    Q_OBJECT
+
+public:
+    explicit CacheSchemeHandler(HttpCache *cache, QObject *parent = nullptr);
+
+    void requestStarted(QWebEngineUrlRequestJob *job) override;
+
+private:
+    HttpCache *cache;
+};
+
+#endif // CACHESCHEMEHANDLER_H
@@ -0,0 +1,80 @@
+// contentfilter.cpp
+#include "contentfilter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace ContentFilter {
+
+std::shared_ptr<const FilterEngine> load(const QString &listDirectory, const QString &cacheFile)
+{
+    const QFileInfoList lists = QDir(listDirectory).entryInfoList({"*.txt"}, QDir::Files, QDir::Name);
+    if (lists.isEmpty()) {
+        return nullptr;
+    }
+
+    // Empreinte des listes : nom, taille et date de chaque fichier (FNV-1a)
+    uint64_t sourceKey = 0xcbf29ce484222325ull;
+    for (const QFileInfo &list : lists) {
+        const QByteArray id = list.fileName().toUtf8() + '\0' + QByteArray::number(list.size()) + '\0'
+                            + QByteArray::number(list.lastModified().toMSecsSinceEpoch()) + '\0';
+        for (char c : id) {
+            sourceKey = (sourceKey ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+    }
+
+    auto engine = std::make_shared<FilterEngine>();
+    const std::string cachePath = QFile::encodeName(cacheFile).toStdString();
+    if (engine->load(cachePath, sourceKey)) {
+        return engine;
+    }
+
+    for (const QFileInfo &list : lists) {
+        QFile file(list.filePath());
+        if (file.open(QFile::ReadOnly)) {
+            const QByteArray text = file.readAll();
+            engine->addList(std::string_view(text.constData(), static_cast<size_t>(text.size())));
+        }
+    }
+    engine->compile();
+    engine->save(cachePath, sourceKey);
+    return engine;
+}
+
+FilterEngine::ResourceType resourceType(QWebEngineUrlRequestInfo::ResourceType type)
+{
+    switch (type) {
+    case QWebEngineUrlRequestInfo::ResourceTypeScript:
+    case QWebEngineUrlRequestInfo::ResourceTypeWorker:
+    case QWebEngineUrlRequestInfo::ResourceTypeSharedWorker:
+    case QWebEngineUrlRequestInfo::ResourceTypeServiceWorker:
+        return FilterEngine::Script;
+    case QWebEngineUrlRequestInfo::ResourceTypeImage:
+    case QWebEngineUrlRequestInfo::ResourceTypeFavicon:
+        return FilterEngine::Image;
+    case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:
+        return FilterEngine::Stylesheet;
+    case QWebEngineUrlRequestInfo::ResourceTypeObject:
+    case QWebEngineUrlRequestInfo::ResourceTypePluginResource:
+        return FilterEngine::Object;
+    case QWebEngineUrlRequestInfo::ResourceTypeSubFrame:
+        return FilterEngine::Subdocument;
+    case QWebEngineUrlRequestInfo::ResourceTypeXhr:
+        return FilterEngine::XmlHttpRequest;
+    case QWebEngineUrlRequestInfo::ResourceTypeWebSocket:
+        return FilterEngine::WebSocket;
+    case QWebEngineUrlRequestInfo::ResourceTypeFontResource:
+        return FilterEngine::Font;
+    case QWebEngineUrlRequestInfo::ResourceTypeMedia:
+        return FilterEngine::Media;
+    case QWebEngineUrlRequestInfo::ResourceTypePing:
+    case QWebEngineUrlRequestInfo::ResourceTypeCspReport:
+        return FilterEngine::Ping;
+    default:
+        return FilterEngine::Other;
+    }
+}
+
+} // namespace ContentFilter
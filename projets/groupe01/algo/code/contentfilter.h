@@ -0,0 +1,25 @@
+// contentfilter.h
+#ifndef CONTENTFILTER_H
+#define CONTENTFILTER_H
+
+#include <QString>
+#include <QWebEngineUrlRequestInfo>
+#include <memory>
+
+#include "filterengine.h"
+
+// Chargement des listes de filtres (EasyList...) pour le blocage des requêtes.
+// Les listes sont les fichiers *.txt d'un dossier ; leur forme compilée est gardée dans un
+// fichier binaire, relu tel quel tant que les listes n'ont pas changé (taille, date).
+namespace ContentFilter {
+
+// Moteur prêt à l'emploi, ou nullptr s'il n'y a aucune liste. Peut prendre du temps
+// (compilation) : à appeler hors du thread graphique.
+std::shared_ptr<const FilterEngine> load(const QString &listDirectory, const QString &cacheFile);
+
+// Correspondance entre les types de ressources de QtWebEngine et ceux des filtres
+FilterEngine::ResourceType resourceType(QWebEngineUrlRequestInfo::ResourceType type);
+
+} // namespace ContentFilter
+
+#endif // CONTENTFILTER_H
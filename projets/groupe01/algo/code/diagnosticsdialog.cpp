@@ -0,0 +1,102 @@
+// diagnosticsdialog.cpp
+#include "diagnosticsdialog.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "navigationlog.h"
+
+namespace {
+
+QTableWidgetItem *numberItem(double value)
+{
+    auto *item = new QTableWidgetItem;
+    // Valeur numérique (tri correct) ; les mesures inconnues restent vides
+    if (value >= 0) {
+        item->setData(Qt::DisplayRole, qRound(value));
+    }
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+} // namespace
+
+DiagnosticsDialog::DiagnosticsDialog(const NavigationLog *log, QWidget *parent)
+    : QDialog(parent)
+    , log(log)
+    , summaryLabel(new QLabel(this))
+    , hostTable(new QTableWidget(0, 8, this))
+{
+    setWindowTitle("Diagnostic de navigation");
+    resize(900, 500);
+
+    hostTable->setHorizontalHeaderLabels({"Hôte", "Navigations", "Échecs", "Chargement p50 (ms)", "p90 (ms)",
+                                          "p99 (ms)", "Premier octet p50 (ms)", "DOMContentLoaded p50 (ms)"});
+    hostTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    hostTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    hostTable->verticalHeader()->hide();
+    hostTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    hostTable->setSortingEnabled(true);
+
+    auto *refreshButton = new QPushButton("Actualiser", this);
+    auto *csvButton = new QPushButton("Exporter en CSV…", this);
+    auto *jsonButton = new QPushButton("Exporter en JSON…", this);
+    connect(refreshButton, &QPushButton::clicked, this, &DiagnosticsDialog::refresh);
+    connect(csvButton, &QPushButton::clicked, this, [this]() { exportLog("csv"); });
+    connect(jsonButton, &QPushButton::clicked, this, [this]() { exportLog("json"); });
+
+    auto *buttons = new QHBoxLayout;
+    buttons->addWidget(refreshButton);
+    buttons->addStretch();
+    buttons->addWidget(csvButton);
+    buttons->addWidget(jsonButton);
+    auto *layout = new QVBoxLayout(this);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(hostTable);
+    layout->addLayout(buttons);
+
+    refresh();
+}
+
+void DiagnosticsDialog::refresh()
+{
+    const QVector<NavigationLog::HostStats> stats = log->hostStatistics();
+    summaryLabel->setText(QString("%1 navigations mesurées (les %2 dernières sont conservées), %3 hôtes")
+                              .arg(log->size()).arg(log->capacity()).arg(stats.size()));
+
+    hostTable->setSortingEnabled(false); // Sinon chaque insertion retrie le tableau
+    hostTable->setRowCount(stats.size());
+    for (int row = 0; row < stats.size(); ++row) {
+        const NavigationLog::HostStats &h = stats[row];
+        hostTable->setItem(row, 0, new QTableWidgetItem(h.host));
+        hostTable->setItem(row, 1, numberItem(h.count));
+        hostTable->setItem(row, 2, numberItem(h.failures));
+        hostTable->setItem(row, 3, numberItem(h.loadP50));
+        hostTable->setItem(row, 4, numberItem(h.loadP90));
+        hostTable->setItem(row, 5, numberItem(h.loadP99));
+        hostTable->setItem(row, 6, numberItem(h.ttfbP50));
+        hostTable->setItem(row, 7, numberItem(h.domContentLoadedP50));
+    }
+    hostTable->setSortingEnabled(true);
+}
+
+void DiagnosticsDialog::exportLog(const QString &format)
+{
+    const QString path = QFileDialog::getSaveFileName(this, "Exporter les mesures", "navigations." + format,
+                                                      format == "csv" ? "CSV (*.csv)" : "JSON (*.json)");
+    if (path.isEmpty()) {
+        return;
+    }
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)
+        || file.write(format == "csv" ? log->toCsv() : log->toJson()) < 0) {
+        QMessageBox::warning(this, "Erreur de fichier", "Impossible d'écrire le fichier : " + file.errorString());
+    }
+}
@@ -0,0 +1,31 @@
+// diagnosticsdialog.h
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+
+class NavigationLog;
+class QLabel;
+class QTableWidget;
+
+// Fenêtre de diagnostic des performances de navigation : centiles par hôte sur les
+// navigations du journal, et export CSV/JSON de toutes les mesures
+class DiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDialog(const NavigationLog *log, QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+private:
+    const NavigationLog *log;
+    QLabel *summaryLabel;
+    QTableWidget *hostTable;
+
+    void exportLog(const QString &format);
+};
+
+#endif // DIAGNOSTICSDIALOG_H
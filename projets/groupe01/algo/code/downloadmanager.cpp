@@ -0,0 +1,589 @@
+// downloadmanager.cpp
+#include "downloadmanager.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QNetworkCookieJar>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+
+namespace {
+const quint32 kStateMagic = 0x49435444; // "ICTD"
+const quint32 kStateVersion = 1;
+const int kMaxRetries = 3;                 // Nouvelles tentatives d'une plage interrompue
+const int kRetryDelayMs = 1000;            // Multiplié par le numéro de la tentative
+const int kProgressIntervalMs = 200;       // Fréquence maximale de downloadChanged pendant un transfert
+const qint64 kStateSaveIntervalMs = 2000;  // Fréquence d'enregistrement de l'avancement
+const qint64 kReadBufferBytes = 512 * 1024; // Octets gardés par QNetworkReply avant de freiner le serveur
+const qint64 kMinSplitBytes = 2 * 1024 * 1024; // Une plage libérée reprend la moitié d'une autre au-delà
+}
+
+DownloadManager::DownloadManager(QObject *parent)
+    : QObject(parent)
+{
+    progressTimer.setSingleShot(true);
+    progressTimer.setInterval(kProgressIntervalMs);
+    connect(&progressTimer, &QTimer::timeout, this, [this]() {
+        const QList<int> ids = progressed;
+        progressed.clear();
+        for (int id : ids) {
+            emit downloadChanged(id);
+        }
+    });
+}
+
+DownloadManager::~DownloadManager()
+{
+    for (Download *d : order) {
+        if (d->info.state == Running) {
+            stopTransfers(d);
+            saveState(d);
+            closeFile(d);
+        }
+    }
+    qDeleteAll(order);
+}
+
+void DownloadManager::setMaxConcurrentDownloads(int count)
+{
+    maxConcurrent = qMax(1, count);
+    schedule();
+}
+
+void DownloadManager::setCookieJar(QNetworkCookieJar *jar)
+{
+    QObject *owner = jar->parent();
+    network.setCookieJar(jar);
+    jar->setParent(owner); // setCookieJar() se l'approprie
+}
+
+int DownloadManager::enqueue(const QUrl &url, const QString &destination)
+{
+    auto *d = new Download;
+    d->info.id = nextId++;
+    d->info.url = url;
+    d->info.destination = destination;
+    order.append(d);
+    emit downloadAdded(d->info.id);
+    schedule();
+    return d->info.id;
+}
+
+void DownloadManager::pause(int id)
+{
+    Download *d = find(id);
+    if (!d || (d->info.state != Running && d->info.state != Queued)) {
+        return;
+    }
+    if (d->info.state == Running) {
+        stopTransfers(d);
+        saveState(d);
+        closeFile(d);
+    }
+    d->info.state = Paused;
+    emit downloadChanged(id);
+    schedule();
+}
+
+void DownloadManager::resume(int id)
+{
+    Download *d = find(id);
+    if (!d || (d->info.state != Paused && d->info.state != Failed)) {
+        return;
+    }
+    d->info.state = Queued;
+    d->info.error.clear();
+    emit downloadChanged(id);
+    schedule();
+}
+
+void DownloadManager::cancel(int id)
+{
+    Download *d = find(id);
+    if (!d || d->info.state == Finished) {
+        return;
+    }
+    stopTransfers(d);
+    closeFile(d);
+    QFile::remove(partPath(d));
+    QFile::remove(statePath(d));
+    d->segments.clear();
+    d->info.receivedBytes = 0;
+    d->info.state = Failed;
+    d->info.error = "Annulé";
+    emit downloadChanged(id);
+    schedule();
+}
+
+void DownloadManager::restoreInterrupted(const QString &directory)
+{
+    const QString suffix = ".part.state";
+    for (const QFileInfo &state : QDir(directory).entryInfoList({"*" + suffix}, QDir::Files, QDir::Time | QDir::Reversed)) {
+        QFile file(state.filePath());
+        quint32 magic = 0;
+        quint32 version = 0;
+        QUrl url;
+        if (file.open(QFile::ReadOnly)) {
+            QDataStream in(&file);
+            in >> magic >> version >> url;
+        }
+        const QString destination = state.filePath().chopped(suffix.size());
+        if (magic != kStateMagic || version != kStateVersion || !url.isValid() || find(destination)) {
+            continue;
+        }
+        auto *d = new Download;
+        d->info.id = nextId++;
+        d->info.url = url;
+        d->info.destination = destination;
+        d->info.state = Paused;
+        if (loadState(d)) {
+            order.append(d);
+            emit downloadAdded(d->info.id);
+        } else {
+            delete d;
+        }
+    }
+}
+
+int DownloadManager::findUnfinished(const QUrl &url) const
+{
+    for (const Download *d : order) {
+        if (d->info.url == url && d->info.state != Finished) {
+            return d->info.id;
+        }
+    }
+    return 0;
+}
+
+QList<int> DownloadManager::downloads() const
+{
+    QList<int> ids;
+    for (const Download *d : order) {
+        ids.append(d->info.id);
+    }
+    return ids;
+}
+
+DownloadManager::Info DownloadManager::info(int id) const
+{
+    const Download *d = find(id);
+    return d ? d->info : Info();
+}
+
+DownloadManager::Download *DownloadManager::find(int id) const
+{
+    for (Download *d : order) {
+        if (d->info.id == id) {
+            return d;
+        }
+    }
+    return nullptr;
+}
+
+DownloadManager::Download *DownloadManager::find(const QString &destination) const
+{
+    for (Download *d : order) {
+        if (d->info.destination == destination) {
+            return d;
+        }
+    }
+    return nullptr;
+}
+
+// Démarre les téléchargements en file, dans l'ordre, tant que la limite le permet
+void DownloadManager::schedule()
+{
+    int running = 0;
+    for (const Download *d : order) {
+        running += d->info.state == Running ? 1 : 0;
+    }
+    for (Download *d : order) {
+        if (running >= maxConcurrent) {
+            break;
+        }
+        if (d->info.state == Queued) {
+            start(d);
+            ++running;
+        }
+    }
+}
+
+void DownloadManager::start(Download *d)
+{
+    d->info.state = Running;
+    d->info.error.clear();
+    emit downloadChanged(d->info.id);
+
+    // Reprise d'un fichier partiel : les plages continuent là où elles s'étaient arrêtées
+    if (loadState(d) && openPartialFile(d)) {
+        for (int i = 0; i < d->segments.size(); ++i) {
+            if (d->segments[i].next < d->segments[i].end) {
+                startSegment(d, i);
+            }
+        }
+        return;
+    }
+
+    // Sinon, HEAD : taille, prise en charge des plages et validateur du fichier
+    d->segments.clear();
+    d->info.receivedBytes = 0;
+    QNetworkRequest request(d->info.url);
+    d->probe = network.head(request);
+    connect(d->probe, &QNetworkReply::finished, this, [this, d]() { onProbeFinished(d); });
+}
+
+void DownloadManager::onProbeFinished(Download *d)
+{
+    QNetworkReply *reply = d->probe;
+    d->probe = nullptr;
+    reply->deleteLater();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError && status != 405 && status != 501) {
+        fail(d, reply->errorString());
+        return;
+    }
+
+    // Serveur sans HEAD (405/501) : taille inconnue, une seule plage sans reprise possible
+    const bool known = reply->error() == QNetworkReply::NoError && reply->hasRawHeader("Content-Length");
+    d->info.totalBytes = known ? reply->header(QNetworkRequest::ContentLengthHeader).toLongLong() : -1;
+    d->acceptsRanges = !d->rangesRefused && known && reply->rawHeader("Accept-Ranges").trimmed().toLower() == "bytes";
+    d->validator = reply->rawHeader("ETag");
+    if (d->validator.isEmpty()) {
+        d->validator = reply->rawHeader("Last-Modified");
+    }
+
+    const qint64 total = d->info.totalBytes;
+    const int count = (d->acceptsRanges && total >= segmentThreshold) ? maxSegments : 1;
+    d->segments.resize(count);
+    for (int i = 0; i < count; ++i) {
+        Segment &s = d->segments[i];
+        s.start = s.next = total < 0 ? 0 : total * i / count;
+        s.end = total < 0 ? -1 : total * (i + 1) / count;
+    }
+    d->info.segments = count;
+
+    QFile::remove(partPath(d));
+    if (!openPartialFile(d)) {
+        fail(d, "Impossible de créer " + partPath(d));
+        return;
+    }
+    if (total == 0) {
+        complete(d);
+        return;
+    }
+    saveState(d);
+    for (int i = 0; i < count; ++i) {
+        startSegment(d, i);
+    }
+}
+
+// Crée (ou rouvre) le fichier partiel à sa taille finale et le projette en mémoire
+bool DownloadManager::openPartialFile(Download *d)
+{
+    d->file.setFileName(partPath(d));
+    if (!d->file.open(QFile::ReadWrite)) {
+        return false;
+    }
+    const qint64 total = d->info.totalBytes;
+    if (total > 0) {
+        if (d->file.size() != total && !d->file.resize(total)) {
+            d->file.close();
+            return false;
+        }
+        d->map = d->file.map(0, total); // Échec possible (espace d'adressage) : on écrira par write()
+    }
+    return true;
+}
+
+void DownloadManager::startSegment(Download *d, int index)
+{
+    Segment &s = d->segments[index];
+    QNetworkRequest request(d->info.url);
+    s.ranged = d->acceptsRanges && (s.next > 0 || s.end < d->info.totalBytes);
+    s.checked = false;
+    if (s.ranged) {
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(s.next) + '-' + QByteArray::number(s.end - 1));
+        if (!d->validator.isEmpty()) {
+            request.setRawHeader("If-Range", d->validator); // Fichier modifié : le serveur renvoie tout (200)
+        }
+    }
+    QNetworkReply *reply = network.get(request);
+    reply->setReadBufferSize(kReadBufferBytes);
+    s.reply = reply;
+    connect(reply, &QNetworkReply::readyRead, this, [this, d, index]() { onSegmentData(d, index); });
+    connect(reply, &QNetworkReply::finished, this, [this, d, index]() { onSegmentFinished(d, index); });
+}
+
+void DownloadManager::onSegmentData(Download *d, int index)
+{
+    QNetworkReply *reply = d->segments[index].reply;
+    if (!reply) {
+        return;
+    }
+    Segment &s = d->segments[index];
+    if (!s.checked && reply->bytesAvailable() > 0) {
+        // Aucun octet n'est écrit avant d'avoir vérifié qu'il est bien à sa place : 206 dont la
+        // plage commence à s.next, ou 200 pour une requête sans Range partie du début
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status == 200 && (s.ranged || s.next > 0 || d->segments.size() > 1)) {
+            // Plage refusée ou fichier modifié depuis le début du téléchargement : on recommence,
+            // en une seule plage. Un serveur qui annonce Accept-Ranges sans honorer Range ferait
+            // sinon recommencer le téléchargement indéfiniment.
+            d->rangesRefused = true;
+            d->acceptsRanges = false;
+            stopTransfers(d);
+            closeFile(d);
+            QFile::remove(statePath(d));
+            start(d);
+            return;
+        }
+        bool valid = status == 200;
+        if (status == 206 && s.ranged) {
+            const QByteArray range = reply->rawHeader("Content-Range").trimmed();
+            const int dash = range.indexOf('-');
+            bool ok = false;
+            const qint64 first = range.startsWith("bytes ") && dash > 6
+                ? range.mid(6, dash - 6).trimmed().toLongLong(&ok) : -1;
+            valid = ok && first == s.next;
+        }
+        if (!valid) {
+            reply->disconnect(this);
+            reply->abort();
+            reply->deleteLater();
+            s.reply = nullptr;
+            retrySegment(d, index, QString("Réponse inattendue du serveur (HTTP %1)").arg(status));
+            return;
+        }
+        s.checked = true;
+    }
+
+    while (reply->bytesAvailable() > 0) {
+        const qint64 room = s.end < 0 ? reply->bytesAvailable() : s.end - s.next;
+        if (room <= 0) {
+            break;
+        }
+        qint64 read;
+        if (d->map) {
+            read = reply->read(reinterpret_cast<char *>(d->map + s.next), qMin(room, reply->bytesAvailable()));
+        } else {
+            const QByteArray chunk = reply->read(qMin(room, reply->bytesAvailable()));
+            read = chunk.size();
+            if (!d->file.seek(s.next) || d->file.write(chunk) != read) {
+                fail(d, d->file.errorString());
+                return;
+            }
+        }
+        if (read <= 0) {
+            break;
+        }
+        s.next += read;
+        d->info.receivedBytes += read;
+    }
+    reportProgress(d);
+
+    // Plage écourtée par un partage (voir onSegmentFinished) : la suite appartient à une autre
+    if (s.end >= 0 && s.next >= s.end) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+        s.reply = nullptr;
+        onSegmentFinished(d, index);
+    }
+}
+
+void DownloadManager::onSegmentFinished(Download *d, int index)
+{
+    if (QNetworkReply *reply = d->segments[index].reply) {
+        onSegmentData(d, index); // Derniers octets éventuels
+        if (d->info.state != Running || index >= d->segments.size() || d->segments[index].reply != reply) {
+            return; // Redémarré, échoué, ou déjà traité par onSegmentData
+        }
+        Segment &s = d->segments[index];
+        s.reply = nullptr;
+        reply->deleteLater();
+        if (s.end < 0 && reply->error() == QNetworkReply::NoError) {
+            s.end = s.next; // Taille inconnue : la fin de la réponse est la fin du fichier
+            d->info.totalBytes = s.next;
+        }
+        if (reply->error() != QNetworkReply::NoError || s.next < s.end) {
+            retrySegment(d, index, reply->errorString());
+            return;
+        }
+    }
+
+    // Plage terminée : elle reprend la seconde moitié de la plus grosse plage restante, pour que
+    // toutes les connexions travaillent jusqu'au bout au lieu d'attendre la plus lente
+    int largest = -1;
+    for (int i = 0; i < d->segments.size(); ++i) {
+        const Segment &other = d->segments[i];
+        if (other.reply && other.end - other.next > kMinSplitBytes
+            && (largest < 0 || other.end - other.next > d->segments[largest].end - d->segments[largest].next)) {
+            largest = i;
+        }
+    }
+    if (largest >= 0 && d->acceptsRanges) {
+        Segment &victim = d->segments[largest];
+        Segment half;
+        half.start = half.next = victim.next + (victim.end - victim.next) / 2;
+        half.end = victim.end;
+        victim.end = half.start;
+        d->segments.append(half);
+        d->info.segments = d->segments.size();
+        saveState(d);
+        startSegment(d, d->segments.size() - 1);
+        return;
+    }
+
+    for (const Segment &other : d->segments) {
+        if (other.reply || other.next < other.end) {
+            return; // D'autres plages sont en cours (ou en attente d'une nouvelle tentative)
+        }
+    }
+    complete(d);
+}
+
+// Plage interrompue ou réponse inutilisable : nouvelle tentative après un délai croissant
+void DownloadManager::retrySegment(Download *d, int index, const QString &error)
+{
+    Segment &s = d->segments[index];
+    if (s.end < 0 || ++s.retries > kMaxRetries) {
+        fail(d, error);
+        return;
+    }
+    QTimer::singleShot(kRetryDelayMs * s.retries, this, [this, d, index]() {
+        if (d->info.state == Running && !d->segments[index].reply) {
+            startSegment(d, index);
+        }
+    });
+}
+
+void DownloadManager::complete(Download *d)
+{
+    closeFile(d);
+    QFile::remove(d->info.destination);
+    if (!QFile::rename(partPath(d), d->info.destination)) {
+        fail(d, "Impossible de renommer " + partPath(d));
+        return;
+    }
+    QFile::remove(statePath(d));
+    d->info.state = Finished;
+    d->info.receivedBytes = d->info.totalBytes;
+    emit downloadChanged(d->info.id);
+    schedule();
+}
+
+void DownloadManager::fail(Download *d, const QString &error)
+{
+    stopTransfers(d);
+    saveState(d); // Le fichier partiel reste : resume() reprendra à partir de là
+    closeFile(d);
+    d->info.state = Failed;
+    d->info.error = error;
+    emit downloadChanged(d->info.id);
+    schedule();
+}
+
+void DownloadManager::stopTransfers(Download *d)
+{
+    QList<QNetworkReply *> replies;
+    if (d->probe) {
+        replies.append(d->probe);
+        d->probe = nullptr;
+    }
+    for (Segment &s : d->segments) {
+        if (s.reply) {
+            replies.append(s.reply);
+            s.reply = nullptr;
+        }
+    }
+    for (QNetworkReply *reply : replies) {
+        reply->disconnect(this); // abort() émet finished : il ne doit plus rien déclencher ici
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void DownloadManager::closeFile(Download *d)
+{
+    if (d->map) {
+        d->file.unmap(d->map);
+        d->map = nullptr;
+    }
+    d->file.close();
+}
+
+// Avancement des plages, pour reprendre après une pause ou un redémarrage du navigateur.
+// Les octets projetés sont écrits sur disque par le système même en cas d'arrêt brutal
+// de l'application ; seule une coupure de courant peut laisser l'état en avance sur le fichier.
+void DownloadManager::saveState(Download *d)
+{
+    if (!d->acceptsRanges || d->info.totalBytes <= 0 || d->segments.isEmpty()) {
+        return; // Sans plages, un téléchargement interrompu ne peut que recommencer
+    }
+    QSaveFile file(statePath(d));
+    if (!file.open(QFile::WriteOnly)) {
+        return;
+    }
+    QDataStream out(&file);
+    out << kStateMagic << kStateVersion << d->info.url << d->info.totalBytes << d->validator
+        << qint32(d->segments.size());
+    for (const Segment &s : d->segments) {
+        out << s.start << s.end << s.next;
+    }
+    file.commit();
+    d->lastStateSave.start();
+}
+
+bool DownloadManager::loadState(Download *d)
+{
+    QFile file(statePath(d));
+    if (!file.open(QFile::ReadOnly) || QFileInfo(partPath(d)).size() <= 0) {
+        return false;
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QUrl url;
+    qint64 total = 0;
+    QByteArray validator;
+    qint32 count = 0;
+    in >> magic >> version >> url >> total >> validator >> count;
+    if (in.status() != QDataStream::Ok || magic != kStateMagic || version != kStateVersion || url != d->info.url
+        || total <= 0 || count <= 0 || count > 1024 || QFileInfo(partPath(d)).size() != total) {
+        return false;
+    }
+    QVector<Segment> segments(count);
+    qint64 received = 0;
+    for (Segment &s : segments) {
+        in >> s.start >> s.end >> s.next;
+        if (s.start < 0 || s.start > s.next || s.next > s.end || s.end > total) {
+            return false;
+        }
+        received += s.next - s.start;
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+    d->info.totalBytes = total;
+    d->info.receivedBytes = received;
+    d->info.segments = count;
+    d->validator = validator;
+    d->acceptsRanges = true;
+    d->segments = segments;
+    return true;
+}
+
+void DownloadManager::reportProgress(Download *d)
+{
+    if (!progressed.contains(d->info.id)) {
+        progressed.append(d->info.id);
+    }
+    if (!progressTimer.isActive()) {
+        progressTimer.start();
+    }
+    if (!d->lastStateSave.isValid() || d->lastStateSave.elapsed() >= kStateSaveIntervalMs) {
+        saveState(d);
+    }
+}
@@ -0,0 +1,128 @@
+// downloadmanager.h
+#ifndef DOWNLOADMANAGER_H
+#define DOWNLOADMANAGER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+
+class QNetworkCookieJar;
+class QNetworkReply;
+
+// Gestionnaire de téléchargements : file d'attente, nombre limité de téléchargements
+// simultanés, et gros fichiers découpés en plages d'octets (Range) téléchargées en parallèle.
+//
+// Le fichier <destination>.part est créé à sa taille finale puis projeté en mémoire : chaque
+// plage lit les octets reçus directement à leur place dans le fichier (pas de tampon
+// intermédiaire à recopier). L'avancement des plages est noté dans <destination>.part.state ;
+// un téléchargement interrompu (pause, fermeture, plantage) reprend là où il s'était arrêté,
+// si le serveur confirme par If-Range que le fichier n'a pas changé.
+// Les requêtes partent avec les cookies du profil web (setCookieJar) : un fichier réservé à
+// une session ouverte est téléchargé au nom de cette session.
+// Tout vit dans le thread graphique : les transferts sont asynchrones (QNetworkAccessManager).
+class DownloadManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State { Queued, Running, Paused, Finished, Failed };
+
+    struct Info {
+        int id = 0;
+        QUrl url;
+        QString destination;
+        State state = Queued;
+        qint64 totalBytes = -1; // -1 : taille inconnue
+        qint64 receivedBytes = 0;
+        int segments = 0;
+        QString error;
+    };
+
+    explicit DownloadManager(QObject *parent = nullptr);
+    ~DownloadManager(); // Enregistre l'avancement des téléchargements en cours
+
+    void setMaxConcurrentDownloads(int count);
+    void setMaxSegments(int count) { maxSegments = qMax(1, count); }
+    // Taille à partir de laquelle un fichier est découpé en plusieurs plages
+    void setSegmentThreshold(qint64 bytes) { segmentThreshold = bytes; }
+    // Pot de cookies partagé avec d'autres gestionnaires : il garde son parent
+    void setCookieJar(QNetworkCookieJar *jar);
+
+    // Ajoute un téléchargement ; renvoie son identifiant
+    int enqueue(const QUrl &url, const QString &destination);
+    void pause(int id);
+    void resume(int id);
+    void cancel(int id); // Supprime aussi le fichier partiel
+    // Retrouve les téléchargements interrompus d'un dossier (fichiers .part.state), en pause
+    void restoreInterrupted(const QString &directory);
+
+    QList<int> downloads() const;
+    int findUnfinished(const QUrl &url) const; // 0 si aucun
+    Info info(int id) const;
+
+signals:
+    void downloadAdded(int id);
+    void downloadChanged(int id); // État ou progression (au plus toutes les kProgressIntervalMs)
+
+private:
+    struct Segment {
+        qint64 start = 0;
+        qint64 end = 0;     // Exclu ; -1 : jusqu'à la fin (taille inconnue)
+        qint64 next = 0;    // Prochain octet attendu
+        int retries = 0;
+        bool ranged = false;  // La requête en cours porte un en-tête Range
+        bool checked = false; // Statut et Content-Range de la réponse en cours vérifiés
+        QPointer<QNetworkReply> reply;
+    };
+
+    struct Download {
+        Info info;
+        QByteArray validator; // ETag (ou Last-Modified) : le fichier partiel lui correspond
+        bool acceptsRanges = false;
+        bool rangesRefused = false; // 200 reçu pour une plage : Accept-Ranges n'est plus cru
+        QVector<Segment> segments;
+        QFile file;
+        uchar *map = nullptr; // Fichier projeté (nullptr : écriture par QFile::write)
+        QPointer<QNetworkReply> probe;
+        QElapsedTimer lastStateSave;
+    };
+
+    QNetworkAccessManager network;
+    QList<Download *> order; // Ordre d'ajout : c'est aussi l'ordre de la file
+    int nextId = 1;
+    int maxConcurrent = 3;
+    int maxSegments = 4;
+    qint64 segmentThreshold = 4 * 1024 * 1024;
+    QTimer progressTimer;
+    QList<int> progressed; // Téléchargements dont la progression n'a pas encore été signalée
+
+    Download *find(int id) const;
+    Download *find(const QString &destination) const;
+    void schedule();
+    void start(Download *d);
+    void onProbeFinished(Download *d);
+    bool openPartialFile(Download *d);
+    void startSegment(Download *d, int index);
+    void onSegmentData(Download *d, int index);
+    void onSegmentFinished(Download *d, int index);
+    void retrySegment(Download *d, int index, const QString &error);
+    void complete(Download *d);
+    void fail(Download *d, const QString &error);
+    void stopTransfers(Download *d);
+    void closeFile(Download *d);
+    bool loadState(Download *d);
+    void saveState(Download *d);
+    void reportProgress(Download *d);
+
+    static QString partPath(const Download *d) { return d->info.destination + ".part"; }
+    static QString statePath(const Download *d) { return d->info.destination + ".part.state"; }
+};
+
+#endif // DOWNLOADMANAGER_H
@@ -0,0 +1,116 @@
+// downloadsdialog.cpp
+#include "downloadsdialog.h"
+
+#include <QDesktopServices>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QUrl>
+#include <QVBoxLayout>
+
+#include "downloadmanager.h"
+
+namespace {
+
+QString stateText(const DownloadManager::Info &info)
+{
+    switch (info.state) {
+    case DownloadManager::Queued:
+        return "En attente";
+    case DownloadManager::Running:
+        return info.segments > 1 ? QString("En cours (%1 plages)").arg(info.segments) : QString("En cours");
+    case DownloadManager::Paused:
+        return "En pause";
+    case DownloadManager::Finished:
+        return "Terminé";
+    case DownloadManager::Failed:
+        return "Échec : " + info.error;
+    }
+    return QString();
+}
+
+QString sizeText(qint64 bytes)
+{
+    return bytes < 0 ? QString("?") : QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + " Mio";
+}
+
+} // namespace
+
+DownloadsDialog::DownloadsDialog(DownloadManager *manager, QWidget *parent)
+    : QDialog(parent)
+    , manager(manager)
+    , table(new QTableWidget(0, 3, this))
+{
+    setWindowTitle("Téléchargements");
+    resize(700, 350);
+
+    table->setHorizontalHeaderLabels({"Fichier", "Progression", "État"});
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->verticalHeader()->hide();
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    auto *pauseButton = new QPushButton("Pause", this);
+    auto *resumeButton = new QPushButton("Reprendre", this);
+    auto *cancelButton = new QPushButton("Annuler", this);
+    auto *openButton = new QPushButton("Ouvrir le dossier", this);
+    connect(pauseButton, &QPushButton::clicked, this, [this]() { this->manager->pause(selectedId()); });
+    connect(resumeButton, &QPushButton::clicked, this, [this]() { this->manager->resume(selectedId()); });
+    connect(cancelButton, &QPushButton::clicked, this, [this]() { this->manager->cancel(selectedId()); });
+    connect(openButton, &QPushButton::clicked, this, [this]() {
+        const DownloadManager::Info info = this->manager->info(selectedId());
+        if (info.id) {
+            QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(info.destination).absolutePath()));
+        }
+    });
+
+    auto *buttons = new QHBoxLayout;
+    buttons->addWidget(pauseButton);
+    buttons->addWidget(resumeButton);
+    buttons->addWidget(cancelButton);
+    buttons->addStretch();
+    buttons->addWidget(openButton);
+    auto *layout = new QVBoxLayout(this);
+    layout->addWidget(table);
+    layout->addLayout(buttons);
+
+    for (int id : manager->downloads()) {
+        updateRow(id);
+    }
+    connect(manager, &DownloadManager::downloadAdded, this, &DownloadsDialog::updateRow);
+    connect(manager, &DownloadManager::downloadChanged, this, &DownloadsDialog::updateRow);
+}
+
+// Une ligne par téléchargement, dans l'ordre d'ajout ; l'identifiant est gardé dans la première colonne
+void DownloadsDialog::updateRow(int id)
+{
+    const DownloadManager::Info info = manager->info(id);
+    int row = 0;
+    while (row < table->rowCount() && table->item(row, 0)->data(Qt::UserRole).toInt() != id) {
+        ++row;
+    }
+    if (row == table->rowCount()) {
+        table->insertRow(row);
+        auto *name = new QTableWidgetItem(QFileInfo(info.destination).fileName());
+        name->setData(Qt::UserRole, id);
+        name->setToolTip(info.url.toString());
+        table->setItem(row, 0, name);
+        table->setItem(row, 1, new QTableWidgetItem);
+        table->setItem(row, 2, new QTableWidgetItem);
+    }
+    QString progress = sizeText(info.receivedBytes) + " / " + sizeText(info.totalBytes);
+    if (info.totalBytes > 0) {
+        progress += QString(" (%1 %)").arg(info.receivedBytes * 100 / info.totalBytes);
+    }
+    table->item(row, 1)->setText(progress);
+    table->item(row, 2)->setText(stateText(info));
+}
+
+int DownloadsDialog::selectedId() const
+{
+    const QList<QTableWidgetItem *> selected = table->selectedItems();
+    return selected.isEmpty() ? 0 : table->item(selected.first()->row(), 0)->data(Qt::UserRole).toInt();
+}
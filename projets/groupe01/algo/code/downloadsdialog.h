@@ -0,0 +1,26 @@
+// downloadsdialog.h
+#ifndef DOWNLOADSDIALOG_H
+#define DOWNLOADSDIALOG_H
+
+#include <QDialog>
+
+class DownloadManager;
+class QTableWidget;
+
+// Liste des téléchargements avec leur progression ; pause, reprise et annulation de la ligne choisie
+class DownloadsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DownloadsDialog(DownloadManager *manager, QWidget *parent = nullptr);
+
+private:
+    DownloadManager *manager;
+    QTableWidget *table;
+
+    void updateRow(int id);
+    int selectedId() const;
+};
+
+#endif // DOWNLOADSDIALOG_H
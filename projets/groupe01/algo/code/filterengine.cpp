@@ -0,0 +1,830 @@
+// filterengine.cpp
+#include "filterengine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+const uint32_t kFileMagic = 0x46544349; // "ICTF"
+const uint32_t kFileVersion = 1;
+const size_t kMinKeyLength = 3;  // En dessous, un littéral trouverait des candidats dans presque toute URL
+const size_t kMaxKeyLength = 20; // Au-delà, la clé n'est pas plus sélective mais l'automate grossit
+const size_t kDenseTableBytes = 512 * 1024; // Lignes complètes des premiers états : tient dans le cache L2
+
+char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string lowered(std::string_view s)
+{
+    std::string out(s.size(), '\0');
+    std::transform(s.begin(), s.end(), out.begin(), asciiLower);
+    return out;
+}
+
+bool startsWith(std::string_view s, std::string_view prefix)
+{
+    return s.substr(0, prefix.size()) == prefix;
+}
+
+// "^" : tout caractère sauf lettre, chiffre et _ - . %
+bool isSeparator(char c)
+{
+    const unsigned char u = static_cast<unsigned char>(c);
+    return !(std::isalnum(u) || c == '_' || c == '-' || c == '.' || c == '%' || u >= 0x80);
+}
+
+// FNV-1a sur les octets pris de la fin vers le début : en un seul passage à rebours sur
+// l'hôte, on obtient le hachage de chacun de ses suffixes ("b.c", puis "a.b.c"...)
+const uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+uint64_t hashStep(uint64_t h, char c)
+{
+    return (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+}
+
+uint64_t finalHash(uint64_t h)
+{
+    return h | 1; // 0 est réservé aux cases vides
+}
+
+uint64_t hashOf(std::string_view s)
+{
+    uint64_t h = kHashSeed;
+    for (size_t i = s.size(); i-- > 0;) {
+        h = hashStep(h, s[i]);
+    }
+    return finalHash(h);
+}
+
+// Hôte de l'URL : position et longueur (sans identifiants ni port), en un seul passage
+void hostOf(std::string_view url, size_t &start, size_t &length)
+{
+    // Le schéma est court ("http", "https", "wss"...) : inutile de chercher "://" plus loin
+    const size_t scheme = url.substr(0, 16).find("://");
+    start = scheme == std::string_view::npos ? 0 : scheme + 3;
+    size_t end = start;
+    size_t colon = std::string_view::npos;
+    for (; end < url.size(); ++end) {
+        const char c = url[end];
+        if (c == '/' || c == '?' || c == '#') {
+            break;
+        }
+        if (c == '@') {
+            start = end + 1; // Identifiants "utilisateur:mot-de-passe@"
+            colon = std::string_view::npos;
+        } else if (c == ':' && colon == std::string_view::npos) {
+            colon = end;
+        }
+    }
+    length = (colon == std::string_view::npos ? end : colon) - start;
+}
+
+// Domaine "enregistrable" approché par les deux derniers labels (sans liste des suffixes publics)
+std::string_view baseDomain(std::string_view host)
+{
+    const size_t last = host.rfind('.');
+    if (last == std::string_view::npos || last == 0) {
+        return host;
+    }
+    const size_t previous = host.rfind('.', last - 1);
+    return previous == std::string_view::npos ? host : host.substr(previous + 1);
+}
+
+bool domainMatches(std::string_view host, std::string_view domain)
+{
+    if (host.size() < domain.size() || host.substr(host.size() - domain.size()) != domain) {
+        return false;
+    }
+    return host.size() == domain.size() || host[host.size() - domain.size() - 1] == '.';
+}
+
+// Motif avec "*" (toute suite) et "^" (séparateur ou fin de l'URL).
+// floating : le motif peut commencer n'importe où ; anchoredEnd : il doit finir l'URL.
+bool globMatch(std::string_view pattern, std::string_view text, bool floating, bool anchoredEnd)
+{
+    size_t p = 0;
+    size_t t = 0;
+    size_t starP = floating ? 0 : std::string_view::npos;
+    size_t starT = 0;
+    for (;;) {
+        if (p < pattern.size()) {
+            const char pc = pattern[p];
+            if (pc == '*') {
+                starP = ++p;
+                starT = t;
+                continue;
+            }
+            if (t < text.size() && (pc == '^' ? isSeparator(text[t]) : pc == text[t])) {
+                ++p;
+                ++t;
+                continue;
+            }
+            if (t == text.size() && pc == '^') {
+                ++p;
+                continue;
+            }
+        } else if (!anchoredEnd || t == text.size()) {
+            return true;
+        }
+        // Échec : on relance depuis le dernier "*" en lui faisant absorber un caractère de plus
+        if (starP == std::string_view::npos || starT >= text.size()) {
+            return false;
+        }
+        p = starP;
+        t = ++starT;
+    }
+}
+
+// Plus long littéral du motif : la clé de la règle dans l'automate
+std::string_view longestLiteral(std::string_view pattern)
+{
+    std::string_view best;
+    size_t start = 0;
+    while (start <= pattern.size()) {
+        size_t end = pattern.find_first_of("*^|", start);
+        if (end == std::string_view::npos) {
+            end = pattern.size();
+        }
+        if (end - start > best.size()) {
+            best = pattern.substr(start, end - start);
+        }
+        start = end + 1;
+    }
+    return best.substr(0, kMaxKeyLength);
+}
+
+uint16_t typeByName(std::string_view name)
+{
+    static const struct {
+        const char *name;
+        uint16_t type;
+    } types[] = {
+        {"other", FilterEngine::Other},
+        {"script", FilterEngine::Script},
+        {"image", FilterEngine::Image},
+        {"stylesheet", FilterEngine::Stylesheet},
+        {"css", FilterEngine::Stylesheet},
+        {"object", FilterEngine::Object},
+        {"object-subrequest", FilterEngine::Object},
+        {"subdocument", FilterEngine::Subdocument},
+        {"frame", FilterEngine::Subdocument},
+        {"xmlhttprequest", FilterEngine::XmlHttpRequest},
+        {"xhr", FilterEngine::XmlHttpRequest},
+        {"websocket", FilterEngine::WebSocket},
+        {"font", FilterEngine::Font},
+        {"media", FilterEngine::Media},
+        {"ping", FilterEngine::Ping},
+    };
+    for (const auto &t : types) {
+        if (name == t.name) {
+            return t.type;
+        }
+    }
+    return 0;
+}
+
+template <typename T>
+void writeVector(std::ofstream &out, const std::vector<T> &v)
+{
+    const uint64_t count = v.size();
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(v.data()), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+template <typename T>
+bool readVector(std::ifstream &in, std::vector<T> &v)
+{
+    uint64_t count = 0;
+    if (!in.read(reinterpret_cast<char *>(&count), sizeof(count)) || count > (uint64_t(1) << 32)) {
+        return false;
+    }
+    v.resize(count);
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(v.data()), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+} // namespace
+
+size_t FilterEngine::addList(std::string_view text)
+{
+    size_t added = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        added += addRule(text.substr(start, end - start)) ? 1 : 0;
+        start = end + 1;
+    }
+    return added;
+}
+
+bool FilterEngine::addRule(std::string_view line)
+{
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) {
+        line.remove_prefix(1);
+    }
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+        line.remove_suffix(1);
+    }
+    if (line.empty() || line[0] == '!' || line[0] == '[') {
+        return false; // Commentaire ou en-tête "[Adblock Plus 2.0]"
+    }
+    // Règles d'affichage (masquage d'éléments) : hors du périmètre d'un filtre de requêtes
+    if (line.find("##") != std::string_view::npos || line.find("#@#") != std::string_view::npos
+        || line.find("#?#") != std::string_view::npos || line.find("#$#") != std::string_view::npos) {
+        ++ignored;
+        return false;
+    }
+
+    PendingRule rule;
+    const bool exception = startsWith(line, "@@");
+    if (exception) {
+        line.remove_prefix(2);
+    }
+
+    // Options "$opt1,~opt2,domain=a.com|~b.com"
+    const size_t dollar = line.rfind('$');
+    if (dollar != std::string_view::npos) {
+        const std::string options = lowered(line.substr(dollar + 1));
+        line = line.substr(0, dollar);
+        uint16_t included = 0;
+        uint16_t excluded = 0;
+        for (size_t start = 0; start < options.size();) {
+            size_t comma = options.find(',', start);
+            if (comma == std::string::npos) {
+                comma = options.size();
+            }
+            std::string_view option(options.data() + start, comma - start);
+            start = comma + 1;
+            const bool negated = startsWith(option, "~");
+            if (negated) {
+                option.remove_prefix(1);
+            }
+
+            if (option == "third-party" || option == "3p") {
+                rule.flags |= negated ? FirstParty : ThirdParty;
+            } else if (option == "first-party" || option == "1p") {
+                rule.flags |= negated ? ThirdParty : FirstParty;
+            } else if (option == "match-case") {
+                // Ignorée : URL et motifs sont comparés en minuscules
+            } else if (!negated && startsWith(option, "domain=")) {
+                option.remove_prefix(7);
+                for (size_t from = 0; from < option.size();) {
+                    size_t bar = option.find('|', from);
+                    if (bar == std::string_view::npos) {
+                        bar = option.size();
+                    }
+                    std::string_view domain = option.substr(from, bar - from);
+                    from = bar + 1;
+                    const bool excludedDomain = startsWith(domain, "~");
+                    if (excludedDomain) {
+                        domain.remove_prefix(1);
+                    }
+                    if (!domain.empty()) {
+                        rule.domains.emplace_back(std::string(domain), excludedDomain);
+                    }
+                }
+            } else if (const uint16_t type = typeByName(option)) {
+                (negated ? excluded : included) |= type;
+            } else {
+                // document, popup, csp=, redirect=... : un sens que ce moteur ne sait pas appliquer
+                ++ignored;
+                return false;
+            }
+        }
+        rule.types = static_cast<uint16_t>((included ? included : kAllTypes) & ~excluded);
+        if (rule.types == 0) {
+            ++ignored;
+            return false;
+        }
+    }
+
+    // "/.../" est une expression régulière ; sans métacaractère ("/banner/"), c'est un simple littéral
+    if (line.size() > 2 && line.front() == '/' && line.back() == '/'
+        && line.substr(1, line.size() - 2).find_first_of("\\^$*+?()[]{}|") != std::string_view::npos) {
+        ++ignored;
+        return false;
+    }
+
+    std::string pattern = lowered(line);
+    if (startsWith(pattern, "||")) {
+        rule.flags |= HostAnchor;
+        pattern.erase(0, 2);
+    } else if (startsWith(pattern, "|")) {
+        rule.flags |= StartAnchor;
+        pattern.erase(0, 1);
+    }
+    if (!pattern.empty() && pattern.back() == '|') {
+        rule.flags |= EndAnchor;
+        pattern.pop_back();
+    }
+    pattern.erase(std::unique(pattern.begin(), pattern.end(),
+                              [](char a, char b) { return a == '*' && b == '*'; }),
+                  pattern.end());
+    if (!pattern.empty() && pattern.back() == '*') {
+        pattern.pop_back();
+        rule.flags &= ~EndAnchor;
+    }
+    if (!pattern.empty() && pattern.front() == '*') {
+        pattern.erase(0, 1);
+        rule.flags &= ~(HostAnchor | StartAnchor);
+    }
+    if (pattern.find_first_of(" |") != std::string::npos) {
+        ++ignored;
+        return false;
+    }
+
+    // "||domaine^" : l'essentiel des listes, servi par la table des domaines
+    if ((rule.flags & HostAnchor) && !(rule.flags & EndAnchor) && pattern.size() > 1 && pattern.back() == '^'
+        && pattern.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789.-") == pattern.size() - 1
+        && pattern.front() != '.') {
+        pattern.pop_back();
+        rule.domainOnly = true;
+    }
+
+    rule.pattern = std::move(pattern);
+    (exception ? pendingAllow : pendingBlock).push_back(std::move(rule));
+    return true;
+}
+
+void FilterEngine::compile()
+{
+    build(block, pendingBlock);
+    build(allow, pendingAllow);
+    std::vector<PendingRule>().swap(pendingBlock);
+    std::vector<PendingRule>().swap(pendingAllow);
+}
+
+void FilterEngine::build(Matcher &matcher, std::vector<PendingRule> &pending)
+{
+    matcher = Matcher();
+    std::vector<std::pair<std::string_view, uint32_t>> keys;   // (littéral, règle)
+    std::vector<std::pair<uint64_t, uint32_t>> domainEntries; // (hachage du domaine, règle)
+
+    for (const PendingRule &p : pending) {
+        Rule rule;
+        rule.pattern = static_cast<uint32_t>(matcher.pool.size());
+        rule.patternLength = static_cast<uint32_t>(p.pattern.size());
+        matcher.pool += p.pattern;
+        rule.domains = static_cast<uint32_t>(matcher.domainOptions.size());
+        rule.domainCount = static_cast<uint16_t>(std::min<size_t>(p.domains.size(), 0xFFFF));
+        for (size_t i = 0; i < rule.domainCount; ++i) {
+            const auto &domain = p.domains[i];
+            matcher.domainOptions.push_back(DomainOption{static_cast<uint32_t>(matcher.pool.size()),
+                                                         static_cast<uint16_t>(domain.first.size()),
+                                                         static_cast<uint8_t>(domain.second)});
+            matcher.pool += domain.first;
+        }
+        rule.types = p.types;
+        rule.flags = p.flags;
+
+        const uint32_t id = static_cast<uint32_t>(matcher.rules.size());
+        matcher.rules.push_back(rule);
+        if (p.domainOnly) {
+            domainEntries.emplace_back(hashOf(p.pattern), id);
+            continue;
+        }
+        const std::string_view key = longestLiteral(p.pattern);
+        if (key.size() < kMinKeyLength) {
+            matcher.genericRules.push_back(id);
+        } else {
+            keys.emplace_back(key, id);
+        }
+    }
+
+    // Table des domaines : les règles d'un même domaine sont contiguës dans domainRules
+    std::sort(domainEntries.begin(), domainEntries.end());
+    size_t distinct = 0;
+    for (size_t i = 0; i < domainEntries.size(); ++i) {
+        distinct += (i == 0 || domainEntries[i].first != domainEntries[i - 1].first) ? 1 : 0;
+    }
+    size_t slotCount = 16;
+    while (slotCount < distinct * 2) {
+        slotCount *= 2;
+    }
+    matcher.domainSlots.assign(distinct ? slotCount : 0, DomainSlot{0, 0, 0});
+    for (size_t i = 0; i < domainEntries.size();) {
+        const uint64_t hash = domainEntries[i].first;
+        DomainSlot slot{hash, static_cast<uint32_t>(matcher.domainRules.size()), 0};
+        for (; i < domainEntries.size() && domainEntries[i].first == hash; ++i) {
+            matcher.domainRules.push_back(domainEntries[i].second);
+            ++slot.ruleCount;
+        }
+        size_t at = hash & (slotCount - 1);
+        while (matcher.domainSlots[at].hash != 0) {
+            at = (at + 1) & (slotCount - 1);
+        }
+        matcher.domainSlots[at] = slot;
+    }
+
+    // Trie des clés : triées, les clés qui partagent un préfixe se suivent, et le fils
+    // cherché est toujours le dernier ajouté au nœud
+    std::sort(keys.begin(), keys.end());
+    struct TrieNode {
+        std::vector<std::pair<uint8_t, uint32_t>> children;
+        std::vector<uint32_t> rules;
+    };
+    std::vector<TrieNode> trie(1);
+    for (const auto &key : keys) {
+        uint32_t node = 0;
+        for (char c : key.first) {
+            const uint8_t byte = static_cast<uint8_t>(c);
+            auto &children = trie[node].children;
+            if (!children.empty() && children.back().first == byte) {
+                node = children.back().second;
+            } else {
+                const uint32_t child = static_cast<uint32_t>(trie.size());
+                children.emplace_back(byte, child);
+                trie.emplace_back();
+                node = child;
+            }
+        }
+        trie[node].rules.push_back(key.second);
+    }
+
+    // Numérotation en largeur : les arêtes de chaque état sont contiguës et les états
+    // proches de la racine, les plus visités, sont groupés en mémoire
+    std::vector<uint32_t> order{0};
+    std::vector<uint32_t> newId(trie.size(), 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (const auto &child : trie[order[i]].children) {
+            newId[child.second] = static_cast<uint32_t>(order.size());
+            order.push_back(child.second);
+        }
+    }
+
+    // Classes d'octets : un octet présent dans une clé a sa propre classe, tous les autres
+    // partagent la classe 0 (qui ramène toujours à la racine)
+    matcher.byteClass.assign(256, 0);
+    uint32_t classCount = 1;
+    for (const auto &key : keys) {
+        for (char c : key.first) {
+            uint8_t &cls = matcher.byteClass[static_cast<uint8_t>(c)];
+            if (cls == 0) {
+                cls = static_cast<uint8_t>(classCount++);
+            }
+        }
+    }
+    // Lignes de taille 2^n : le début d'une ligne se calcule par décalage, sans multiplication
+    matcher.classShift = 0;
+    while ((1u << matcher.classShift) < classCount) {
+        ++matcher.classShift;
+    }
+
+    matcher.states.resize(order.size());
+    for (size_t s = 0; s < order.size(); ++s) {
+        TrieNode &node = trie[order[s]];
+        State &state = matcher.states[s];
+        state.firstEdge = static_cast<uint32_t>(matcher.edgeBytes.size());
+        state.edgeCount = static_cast<uint16_t>(node.children.size());
+        for (const auto &child : node.children) {
+            matcher.edgeBytes.push_back(child.first);
+            matcher.edgeTargets.push_back(newId[child.second]);
+        }
+        // Une clé très partagée ("/ads/"...) dépasserait le compteur : le surplus est vérifié à part
+        const size_t outputCount = std::min<size_t>(node.rules.size(), 0xFFFF);
+        state.firstOutput = static_cast<uint32_t>(matcher.outputs.size());
+        state.outputCount = static_cast<uint16_t>(outputCount);
+        matcher.outputs.insert(matcher.outputs.end(), node.rules.begin(), node.rules.begin() + outputCount);
+        matcher.genericRules.insert(matcher.genericRules.end(), node.rules.begin() + outputCount, node.rules.end());
+        state.fail = 0;
+        state.dictLink = kNone;
+        std::vector<std::pair<uint8_t, uint32_t>>().swap(node.children);
+    }
+
+    // Liens d'échec et de dictionnaire, puis lignes complètes des premiers états. Tout se fait
+    // en largeur : le lien d'échec d'un état est moins profond, donc déjà calculé, et le
+    // numéro de cet état est plus petit (une ligne complète lui est attribuée en premier).
+    const size_t rowLength = size_t(1) << matcher.classShift;
+    matcher.denseStates = static_cast<uint32_t>(std::min(matcher.states.size(),
+                                                         std::max<size_t>(1, kDenseTableBytes / (rowLength * sizeof(uint32_t)))));
+    matcher.dense.assign(matcher.denseStates * rowLength, 0);
+    for (size_t s = 0; s < matcher.states.size(); ++s) {
+        const State state = matcher.states[s];
+        if (s < matcher.denseStates) {
+            uint32_t *row = matcher.dense.data() + (s << matcher.classShift);
+            if (s != 0) {
+                std::copy_n(matcher.dense.data() + (size_t(state.fail) << matcher.classShift), rowLength, row);
+            }
+            for (uint32_t e = state.firstEdge; e < state.firstEdge + state.edgeCount; ++e) {
+                row[matcher.byteClass[matcher.edgeBytes[e]]] = matcher.edgeTargets[e];
+            }
+        }
+        for (uint32_t e = state.firstEdge; e < state.firstEdge + state.edgeCount; ++e) {
+            const uint32_t child = matcher.edgeTargets[e];
+            const uint32_t fail = s == 0 ? 0 : matcher.step(state.fail, matcher.edgeBytes[e]);
+            matcher.states[child].fail = fail;
+            matcher.states[child].dictLink = matcher.states[fail].outputCount ? fail : matcher.states[fail].dictLink;
+        }
+    }
+
+    // Marque les transitions vers un état qui signale au moins une règle
+    auto mark = [&matcher](uint32_t &target) {
+        const State &state = matcher.states[target];
+        if (state.outputCount || state.dictLink != kNone) {
+            target |= kReportBit;
+        }
+    };
+    std::for_each(matcher.dense.begin(), matcher.dense.end(), mark);
+    std::for_each(matcher.edgeTargets.begin(), matcher.edgeTargets.end(), mark);
+}
+
+uint32_t FilterEngine::Matcher::step(uint32_t state, uint8_t byte) const
+{
+    for (;;) {
+        if (state < denseStates) {
+            return dense[(size_t(state) << classShift) + byteClass[byte]];
+        }
+        const State &s = states[state];
+        const uint8_t *bytes = edgeBytes.data() + s.firstEdge;
+        if (s.edgeCount <= 8) {
+            for (uint32_t i = 0; i < s.edgeCount; ++i) {
+                if (bytes[i] == byte) {
+                    return edgeTargets[s.firstEdge + i];
+                }
+            }
+        } else {
+            const uint8_t *found = std::lower_bound(bytes, bytes + s.edgeCount, byte);
+            if (found != bytes + s.edgeCount && *found == byte) {
+                return edgeTargets[s.firstEdge + static_cast<uint32_t>(found - bytes)];
+            }
+        }
+        state = s.fail;
+    }
+}
+
+bool FilterEngine::Matcher::consistent() const
+{
+    const auto within = [](uint64_t first, uint64_t count, size_t size) { return first + count <= size; };
+
+    for (const Rule &rule : rules) {
+        if (!within(rule.pattern, rule.patternLength, pool.size())
+            || !within(rule.domains, rule.domainCount, domainOptions.size())) {
+            return false;
+        }
+    }
+    for (const DomainOption &option : domainOptions) {
+        if (!within(option.offset, option.length, pool.size())) {
+            return false;
+        }
+    }
+
+    // Table des domaines : taille en puissance de 2 et au moins une case vide, sinon une
+    // recherche infructueuse ne s'arrêterait pas
+    if (!domainSlots.empty()) {
+        if ((domainSlots.size() & (domainSlots.size() - 1)) != 0) {
+            return false;
+        }
+        bool hasEmpty = false;
+        for (const DomainSlot &slot : domainSlots) {
+            hasEmpty |= slot.hash == 0;
+            if (slot.hash != 0 && !within(slot.firstRule, slot.ruleCount, domainRules.size())) {
+                return false;
+            }
+        }
+        if (!hasEmpty) {
+            return false;
+        }
+    }
+    const auto isRule = [this](uint32_t id) { return id < rules.size(); };
+    if (!std::all_of(domainRules.begin(), domainRules.end(), isRule)
+        || !std::all_of(outputs.begin(), outputs.end(), isRule)
+        || !std::all_of(genericRules.begin(), genericRules.end(), isRule)) {
+        return false;
+    }
+
+    if (states.empty()) {
+        return true;
+    }
+    if (byteClass.size() != 256 || denseStates == 0 || denseStates > states.size() || classShift > 8
+        || dense.size() != size_t(denseStates) << classShift || edgeBytes.size() != edgeTargets.size()) {
+        return false;
+    }
+    for (uint8_t c : byteClass) {
+        if (c >= 1u << classShift) {
+            return false;
+        }
+    }
+    const auto isState = [this](uint32_t target) { return (target & ~kReportBit) < states.size(); };
+    if (!std::all_of(dense.begin(), dense.end(), isState) || !std::all_of(edgeTargets.begin(), edgeTargets.end(), isState)) {
+        return false;
+    }
+    // Numérotation en largeur : l'échec et le lien de dictionnaire d'un état mènent à un état
+    // moins profond, donc de plus petit numéro ; step() finit ainsi sur un état dense
+    for (uint32_t s = 0; s < states.size(); ++s) {
+        const State &state = states[s];
+        if (!within(state.firstEdge, state.edgeCount, edgeTargets.size())
+            || !within(state.firstOutput, state.outputCount, outputs.size())
+            || (s >= denseStates && state.fail >= s)
+            || (state.dictLink != kNone && state.dictLink >= s)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FilterEngine::Matcher::ruleApplies(uint32_t id, std::string_view url, std::string_view host,
+                                        std::string_view documentHost, bool thirdParty, ResourceType type) const
+{
+    // Les options, peu coûteuses, sont vérifiées avant le motif
+    const Rule &rule = rules[id];
+    if (!(rule.types & type) || ((rule.flags & ThirdParty) && !thirdParty) || ((rule.flags & FirstParty) && thirdParty)) {
+        return false;
+    }
+    if (rule.domainCount) {
+        bool restricted = false;
+        bool included = false;
+        for (uint32_t i = rule.domains; i < rule.domains + rule.domainCount; ++i) {
+            const DomainOption &option = domainOptions[i];
+            const std::string_view domain(pool.data() + option.offset, option.length);
+            if (domainMatches(documentHost, domain)) {
+                if (option.negated) {
+                    return false;
+                }
+                included = true;
+            }
+            restricted |= !option.negated;
+        }
+        if (restricted && !included) {
+            return false;
+        }
+    }
+
+    const std::string_view pattern(pool.data() + rule.pattern, rule.patternLength);
+    const bool anchoredEnd = rule.flags & EndAnchor;
+    if (rule.flags & HostAnchor) {
+        const size_t hostStart = static_cast<size_t>(host.data() - url.data());
+        for (size_t p = hostStart; p < hostStart + host.size(); ++p) {
+            if ((p == hostStart || url[p - 1] == '.') && globMatch(pattern, url.substr(p), false, anchoredEnd)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return globMatch(pattern, url, !(rule.flags & StartAnchor), anchoredEnd);
+}
+
+bool FilterEngine::Matcher::matches(std::string_view url, std::string_view host, std::string_view documentHost,
+                                    bool thirdParty, ResourceType type) const
+{
+    // 1. Domaines : l'hôte et chacun de ses domaines parents, du plus court au plus long
+    if (!domainSlots.empty()) {
+        const size_t mask = domainSlots.size() - 1;
+        uint64_t running = kHashSeed;
+        for (size_t from = host.size(); from-- > 0;) {
+            running = hashStep(running, host[from]);
+            if (from != 0 && host[from - 1] != '.') {
+                continue;
+            }
+            const std::string_view suffix = host.substr(from);
+            const uint64_t hash = finalHash(running);
+            for (size_t at = hash & mask; domainSlots[at].hash != 0; at = (at + 1) & mask) {
+                const DomainSlot &slot = domainSlots[at];
+                if (slot.hash != hash) {
+                    continue;
+                }
+                for (uint32_t i = slot.firstRule; i < slot.firstRule + slot.ruleCount; ++i) {
+                    const Rule &rule = rules[domainRules[i]];
+                    // ruleApplies revérifie le motif "||domaine" : il élimine aussi les collisions de hachage
+                    if (suffix == std::string_view(pool.data() + rule.pattern, rule.patternLength)
+                        && ruleApplies(domainRules[i], url, host, documentHost, thirdParty, type)) {
+                        return true;
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    // 2. Littéraux : un seul passage sur l'URL pour toutes les règles
+    if (!states.empty()) {
+        uint32_t state = 0;
+        for (char c : url) {
+            const uint32_t next = step(state, static_cast<uint8_t>(c));
+            state = next & ~kReportBit;
+            if (!(next & kReportBit)) {
+                continue;
+            }
+            for (uint32_t s = states[state].outputCount ? state : states[state].dictLink; s != kNone;
+                 s = states[s].dictLink) {
+                const State &match = states[s];
+                for (uint32_t i = match.firstOutput; i < match.firstOutput + match.outputCount; ++i) {
+                    if (ruleApplies(outputs[i], url, host, documentHost, thirdParty, type)) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    // 3. Règles sans littéral exploitable
+    for (uint32_t id : genericRules) {
+        if (ruleApplies(id, url, host, documentHost, thirdParty, type)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FilterEngine::shouldBlock(std::string_view url, std::string_view documentHost, ResourceType type) const
+{
+    // Tampon par thread : pas d'allocation par requête une fois l'URL la plus longue vue
+    thread_local std::string lower;
+    lower.resize(url.size());
+    for (size_t i = 0; i < url.size(); ++i) {
+        const char c = url[i];
+        lower[i] = static_cast<char>(c + ((c >= 'A' && c <= 'Z') ? 'a' - 'A' : 0)); // Vectorisable
+    }
+
+    size_t hostStart = 0;
+    size_t hostLength = 0;
+    hostOf(lower, hostStart, hostLength);
+    const std::string_view view(lower);
+    const std::string_view host = view.substr(hostStart, hostLength);
+    const bool thirdParty = !documentHost.empty() && baseDomain(host) != baseDomain(documentHost);
+
+    if (!block.matches(view, host, documentHost, thirdParty, type)) {
+        return false;
+    }
+    return !allow.matches(view, host, documentHost, thirdParty, type);
+}
+
+bool FilterEngine::save(const std::string &path, uint64_t sourceKey) const
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        const uint64_t ignoredCount = ignored;
+        out.write(reinterpret_cast<const char *>(&kFileMagic), sizeof(kFileMagic));
+        out.write(reinterpret_cast<const char *>(&kFileVersion), sizeof(kFileVersion));
+        out.write(reinterpret_cast<const char *>(&sourceKey), sizeof(sourceKey));
+        out.write(reinterpret_cast<const char *>(&ignoredCount), sizeof(ignoredCount));
+        for (const Matcher *m : {&block, &allow}) {
+            writeVector(out, std::vector<char>(m->pool.begin(), m->pool.end()));
+            writeVector(out, m->rules);
+            writeVector(out, m->domainOptions);
+            writeVector(out, m->domainSlots);
+            writeVector(out, m->domainRules);
+            writeVector(out, m->byteClass);
+            writeVector(out, std::vector<uint32_t>{m->classShift, m->denseStates});
+            writeVector(out, m->dense);
+            writeVector(out, m->states);
+            writeVector(out, m->edgeBytes);
+            writeVector(out, m->edgeTargets);
+            writeVector(out, m->outputs);
+            writeVector(out, m->genericRules);
+        }
+        if (!out.flush()) {
+            return false;
+        }
+    }
+    // rename() ne remplace pas un fichier existant sous Windows : l'ancien est supprimé d'abord.
+    // S'arrêter entre les deux ne coûte qu'une recompilation des listes au prochain démarrage.
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool FilterEngine::load(const std::string &path, uint64_t sourceKey)
+{
+    std::ifstream in(path, std::ios::binary);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t key = 0;
+    uint64_t ignoredCount = 0;
+    if (!in.read(reinterpret_cast<char *>(&magic), sizeof(magic)) || !in.read(reinterpret_cast<char *>(&version), sizeof(version))
+        || !in.read(reinterpret_cast<char *>(&key), sizeof(key)) || !in.read(reinterpret_cast<char *>(&ignoredCount), sizeof(ignoredCount))
+        || magic != kFileMagic || version != kFileVersion || key != sourceKey) {
+        return false;
+    }
+
+    Matcher loaded[2];
+    for (Matcher &m : loaded) {
+        std::vector<char> pool;
+        std::vector<uint32_t> sizes;
+        if (!readVector(in, pool) || !readVector(in, m.rules) || !readVector(in, m.domainOptions)
+            || !readVector(in, m.domainSlots) || !readVector(in, m.domainRules) || !readVector(in, m.byteClass)
+            || !readVector(in, sizes) || sizes.size() != 2 || !readVector(in, m.dense) || !readVector(in, m.states) || !readVector(in, m.edgeBytes) || !readVector(in, m.edgeTargets)
+            || !readVector(in, m.outputs) || !readVector(in, m.genericRules)) {
+            return false;
+        }
+        m.pool.assign(pool.begin(), pool.end());
+        m.classShift = sizes[0];
+        m.denseStates = sizes[1];
+        if (!m.consistent()) {
+            return false; // Fichier abîmé ou tronqué : les listes seront recompilées
+        }
+    }
+    block = std::move(loaded[0]);
+    allow = std::move(loaded[1]);
+    ignored = static_cast<size_t>(ignoredCount);
+    return true;
+}
@@ -0,0 +1,155 @@
+// filterengine.h
+#ifndef FILTERENGINE_H
+#define FILTERENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Moteur de blocage des requêtes (publicité, pisteurs) à partir de listes de filtres au
+// format EasyList / Adblock Plus.
+//
+// Les règles sont compilées en deux index :
+//  - une table de hachage des domaines pour les règles "||domaine^" (la grande majorité) :
+//    on y cherche chaque suffixe de l'hôte demandé ;
+//  - un automate d'Aho-Corasick sur un littéral de chaque autre règle : un seul parcours de
+//    l'URL trouve toutes les règles candidates, qui sont ensuite vérifiées en entier.
+// Les règles d'exception "@@" ont leurs propres index, consultés seulement si l'URL est bloquée.
+//
+// Toutes les structures compilées sont des tableaux plats : elles s'écrivent et se relisent
+// telles quelles (save/load), sans réanalyser les listes au démarrage.
+// Après compile() ou load(), shouldBlock() est const et peut être appelé de plusieurs threads.
+class FilterEngine
+{
+public:
+    // Types de ressources (option $script, $image...) ; une règle sans type les vise tous
+    enum ResourceType : uint16_t {
+        Other = 1 << 0,
+        Script = 1 << 1,
+        Image = 1 << 2,
+        Stylesheet = 1 << 3,
+        Object = 1 << 4,
+        Subdocument = 1 << 5,
+        XmlHttpRequest = 1 << 6,
+        WebSocket = 1 << 7,
+        Font = 1 << 8,
+        Media = 1 << 9,
+        Ping = 1 << 10,
+    };
+    static constexpr uint16_t kAllTypes = (1 << 11) - 1;
+
+    // Ajoute les règles d'une liste (une règle par ligne) ; renvoie le nombre de règles retenues.
+    // Les règles d'affichage (##), les expressions régulières et les options non gérées sont ignorées.
+    size_t addList(std::string_view text);
+    bool addRule(std::string_view line);
+    // Construit les index ; à appeler une fois toutes les listes ajoutées
+    void compile();
+
+    // url : URL complète de la requête ; documentHost : hôte de la page qui la fait (vide si inconnu)
+    bool shouldBlock(std::string_view url, std::string_view documentHost, ResourceType type) const;
+
+    size_t ruleCount() const { return block.rules.size() + allow.rules.size(); }
+    size_t ignoredCount() const { return ignored; }
+
+    // Forme compilée sur disque ; sourceKey identifie les listes d'origine (taille, date...)
+    // et load() échoue si elle ne correspond pas
+    bool save(const std::string &path, uint64_t sourceKey) const;
+    bool load(const std::string &path, uint64_t sourceKey);
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    // Bit posé sur une cible de transition quand l'état atteint termine une clé (lui-même ou
+    // par ses liens de dictionnaire) : la boucle de recherche n'a pas à lire l'état pour le savoir
+    static constexpr uint32_t kReportBit = 0x80000000u;
+
+    enum RuleFlag : uint8_t {
+        HostAnchor = 1 << 0,  // "||" : commence au début de l'hôte ou d'un de ses sous-domaines
+        StartAnchor = 1 << 1, // "|" en tête : commence au début de l'URL
+        EndAnchor = 1 << 2,   // "|" en fin : termine l'URL
+        ThirdParty = 1 << 3,  // $third-party
+        FirstParty = 1 << 4,  // $~third-party
+    };
+
+    struct Rule {
+        uint32_t pattern = 0;     // Motif en minuscules dans pool ("*" et "^" compris)
+        uint32_t patternLength = 0;
+        uint32_t domains = 0;     // Premier élément de domainOptions ($domain=)
+        uint16_t domainCount = 0;
+        uint16_t types = kAllTypes;
+        uint8_t flags = 0;
+    };
+
+    struct DomainOption {
+        uint32_t offset;  // Nom de domaine dans pool
+        uint16_t length;
+        uint8_t negated;  // "~domaine" : la règle ne s'applique pas sur ce site
+    };
+
+    struct State {
+        uint32_t firstEdge;   // Arêtes sortantes : edgeBytes/edgeTargets[firstEdge, +edgeCount)
+        uint32_t fail;        // Plus long suffixe propre qui est aussi un préfixe d'une clé
+        uint32_t dictLink;    // Prochain état sur la chaîne des échecs qui termine une clé
+        uint32_t firstOutput; // Règles dont la clé se termine ici : outputs[firstOutput, +outputCount)
+        uint16_t edgeCount;
+        uint16_t outputCount;
+    };
+
+    struct DomainSlot {
+        uint64_t hash;      // 0 = case vide
+        uint32_t firstRule; // domainRules[firstRule, +ruleCount)
+        uint32_t ruleCount;
+    };
+
+    // Index d'un ensemble de règles (blocage ou exceptions)
+    struct Matcher {
+        std::string pool;
+        std::vector<Rule> rules;
+        std::vector<DomainOption> domainOptions;
+
+        // Règles "||domaine^" : table à adressage ouvert, clé = hachage du domaine
+        std::vector<DomainSlot> domainSlots;
+        std::vector<uint32_t> domainRules;
+
+        // Automate d'Aho-Corasick. Les états sont numérotés en largeur : les premiers, les moins
+        // profonds et de loin les plus visités, ont une ligne de transitions complète indexée par
+        // la classe de l'octet (aucun lien d'échec à suivre) ; les autres ont des arêtes creuses.
+        std::vector<uint8_t> byteClass; // 256 entrées ; 0 = octet absent de toutes les clés
+        uint32_t classShift = 0;        // Une ligne compte 1 << classShift classes
+        uint32_t denseStates = 0;
+        std::vector<uint32_t> dense;    // denseStates lignes
+        std::vector<State> states;
+        std::vector<uint8_t> edgeBytes;
+        std::vector<uint32_t> edgeTargets;
+        std::vector<uint32_t> outputs;
+        std::vector<uint32_t> genericRules; // Règles sans littéral assez long : toujours vérifiées
+
+        bool matches(std::string_view url, std::string_view host, std::string_view documentHost,
+                     bool thirdParty, ResourceType type) const;
+        bool ruleApplies(uint32_t rule, std::string_view url, std::string_view host,
+                         std::string_view documentHost, bool thirdParty, ResourceType type) const;
+        uint32_t step(uint32_t state, uint8_t byte) const; // Cible, avec kReportBit éventuel
+        // Vrai si chaque indice et position pointe dans son tableau et si les liens d'échec
+        // remontent vers la racine : un fichier relu ne peut ni lire hors limites ni boucler
+        bool consistent() const;
+    };
+
+    // Règle analysée, en attente de compile()
+    struct PendingRule {
+        std::string pattern;
+        std::vector<std::pair<std::string, bool>> domains;
+        uint16_t types = kAllTypes;
+        uint8_t flags = 0;
+        bool domainOnly = false; // "||domaine^" : va dans la table des domaines
+    };
+
+    std::vector<PendingRule> pendingBlock;
+    std::vector<PendingRule> pendingAllow;
+    Matcher block;
+    Matcher allow;
+    size_t ignored = 0;
+
+    static void build(Matcher &matcher, std::vector<PendingRule> &pending);
+};
+
+#endif // FILTERENGINE_H
@@ -0,0 +1,717 @@
+// fulltextindex.cpp
+#include "fulltextindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace {
+
+const uint32_t kSegmentMagic = 0x53544349;  // "ICTS"
+const uint32_t kManifestMagic = 0x4D544349; // "ICTM"
+const uint32_t kFileVersion = 1;
+const uint64_t kSegmentHeaderBytes = 4 + 4 + 4 + 8; // Magique, version, nombre de termes, position du dictionnaire
+const size_t kCompactionThreshold = 1000; // Pages remplacées avant de réécrire docs.log
+
+// Paramètres usuels de BM25
+const double kBm25K1 = 1.2;
+const double kBm25B = 0.75;
+
+void putVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool getVarint(const char *&p, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        const uint8_t byte = static_cast<uint8_t>(*p++);
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void putString(std::string &out, const std::string &s)
+{
+    putVarint(out, s.size());
+    out += s;
+}
+
+bool getString(const char *&p, const char *end, std::string &s)
+{
+    uint64_t length = 0;
+    if (!getVarint(p, end, length) || length > uint64_t(end - p)) {
+        return false;
+    }
+    s.assign(p, static_cast<size_t>(length));
+    p += length;
+    return true;
+}
+
+template <typename T>
+void putRaw(std::string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool getRaw(const char *&p, const char *end, T &value)
+{
+    if (size_t(end - p) < sizeof(value)) {
+        return false;
+    }
+    std::copy(p, p + sizeof(value), reinterpret_cast<char *>(&value));
+    p += sizeof(value);
+    return true;
+}
+
+bool readFile(const std::string &path, std::string &out)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    out.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    return static_cast<bool>(in.read(&out[0], static_cast<std::streamsize>(out.size())));
+}
+
+uint64_t fileSize(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<uint64_t>(in.tellg()) : 0;
+}
+
+// Remplace path par temporary. rename() ne remplace pas un fichier existant sous Windows :
+// l'ancien est supprimé d'abord, et open() sait repartir du fichier temporaire si l'on
+// s'arrête entre les deux.
+bool replaceFile(const std::string &temporary, const std::string &path)
+{
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+// Listes de pages : écart avec la page précédente puis fréquence, en varint
+void encodePostings(std::string &out, const std::vector<std::pair<uint32_t, uint32_t>> &postings)
+{
+    uint32_t previous = 0;
+    for (const auto &p : postings) {
+        putVarint(out, p.first - previous);
+        putVarint(out, p.second);
+        previous = p.first;
+    }
+}
+
+// Écrit un segment terme par terme, dans l'ordre croissant des termes, sans tout garder en mémoire
+class SegmentWriter
+{
+public:
+    explicit SegmentWriter(const std::string &path)
+        : out(path, std::ios::binary | std::ios::trunc)
+    {
+        const std::string header(kSegmentHeaderBytes, '\0');
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+
+    void add(const std::string &term, const std::vector<std::pair<uint32_t, uint32_t>> &postings)
+    {
+        encoded.clear();
+        encodePostings(encoded, postings);
+        out.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+        putString(dictionary, term);
+        putVarint(dictionary, postings.size());
+        putVarint(dictionary, encoded.size());
+        postingsBytes += encoded.size();
+        ++termCount;
+    }
+
+    bool finish()
+    {
+        out.write(dictionary.data(), static_cast<std::streamsize>(dictionary.size()));
+        std::string header;
+        putRaw(header, kSegmentMagic);
+        putRaw(header, kFileVersion);
+        putRaw(header, termCount);
+        putRaw(header, kSegmentHeaderBytes + postingsBytes);
+        out.seekp(0);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        return static_cast<bool>(out.flush());
+    }
+
+private:
+    std::ofstream out;
+    std::string encoded;
+    std::string dictionary;
+    uint64_t postingsBytes = 0;
+    uint32_t termCount = 0;
+};
+
+} // namespace
+
+FullTextIndex::FullTextIndex(std::string directory)
+    : directory(std::move(directory))
+{
+}
+
+const FullTextIndex::TermInfo *FullTextIndex::Segment::find(const std::string &term) const
+{
+    auto it = std::lower_bound(dictionary.begin(), dictionary.end(), term, [this](const TermInfo &info, const std::string &t) {
+        return terms.compare(info.termOffset, info.termLength, t) < 0;
+    });
+    if (it == dictionary.end() || terms.compare(it->termOffset, it->termLength, term) != 0) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+std::string FullTextIndex::segmentPath(uint32_t generation) const
+{
+    return directory + "/seg-" + std::to_string(generation) + ".idx";
+}
+
+void FullTextIndex::reset()
+{
+    segments.clear();
+    docs.clear();
+    docByUrl.clear();
+    buffer.clear();
+    bufferDocs = 0;
+    liveDocs = deletedDocs = 0;
+    liveLength = 0;
+    committedDocs = 0;
+}
+
+bool FullTextIndex::open()
+{
+    reset();
+    const std::string manifestPath = directory + "/manifest.bin";
+    std::string manifest;
+    if (!readFile(manifestPath, manifest)) {
+        // Arrêt entre la suppression de l'ancien manifeste et le renommage du nouveau
+        if (!readFile(manifestPath + ".tmp", manifest) || !replaceFile(manifestPath + ".tmp", manifestPath)) {
+            return true; // Index neuf
+        }
+    }
+
+    const char *p = manifest.data();
+    const char *end = p + manifest.size();
+    uint32_t magic = 0, version = 0, segmentCount = 0;
+    if (!getRaw(p, end, magic) || !getRaw(p, end, version) || magic != kManifestMagic || version != kFileVersion
+        || !getRaw(p, end, committedDocs) || !getRaw(p, end, nextGeneration) || !getRaw(p, end, segmentCount)) {
+        reset();
+        return false;
+    }
+    for (uint32_t i = 0; i < segmentCount; ++i) {
+        Segment segment;
+        if (!getRaw(p, end, segment.generation) || !getRaw(p, end, segment.level) || !loadSegment(segment)) {
+            reset();
+            return false;
+        }
+        segments.push_back(std::move(segment));
+    }
+    loadDocuments(committedDocs);
+    return true;
+}
+
+bool FullTextIndex::loadSegment(Segment &segment) const
+{
+    std::ifstream in(segmentPath(segment.generation), std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    segment.fileBytes = static_cast<uint64_t>(in.tellg());
+    std::string header(kSegmentHeaderBytes, '\0');
+    in.seekg(0);
+    if (!in.read(&header[0], static_cast<std::streamsize>(header.size()))) {
+        return false;
+    }
+    const char *p = header.data();
+    const char *end = p + header.size();
+    uint32_t magic = 0, version = 0, termCount = 0;
+    uint64_t dictionaryOffset = 0;
+    getRaw(p, end, magic);
+    getRaw(p, end, version);
+    getRaw(p, end, termCount);
+    getRaw(p, end, dictionaryOffset);
+    if (magic != kSegmentMagic || version != kFileVersion || dictionaryOffset < kSegmentHeaderBytes
+        || dictionaryOffset > segment.fileBytes) {
+        return false;
+    }
+
+    // Seul le dictionnaire est gardé en mémoire ; les listes de pages sont lues à la demande
+    std::string dictionary(static_cast<size_t>(segment.fileBytes - dictionaryOffset), '\0');
+    in.seekg(static_cast<std::streamoff>(dictionaryOffset));
+    if (!in.read(&dictionary[0], static_cast<std::streamsize>(dictionary.size()))) {
+        return false;
+    }
+    p = dictionary.data();
+    end = p + dictionary.size();
+    uint64_t postingsOffset = kSegmentHeaderBytes;
+    segment.dictionary.reserve(termCount);
+    std::string term;
+    for (uint32_t i = 0; i < termCount; ++i) {
+        uint64_t frequency = 0, length = 0;
+        if (!getString(p, end, term) || !getVarint(p, end, frequency) || !getVarint(p, end, length)) {
+            return false;
+        }
+        TermInfo info;
+        info.termOffset = static_cast<uint32_t>(segment.terms.size());
+        info.termLength = static_cast<uint32_t>(term.size());
+        info.documentFrequency = static_cast<uint32_t>(frequency);
+        info.postingsOffset = postingsOffset;
+        info.postingsLength = static_cast<uint32_t>(length);
+        segment.terms += term;
+        segment.dictionary.push_back(info);
+        postingsOffset += length;
+    }
+    return postingsOffset == dictionaryOffset;
+}
+
+bool FullTextIndex::readPostings(const Segment &segment, const TermInfo &info, std::vector<Posting> &out) const
+{
+    std::ifstream in(segmentPath(segment.generation), std::ios::binary);
+    std::string bytes(info.postingsLength, '\0');
+    in.seekg(static_cast<std::streamoff>(info.postingsOffset));
+    if (!in.read(&bytes[0], static_cast<std::streamsize>(bytes.size()))) {
+        return false;
+    }
+    const char *p = bytes.data();
+    const char *end = p + bytes.size();
+    uint64_t doc = 0;
+    while (p < end) {
+        uint64_t gap = 0, frequency = 0;
+        if (!getVarint(p, end, gap) || !getVarint(p, end, frequency)) {
+            return false;
+        }
+        doc += gap;
+        out.push_back({static_cast<uint32_t>(doc), static_cast<uint32_t>(frequency)});
+    }
+    return true;
+}
+
+// Manifeste des segments actuels, suivis de added s'il est donné : flush() valide ainsi un
+// nouveau segment sur disque avant de l'ajouter à l'index en mémoire
+bool FullTextIndex::writeManifest(uint32_t documents, uint32_t generations, const Segment *added) const
+{
+    std::string manifest;
+    putRaw(manifest, kManifestMagic);
+    putRaw(manifest, kFileVersion);
+    putRaw(manifest, documents);
+    putRaw(manifest, generations);
+    putRaw(manifest, static_cast<uint32_t>(segments.size() + (added ? 1 : 0)));
+    for (const Segment &segment : segments) {
+        putRaw(manifest, segment.generation);
+        putRaw(manifest, segment.level);
+    }
+    if (added) {
+        putRaw(manifest, added->generation);
+        putRaw(manifest, added->level);
+    }
+    const std::string path = directory + "/manifest.bin";
+    {
+        std::ofstream out(path + ".tmp", std::ios::binary | std::ios::trunc);
+        if (!out.write(manifest.data(), static_cast<std::streamsize>(manifest.size())) || !out.flush()) {
+            return false;
+        }
+    }
+    return replaceFile(path + ".tmp", path);
+}
+
+// docs.log : un enregistrement par numéro de page, dans l'ordre. Une page remplacée est
+// réduite à un octet par la compaction, ce qui conserve la numérotation.
+std::string FullTextIndex::encodeDocuments(uint32_t from, uint32_t to) const
+{
+    std::string records;
+    for (uint32_t i = from; i < to; ++i) {
+        const Document &doc = docs[i];
+        records.push_back(doc.deleted ? 1 : 0);
+        if (!doc.deleted) {
+            putRaw(records, doc.contentHash);
+            putVarint(records, doc.length);
+            putString(records, doc.url);
+            putString(records, doc.title);
+            putString(records, doc.excerpt);
+        }
+    }
+    return records;
+}
+
+// logSize : taille de docs.log avant l'ajout. Un ajout incomplet est retiré aussitôt : un
+// enregistrement tronqué rendrait illisibles tous ceux qui le suivraient.
+bool FullTextIndex::appendDocuments(uint32_t from, uint32_t to, uint64_t logSize) const
+{
+    const std::string path = directory + "/docs.log";
+    const std::string records = encodeDocuments(from, to);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        if (out.write(records.data(), static_cast<std::streamsize>(records.size())) && out.flush()) {
+            return true;
+        }
+    }
+    std::error_code error;
+    std::filesystem::resize_file(path, logSize, error);
+    return false;
+}
+
+bool FullTextIndex::rewriteDocuments()
+{
+    const std::string path = directory + "/docs.log";
+    const std::string records = encodeDocuments(0, committedDocs);
+    {
+        std::ofstream out(path + ".tmp", std::ios::binary | std::ios::trunc);
+        if (!out.write(records.data(), static_cast<std::streamsize>(records.size())) || !out.flush()) {
+            return false;
+        }
+    }
+    if (!replaceFile(path + ".tmp", path)) {
+        return false;
+    }
+    deletedDocs = 0;
+    for (uint32_t i = 0; i < committedDocs; ++i) {
+        if (docs[i].deleted) {
+            docs[i] = Document();
+            docs[i].deleted = true;
+        }
+    }
+    return true;
+}
+
+void FullTextIndex::loadDocuments(uint32_t limit)
+{
+    const std::string path = directory + "/docs.log";
+    std::string log;
+    readFile(path, log);
+    const char *p = log.data();
+    const char *end = p + log.size();
+    docs.reserve(limit);
+    while (docs.size() < limit && p < end) {
+        Document doc;
+        const char flags = *p++;
+        if (flags & 1) {
+            doc.deleted = true;
+        } else {
+            uint64_t length = 0;
+            if (!getRaw(p, end, doc.contentHash) || !getVarint(p, end, length) || !getString(p, end, doc.url)
+                || !getString(p, end, doc.title) || !getString(p, end, doc.excerpt)) {
+                break;
+            }
+            doc.length = static_cast<uint32_t>(length);
+        }
+        docs.push_back(std::move(doc));
+    }
+    const bool consistent = docs.size() == limit && p == end;
+    // Pages perdues (fichier tronqué) : leurs numéros restent réservés mais sans contenu
+    while (docs.size() < limit) {
+        docs.emplace_back();
+        docs.back().deleted = true;
+    }
+
+    // Une URL présente plusieurs fois : seule la dernière version compte
+    for (uint32_t i = 0; i < docs.size(); ++i) {
+        Document &doc = docs[i];
+        if (doc.deleted) {
+            ++deletedDocs;
+            continue;
+        }
+        auto [it, inserted] = docByUrl.emplace(doc.url, i);
+        if (!inserted) {
+            Document &previous = docs[it->second];
+            previous.deleted = true;
+            --liveDocs;
+            ++deletedDocs;
+            liveLength -= previous.length;
+            it->second = i;
+        }
+        ++liveDocs;
+        liveLength += doc.length;
+    }
+    // Enregistrements d'un flush interrompu avant la validation du manifeste : on les retire
+    if (!consistent) {
+        rewriteDocuments();
+    }
+}
+
+bool FullTextIndex::isCurrent(const std::string &url, uint64_t contentHash) const
+{
+    auto it = docByUrl.find(url);
+    return it != docByUrl.end() && docs[it->second].contentHash == contentHash;
+}
+
+void FullTextIndex::addDocument(const std::string &url, const std::string &title, const std::string &excerpt,
+                                uint64_t contentHash, const std::vector<std::string> &tokens)
+{
+    const uint32_t id = static_cast<uint32_t>(docs.size());
+    auto [it, inserted] = docByUrl.emplace(url, id);
+    if (!inserted) {
+        Document &previous = docs[it->second];
+        previous.deleted = true;
+        --liveDocs;
+        ++deletedDocs;
+        liveLength -= previous.length;
+        it->second = id;
+    }
+
+    Document doc;
+    doc.url = url;
+    doc.title = title;
+    doc.excerpt = excerpt;
+    doc.contentHash = contentHash;
+    doc.length = static_cast<uint32_t>(tokens.size());
+    docs.push_back(std::move(doc));
+    ++liveDocs;
+    liveLength += tokens.size();
+
+    std::unordered_map<std::string, uint32_t> frequencies;
+    for (const std::string &token : tokens) {
+        ++frequencies[token];
+    }
+    for (const auto &f : frequencies) {
+        buffer[f.first].push_back({id, f.second});
+    }
+    ++bufferDocs;
+}
+
+bool FullTextIndex::flush()
+{
+    if (bufferDocs == 0) {
+        return true;
+    }
+
+    std::vector<const std::string *> terms;
+    terms.reserve(buffer.size());
+    for (const auto &entry : buffer) {
+        terms.push_back(&entry.first);
+    }
+    std::sort(terms.begin(), terms.end(), [](const std::string *a, const std::string *b) { return *a < *b; });
+
+    Segment segment;
+    segment.generation = nextGeneration;
+    {
+        SegmentWriter writer(segmentPath(segment.generation));
+        std::vector<std::pair<uint32_t, uint32_t>> live;
+        for (const std::string *term : terms) {
+            live.clear();
+            for (const Posting &p : buffer[*term]) {
+                if (!docs[p.doc].deleted) {
+                    live.emplace_back(p.doc, p.frequency);
+                }
+            }
+            if (!live.empty()) {
+                writer.add(*term, live);
+            }
+        }
+        if (!writer.finish()) {
+            return false;
+        }
+    }
+    const uint32_t documentCount = static_cast<uint32_t>(docs.size());
+    const std::string logPath = directory + "/docs.log";
+    const uint64_t logSize = fileSize(logPath);
+    if (!loadSegment(segment) || !appendDocuments(committedDocs, documentCount, logSize)) {
+        return false;
+    }
+
+    // Le segment et ses pages ne font partie de l'index qu'une fois le manifeste réécrit. En cas
+    // d'échec, docs.log reprend sa taille et rien n'a changé en mémoire : un nouveau flush()
+    // refait exactement le même travail, sans écrire deux fois les mêmes pages.
+    if (!writeManifest(documentCount, nextGeneration + 1, &segment)) {
+        std::error_code error;
+        std::filesystem::resize_file(logPath, logSize, error);
+        return false;
+    }
+    ++nextGeneration;
+    segments.push_back(std::move(segment));
+    committedDocs = documentCount;
+    buffer.clear();
+    bufferDocs = 0;
+    if (deletedDocs > kCompactionThreshold && deletedDocs > liveDocs) {
+        rewriteDocuments();
+    }
+    return true;
+}
+
+bool FullTextIndex::mergeStep()
+{
+    // Les segments les plus bas sont les plus récents : ceux d'un même niveau sont contigus
+    for (size_t first = 0; first < segments.size();) {
+        size_t last = first;
+        while (last < segments.size() && segments[last].level == segments[first].level) {
+            ++last;
+        }
+        if (last - first < kMergeFactor) {
+            first = last;
+            continue;
+        }
+
+        // Fusion des kMergeFactor plus anciens segments de ce niveau (fusion à k voies des
+        // dictionnaires triés ; les pages remplacées disparaissent)
+        const size_t count = kMergeFactor;
+        std::vector<std::string> files(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!readFile(segmentPath(segments[first + i].generation), files[i])) {
+                return false;
+            }
+        }
+        Segment merged;
+        merged.generation = nextGeneration;
+        merged.level = segments[first].level + 1;
+        {
+            SegmentWriter writer(segmentPath(merged.generation));
+            std::vector<size_t> cursor(count, 0);
+            std::vector<std::pair<uint32_t, uint32_t>> live;
+            for (;;) {
+                const std::string *smallest = nullptr;
+                std::string candidate;
+                std::string term;
+                for (size_t i = 0; i < count; ++i) {
+                    const Segment &s = segments[first + i];
+                    if (cursor[i] < s.dictionary.size()) {
+                        const TermInfo &info = s.dictionary[cursor[i]];
+                        candidate.assign(s.terms, info.termOffset, info.termLength);
+                        if (!smallest || candidate < term) {
+                            term = candidate;
+                            smallest = &term;
+                        }
+                    }
+                }
+                if (!smallest) {
+                    break;
+                }
+                live.clear();
+                for (size_t i = 0; i < count; ++i) {
+                    const Segment &s = segments[first + i];
+                    if (cursor[i] >= s.dictionary.size()) {
+                        continue;
+                    }
+                    const TermInfo &info = s.dictionary[cursor[i]];
+                    if (s.terms.compare(info.termOffset, info.termLength, term) != 0) {
+                        continue;
+                    }
+                    ++cursor[i];
+                    const char *p = files[i].data() + info.postingsOffset;
+                    const char *end = p + info.postingsLength;
+                    uint64_t doc = 0;
+                    while (p < end) {
+                        uint64_t gap = 0, frequency = 0;
+                        if (!getVarint(p, end, gap) || !getVarint(p, end, frequency)) {
+                            return false;
+                        }
+                        doc += gap;
+                        if (doc < docs.size() && !docs[doc].deleted) {
+                            live.emplace_back(static_cast<uint32_t>(doc), static_cast<uint32_t>(frequency));
+                        }
+                    }
+                }
+                if (!live.empty()) {
+                    // Les segments d'un niveau couvrent des numéros croissants : la liste est déjà
+                    // triée, sauf index écrit par une version qui ne garantissait pas cet ordre
+                    if (!std::is_sorted(live.begin(), live.end())) {
+                        std::sort(live.begin(), live.end());
+                    }
+                    writer.add(term, live);
+                }
+            }
+            if (!writer.finish()) {
+                return false;
+            }
+        }
+        if (!loadSegment(merged)) {
+            return false;
+        }
+
+        std::vector<uint32_t> obsolete;
+        for (size_t i = 0; i < count; ++i) {
+            obsolete.push_back(segments[first + i].generation);
+        }
+        ++nextGeneration;
+        segments.erase(segments.begin() + static_cast<std::ptrdiff_t>(first),
+                       segments.begin() + static_cast<std::ptrdiff_t>(first + count));
+        segments.insert(segments.begin() + static_cast<std::ptrdiff_t>(first), std::move(merged));
+        if (!writeManifest(committedDocs, nextGeneration)) {
+            return false;
+        }
+        for (uint32_t generation : obsolete) {
+            std::remove(segmentPath(generation).c_str());
+        }
+        return true;
+    }
+    return false;
+}
+
+std::vector<FullTextIndex::Hit> FullTextIndex::search(const std::vector<std::string> &terms, size_t limit) const
+{
+    std::vector<Hit> hits;
+    if (liveDocs == 0 || limit == 0) {
+        return hits;
+    }
+    const double averageLength = std::max(1.0, double(liveLength) / liveDocs);
+
+    std::unordered_map<uint32_t, double> scores;
+    std::unordered_set<std::string> seen;
+    std::vector<Posting> postings;
+    for (const std::string &term : terms) {
+        if (!seen.insert(term).second) {
+            continue;
+        }
+        postings.clear();
+        for (const Segment &segment : segments) {
+            if (const TermInfo *info = segment.find(term)) {
+                readPostings(segment, *info, postings);
+            }
+        }
+        auto buffered = buffer.find(term);
+        if (buffered != buffer.end()) {
+            postings.insert(postings.end(), buffered->second.begin(), buffered->second.end());
+        }
+        postings.erase(std::remove_if(postings.begin(), postings.end(), [this](const Posting &p) {
+                           return p.doc >= docs.size() || docs[p.doc].deleted;
+                       }), postings.end());
+        if (postings.empty()) {
+            continue;
+        }
+
+        const double df = double(postings.size());
+        const double idf = std::log(1.0 + (liveDocs - df + 0.5) / (df + 0.5));
+        for (const Posting &p : postings) {
+            const double tf = p.frequency;
+            const double norm = kBm25K1 * (1.0 - kBm25B + kBm25B * docs[p.doc].length / averageLength);
+            scores[p.doc] += idf * tf * (kBm25K1 + 1.0) / (tf + norm);
+        }
+    }
+
+    std::vector<std::pair<double, uint32_t>> ranked;
+    ranked.reserve(scores.size());
+    for (const auto &s : scores) {
+        ranked.emplace_back(s.second, s.first);
+    }
+    const size_t count = std::min(limit, ranked.size());
+    // À score égal, la page la plus récemment indexée d'abord
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(count), ranked.end(),
+                      [](const auto &a, const auto &b) { return a.first != b.first ? a.first > b.first : a.second > b.second; });
+    hits.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Document &doc = docs[ranked[i].second];
+        hits.push_back({doc.url, doc.title, doc.excerpt, ranked[i].first});
+    }
+    return hits;
+}
+
+uint64_t FullTextIndex::diskBytes() const
+{
+    uint64_t total = fileSize(directory + "/docs.log") + fileSize(directory + "/manifest.bin");
+    for (const Segment &segment : segments) {
+        total += segment.fileBytes;
+    }
+    return total;
+}
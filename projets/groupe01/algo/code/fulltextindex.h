@@ -0,0 +1,124 @@
+// fulltextindex.h
+#ifndef FULLTEXTINDEX_H
+#define FULLTEXTINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Index plein texte des pages visitées, sur disque.
+//
+// Index inversé structuré en segments immuables (terme -> liste des pages qui le contiennent) :
+//  - les nouvelles pages s'accumulent en mémoire puis sont écrites d'un bloc (flush) en un
+//    segment de niveau 0 ;
+//  - dès que kMergeFactor segments ont le même niveau, mergeStep() les fusionne en un segment
+//    du niveau supérieur : chaque page est réécrite O(log n) fois, et une fusion ne touche
+//    jamais tout l'index ;
+//  - les listes de pages sont compressées : écarts entre numéros de pages successifs et
+//    fréquences, en entiers de longueur variable (varint).
+// Les résultats sont classés par BM25. Une page réindexée (contenu modifié) reçoit un nouveau
+// numéro ; l'ancien est ignoré à la recherche et disparaît à la fusion suivante.
+//
+// Fichiers du répertoire : manifest.bin (segments vivants, validé en dernier), docs.log
+// (URL, titre et extrait de chaque page, en ajout seul) et seg-<n>.idx.
+// Cette classe n'est pas thread-safe : elle est possédée par le thread du PageIndexer.
+class FullTextIndex
+{
+public:
+    struct Hit {
+        std::string url;
+        std::string title;
+        std::string excerpt;
+        double score;
+    };
+
+    static constexpr size_t kMergeFactor = 4;
+
+    explicit FullTextIndex(std::string directory);
+
+    // Relit le manifeste et les dictionnaires des segments ; false si l'index est illisible
+    // (il repart alors vide)
+    bool open();
+
+    // Vrai si l'URL est déjà indexée avec ce contenu (empreinte du texte) : rien à refaire
+    bool isCurrent(const std::string &url, uint64_t contentHash) const;
+    // Indexe (ou réindexe) une page ; tokens : mots déjà normalisés (minuscules, sans accents)
+    void addDocument(const std::string &url, const std::string &title, const std::string &excerpt,
+                     uint64_t contentHash, const std::vector<std::string> &tokens);
+    size_t bufferedDocuments() const { return bufferDocs; }
+
+    // Écrit les pages en mémoire dans un nouveau segment
+    bool flush();
+    // Effectue au plus une fusion en attente ; false s'il n'y avait rien à fusionner
+    bool mergeStep();
+
+    // Les limit meilleures pages pour ces mots (déjà normalisés), pages en mémoire comprises
+    std::vector<Hit> search(const std::vector<std::string> &terms, size_t limit) const;
+
+    size_t documentCount() const { return liveDocs; }
+    size_t segmentCount() const { return segments.size(); }
+    uint64_t diskBytes() const;
+
+private:
+    struct Posting {
+        uint32_t doc;
+        uint32_t frequency;
+    };
+
+    struct Document {
+        std::string url;
+        std::string title;
+        std::string excerpt;
+        uint64_t contentHash = 0;
+        uint32_t length = 0; // Nombre de mots
+        bool deleted = false;
+    };
+
+    // Entrée du dictionnaire d'un segment ; les termes sont triés, leurs octets dans terms
+    struct TermInfo {
+        uint32_t termOffset;
+        uint32_t termLength;
+        uint32_t documentFrequency;
+        uint64_t postingsOffset; // Dans le fichier du segment
+        uint32_t postingsLength;
+    };
+
+    struct Segment {
+        uint32_t generation = 0;
+        uint32_t level = 0;
+        std::string terms;
+        std::vector<TermInfo> dictionary;
+        uint64_t fileBytes = 0;
+
+        const TermInfo *find(const std::string &term) const;
+    };
+
+    std::string directory;
+    std::vector<Segment> segments; // Du plus ancien au plus récent
+    uint32_t nextGeneration = 1;
+
+    // Pages : numéro -> métadonnées ; deleted pour les versions remplacées
+    std::vector<Document> docs;
+    std::unordered_map<std::string, uint32_t> docByUrl;
+    size_t liveDocs = 0;
+    size_t deletedDocs = 0;
+    uint64_t liveLength = 0;
+    uint32_t committedDocs = 0; // Pages déjà écrites dans docs.log et présentes dans un segment
+
+    // Pages pas encore écrites dans un segment
+    std::unordered_map<std::string, std::vector<Posting>> buffer;
+    size_t bufferDocs = 0;
+
+    std::string segmentPath(uint32_t generation) const;
+    bool loadSegment(Segment &segment) const;
+    bool readPostings(const Segment &segment, const TermInfo &info, std::vector<Posting> &out) const;
+    bool writeManifest(uint32_t documents, uint32_t generations, const Segment *added = nullptr) const;
+    std::string encodeDocuments(uint32_t from, uint32_t to) const;
+    bool appendDocuments(uint32_t from, uint32_t to, uint64_t logSize) const;
+    bool rewriteDocuments();
+    void loadDocuments(uint32_t limit);
+    void reset();
+};
+
+#endif // FULLTEXTINDEX_H
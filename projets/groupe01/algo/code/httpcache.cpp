@@ -0,0 +1,447 @@
+// httpcache.cpp
+#include "httpcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkCookieJar>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+const quint32 kIndexMagic = 0x49434348; // "ICCH"
+const quint16 kIndexVersion = 1;
+const int kStoresBetweenIndexSaves = 20;
+const int kMaxParallelPrefetches = 2;
+const qint64 kMaxHeuristicLifetimeMs = 24LL * 3600 * 1000; // Fraîcheur heuristique plafonnée à un jour
+const qint64 kMaxEntryShare = 16;          // Une entrée occupe au plus 1/16 du budget disque
+const qint64 kStreamBufferBytes = 512 * 1024; // Octets gardés par une réponse transmise au fil de l'eau
+
+qint64 nowMSecs()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+}
+
+HttpCache::HttpCache(const QString &directory, qint64 maxBytes, QObject *parent)
+    : QObject(parent)
+    , directory(directory)
+    , maxBytes(maxBytes)
+{
+    QDir().mkpath(directory + "/objects");
+    loadIndex();
+}
+
+HttpCache::~HttpCache()
+{
+    saveIndex();
+}
+
+void HttpCache::setCookieJar(QNetworkCookieJar *jar)
+{
+    QObject *owner = jar->parent();
+    network.setCookieJar(jar);
+    jar->setParent(owner); // setCookieJar() se l'approprie
+}
+
+void HttpCache::setCachedOrigins(const QStringList &list)
+{
+    origins.clear();
+    for (const QString &origin : list) {
+        const QUrl url(origin.trimmed());
+        if (url.isValid() && (url.scheme() == "http" || url.scheme() == "https")) {
+            origins.insert(originKey(url), url.scheme() + "://" + url.authority());
+        }
+    }
+}
+
+bool HttpCache::isCachedOrigin(const QUrl &url) const
+{
+    return (url.scheme() == "http" || url.scheme() == "https") && origins.contains(originKey(url));
+}
+
+QString HttpCache::originKey(const QUrl &url)
+{
+    // http://hote et http://hote:80 désignent la même origine
+    int port = url.port(-1);
+    if (port == (url.scheme() == "https" ? 443 : 80)) {
+        port = -1;
+    }
+    return url.host().toLower() + ':' + QString::number(port);
+}
+
+QUrl HttpCache::toCacheUrl(const QUrl &url)
+{
+    QUrl cacheUrl(url);
+    cacheUrl.setScheme(kScheme);
+    return cacheUrl;
+}
+
+QUrl HttpCache::toOriginUrl(const QUrl &cacheUrl) const
+{
+    if (cacheUrl.scheme() != kScheme) {
+        return cacheUrl;
+    }
+    QUrl url(cacheUrl);
+    const QUrl origin(origins.value(originKey(cacheUrl)));
+    url.setScheme(origin.isValid() && !origin.scheme().isEmpty() ? origin.scheme() : QString("http"));
+    return url;
+}
+
+void HttpCache::fetch(const QUrl &url, Callback done)
+{
+    const QString key = url.toString(QUrl::RemoveFragment);
+    const qint64 now = nowMSecs();
+
+    auto it = index.find(key);
+    if (it != index.end() && it->expiresAt > now) {
+        Response response;
+        if (readBlob(it->contentHash, response.body)) {
+            it->lastAccess = now;
+            ++hitCount;
+            response.ok = true;
+            response.mimeType = it->mimeType;
+            response.fromCache = true;
+            done(response);
+            return;
+        }
+        removeEntry(key); // Fichier du corps disparu : l'entrée n'est plus utilisable
+    }
+    fetchFromNetwork(url, key, done, true);
+}
+
+// conditional : une entrée périmée est revalidée (If-None-Match / If-Modified-Since)
+void HttpCache::fetchFromNetwork(const QUrl &url, const QString &key, const Callback &done, bool conditional)
+{
+    QNetworkRequest request(url);
+    // Les redirections sont rendues au moteur : la page doit prendre l'URL de sa cible
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    auto it = index.constFind(key);
+    if (conditional && it != index.constEnd()) {
+        // Entrée périmée : on demande au serveur si elle est toujours valable
+        if (!it->etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", it->etag);
+        }
+        if (!it->lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", it->lastModified);
+        }
+    }
+
+    QNetworkReply *reply = network.get(request);
+    // Corps annoncé trop gros pour une entrée : ni lu en entier, ni haché, ni gardé ; il est
+    // transmis tel qu'il arrive et l'éventuelle entrée périmée de l'URL disparaît
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply, key, done]() {
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200
+            || !reply->hasRawHeader("Content-Length")
+            || reply->header(QNetworkRequest::ContentLengthHeader).toLongLong() <= maxEntryBytes()) {
+            return;
+        }
+        reply->disconnect(this);
+        reply->setReadBufferSize(kStreamBufferBytes);
+        removeEntry(key);
+        ++missCount;
+        Response response;
+        response.ok = true;
+        response.status = 200;
+        response.mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toByteArray();
+        if (response.mimeType.isEmpty()) {
+            response.mimeType = "application/octet-stream";
+        }
+        response.stream = reply;
+        done(response);
+    });
+    connect(reply, &QNetworkReply::finished, this, [this, reply, url, key, done, conditional]() {
+        reply->deleteLater();
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        if (status == 304) {
+            auto cached = index.find(key);
+            Response response;
+            if (cached != index.end() && readBlob(cached->contentHash, response.body)) {
+                ++revalidationCount;
+                updateFreshness(*cached, reply);
+                cached->lastAccess = nowMSecs();
+                response.ok = true;
+                response.status = 200;
+                response.mimeType = cached->mimeType;
+                response.fromCache = true;
+                done(response);
+                return;
+            }
+            // Entrée évincée ou corps disparu pendant la revalidation : rien à resservir,
+            // la page est redemandée sans condition
+            removeEntry(key);
+            if (conditional) {
+                fetchFromNetwork(url, key, done, false);
+                return;
+            }
+        }
+
+        ++missCount;
+        if (status == 0 || status == 304) {
+            done(Response()); // Pas de réponse HTTP (réseau, TLS...), ou 304 sans condition
+            return;
+        }
+        // Les pages d'erreur du serveur (404, 500...) sont affichées, mais pas mises en cache
+        const Response response = networkResponse(url, reply, status);
+        if (status == 200) {
+            store(key, reply, response.body);
+        }
+        done(response);
+    });
+}
+
+void HttpCache::send(const QUrl &url, const QByteArray &method, const QMap<QByteArray, QByteArray> &headers,
+                     const QByteArray &body, Callback done)
+{
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
+        request.setRawHeader(it.key(), it.value());
+    }
+    QNetworkReply *reply = network.sendCustomRequest(request, method, body);
+    connect(reply, &QNetworkReply::finished, this, [reply, url, done]() {
+        reply->deleteLater();
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        done(status == 0 ? Response() : networkResponse(url, reply, status));
+    });
+}
+
+// Réponse HTTP reçue, telle que le moteur doit la voir : corps, type et cible d'une redirection
+HttpCache::Response HttpCache::networkResponse(const QUrl &url, QNetworkReply *reply, int status)
+{
+    Response response;
+    response.ok = true;
+    response.status = status;
+    response.body = reply->readAll();
+    response.mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toByteArray();
+    if (response.mimeType.isEmpty()) {
+        response.mimeType = "application/octet-stream";
+    }
+    const QUrl location = reply->header(QNetworkRequest::LocationHeader).toUrl();
+    if (status >= 300 && status < 400 && !location.isEmpty()) {
+        response.redirectUrl = url.resolved(location);
+    }
+    return response;
+}
+
+void HttpCache::prefetch(const QStringList &urls)
+{
+    const qint64 now = nowMSecs();
+    for (const QString &url : urls) {
+        if (!isCachedOrigin(QUrl(url)) || prefetchQueue.contains(url)) {
+            continue;
+        }
+        auto it = index.constFind(QUrl(url).toString(QUrl::RemoveFragment));
+        if (it == index.constEnd() || it->expiresAt <= now) {
+            prefetchQueue.append(url);
+        }
+    }
+    pumpPrefetch();
+}
+
+void HttpCache::pumpPrefetch()
+{
+    while (activePrefetches < kMaxParallelPrefetches && !prefetchQueue.isEmpty()) {
+        ++activePrefetches;
+        fetch(QUrl(prefetchQueue.takeFirst()), [this](const Response &response) {
+            if (response.stream) {
+                response.stream->deleteLater(); // Trop gros pour être mis en cache : rien à précharger
+            }
+            --activePrefetches;
+            pumpPrefetch();
+        });
+    }
+}
+
+qint64 HttpCache::maxEntryBytes() const
+{
+    return maxBytes / kMaxEntryShare;
+}
+
+QString HttpCache::blobPath(const QByteArray &hash) const
+{
+    // objects/ab/cdef... : évite des dizaines de milliers de fichiers dans un seul dossier
+    return directory + "/objects/" + QString::fromLatin1(hash.left(2)) + '/' + QString::fromLatin1(hash.mid(2));
+}
+
+bool HttpCache::readBlob(const QByteArray &hash, QByteArray &body) const
+{
+    QFile file(blobPath(hash));
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+    body = file.readAll();
+    return true;
+}
+
+void HttpCache::updateFreshness(Entry &entry, QNetworkReply *reply) const
+{
+    const qint64 now = nowMSecs();
+    qint64 lifetimeMs = -1;
+    bool noCache = false;
+    for (QByteArray directive : reply->rawHeader("Cache-Control").toLower().split(',')) {
+        directive = directive.trimmed();
+        if (directive == "no-cache") {
+            noCache = true;
+        } else if (directive.startsWith("max-age=")) {
+            lifetimeMs = directive.mid(8).toLongLong() * 1000;
+        }
+    }
+
+    const QDateTime lastModified = reply->header(QNetworkRequest::LastModifiedHeader).toDateTime();
+    if (noCache) {
+        lifetimeMs = 0; // À revalider à chaque utilisation
+    } else if (lifetimeMs < 0 && reply->hasRawHeader("Expires")) {
+        const QDateTime expires = QDateTime::fromString(QString::fromLatin1(reply->rawHeader("Expires")), Qt::RFC2822Date);
+        lifetimeMs = expires.isValid() ? expires.toMSecsSinceEpoch() - now : 0;
+    } else if (lifetimeMs < 0 && lastModified.isValid()) {
+        // Fraîcheur heuristique (RFC 9111) : 10 % de l'âge du document
+        lifetimeMs = qMin(kMaxHeuristicLifetimeMs, (now - lastModified.toMSecsSinceEpoch()) / 10);
+    }
+    entry.expiresAt = now + qMax<qint64>(0, lifetimeMs);
+
+    if (reply->hasRawHeader("ETag")) {
+        entry.etag = reply->rawHeader("ETag");
+    }
+    if (reply->hasRawHeader("Last-Modified")) {
+        entry.lastModified = reply->rawHeader("Last-Modified");
+    }
+}
+
+void HttpCache::store(const QString &key, QNetworkReply *reply, const QByteArray &body)
+{
+    // Une réponse qui ouvre ou modifie une session (Set-Cookie) n'est valable que cette fois ;
+    // un corps sans Content-Length peut aussi dépasser la taille maximale d'une entrée
+    if (reply->rawHeader("Cache-Control").toLower().contains("no-store") || reply->hasRawHeader("Set-Cookie")
+        || body.size() > maxEntryBytes()) {
+        removeEntry(key);
+        return;
+    }
+
+    Entry entry;
+    updateFreshness(entry, reply);
+    const qint64 now = nowMSecs();
+    if (entry.expiresAt <= now && entry.etag.isEmpty() && entry.lastModified.isEmpty()) {
+        removeEntry(key);
+        return; // Ni fraîche ni revalidable : la garder ne ferait gagner aucune requête
+    }
+    entry.contentHash = QCryptographicHash::hash(body, QCryptographicHash::Sha256).toHex();
+    entry.mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toByteArray();
+    entry.size = body.size();
+    entry.lastAccess = now;
+
+    removeEntry(key);
+    if (!blobRefs.contains(entry.contentHash)) {
+        const QString path = blobPath(entry.contentHash);
+        QDir().mkpath(QFileInfo(path).path());
+        QSaveFile file(path);
+        if (!file.open(QFile::WriteOnly) || file.write(body) != body.size() || !file.commit()) {
+            return;
+        }
+        totalBytes += entry.size;
+    }
+    blobRefs[entry.contentHash] += 1;
+    index.insert(key, entry);
+
+    evictToBudget();
+    if (++storesSinceSave >= kStoresBetweenIndexSaves) {
+        saveIndex();
+    }
+}
+
+void HttpCache::removeEntry(const QString &key)
+{
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return;
+    }
+    const QByteArray hash = it->contentHash;
+    const qint64 size = it->size;
+    index.erase(it);
+
+    // Le corps n'est supprimé que lorsque plus aucune URL ne le référence
+    if (--blobRefs[hash] <= 0) {
+        blobRefs.remove(hash);
+        QFile::remove(blobPath(hash));
+        totalBytes -= size;
+    }
+}
+
+void HttpCache::evictToBudget()
+{
+    if (totalBytes <= maxBytes) {
+        return;
+    }
+
+    // On descend à 90 % du budget pour ne pas trier l'index à chaque nouvelle réponse
+    QVector<QPair<qint64, QString>> byAccess;
+    byAccess.reserve(index.size());
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        byAccess.append({it->lastAccess, it.key()});
+    }
+    std::sort(byAccess.begin(), byAccess.end());
+
+    const qint64 target = maxBytes / 10 * 9;
+    for (const auto &candidate : byAccess) {
+        if (totalBytes <= target) {
+            break;
+        }
+        removeEntry(candidate.second);
+    }
+}
+
+void HttpCache::loadIndex()
+{
+    QFile file(directory + "/index.bin");
+    if (!file.open(QFile::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != kIndexMagic || version != kIndexVersion) {
+        return;
+    }
+
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        Entry entry;
+        in >> key >> entry.contentHash >> entry.mimeType >> entry.size >> entry.expiresAt
+           >> entry.lastAccess >> entry.etag >> entry.lastModified;
+        if (in.status() != QDataStream::Ok) {
+            break;
+        }
+        if (!blobRefs.contains(entry.contentHash)) {
+            totalBytes += entry.size;
+        }
+        blobRefs[entry.contentHash] += 1;
+        index.insert(key, entry);
+    }
+}
+
+void HttpCache::saveIndex() const
+{
+    QSaveFile file(directory + "/index.bin");
+    if (!file.open(QFile::WriteOnly)) {
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kIndexMagic << kIndexVersion << quint32(index.size());
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        out << it.key() << it->contentHash << it->mimeType << it->size << it->expiresAt
+            << it->lastAccess << it->etag << it->lastModified;
+    }
+    file.commit();
+}
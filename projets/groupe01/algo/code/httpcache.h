@@ -0,0 +1,122 @@
+// httpcache.h
+#ifndef HTTPCACHE_H
+#define HTTPCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+#include <functional>
+
+class QIODevice;
+class QNetworkCookieJar;
+class QNetworkReply;
+
+// Cache HTTP local pour les pages de l'intranet consultées en boucle.
+// Les corps de réponse sont rangés sur disque par contenu (SHA-256) : deux URL qui renvoient
+// le même contenu partagent le même fichier. L'index (URL -> empreinte, validité, ETag...)
+// respecte Cache-Control / Expires / Last-Modified, et les entrées les moins récemment
+// utilisées sont évincées au-delà du budget disque. Un corps de plus de maxEntryBytes() n'est
+// pas gardé : il est transmis au fur et à mesure de son arrivée, sans être mis en mémoire.
+//
+// QtWebEngine ne laisse pas une application servir elle-même http(s) : les origines mises
+// en cache sont donc redirigées (RequestInterceptor) vers le schéma kScheme, servi par
+// CacheSchemeHandler à partir de ce cache. Le cache vit dans le thread graphique.
+// Ses requêtes partent avec les cookies du profil web (setCookieJar) : les pages d'une
+// session ouverte sont demandées au nom de cette session.
+class HttpCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *kScheme = "ictu-cache";
+
+    struct Response {
+        bool ok = false;         // Réponse HTTP reçue, quel que soit son code
+        int status = 0;          // Code HTTP (200 pour une réponse servie par le cache)
+        QUrl redirectUrl;        // Cible absolue d'une redirection 3xx, à suivre par le moteur
+        QByteArray mimeType;
+        QByteArray body;
+        // Corps trop gros pour le cache, encore en cours de réception : à lire à la place de
+        // body. Le rappel en devient propriétaire (deleteLater s'il ne s'en sert pas).
+        QIODevice *stream = nullptr;
+        bool fromCache = false;
+    };
+    using Callback = std::function<void(const Response &)>;
+
+    HttpCache(const QString &directory, qint64 maxBytes, QObject *parent = nullptr);
+    ~HttpCache();
+
+    // Pot de cookies partagé avec d'autres gestionnaires : il garde son parent
+    void setCookieJar(QNetworkCookieJar *jar);
+
+    // Origines mises en cache, par exemple "http://intranet.ictu.local"
+    void setCachedOrigins(const QStringList &origins);
+    QStringList cachedOrigins() const { return origins.values(); }
+    bool isCachedOrigin(const QUrl &url) const;
+
+    // Conversions entre l'URL d'origine et l'URL servie par le schéma du cache
+    static QString originKey(const QUrl &url);
+    static QUrl toCacheUrl(const QUrl &url);
+    QUrl toOriginUrl(const QUrl &cacheUrl) const;
+
+    // Sert l'URL depuis le cache si elle est fraîche, sinon la (re)valide sur le réseau.
+    // Le rappel peut être appelé immédiatement (succès du cache) ou plus tard.
+    void fetch(const QUrl &url, Callback done);
+    // Met en cache en tâche de fond les URL qui ne sont pas déjà fraîches
+    void prefetch(const QStringList &urls);
+    // Transmet à l'origine une requête qui ne passe pas par le cache (POST d'un fetch() ou d'un
+    // XMLHttpRequest...), avec sa méthode, ses en-têtes et son corps ; rien n'est gardé
+    void send(const QUrl &url, const QByteArray &method, const QMap<QByteArray, QByteArray> &headers,
+              const QByteArray &body, Callback done);
+
+    qint64 hits() const { return hitCount; }
+    qint64 misses() const { return missCount; }
+    qint64 revalidations() const { return revalidationCount; }
+    qint64 sizeBytes() const { return totalBytes; }
+    qint64 maxEntryBytes() const; // Au-delà, une réponse n'est pas mise en cache
+    void saveIndex() const;
+
+private:
+    struct Entry {
+        QByteArray contentHash;  // Nom du fichier du corps (SHA-256 en hexadécimal)
+        QByteArray mimeType;
+        qint64 size = 0;
+        qint64 expiresAt = 0;    // Millisecondes depuis l'époque ; périmé au-delà
+        qint64 lastAccess = 0;   // Pour l'éviction LRU
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
+    QString directory;
+    qint64 maxBytes;
+    qint64 totalBytes = 0;          // Taille des corps distincts sur disque
+    QHash<QString, Entry> index;    // URL -> entrée
+    QHash<QByteArray, int> blobRefs; // Empreinte -> nombre d'URL qui la référencent
+    QHash<QString, QString> origins; // "hôte:port" -> origine configurée
+    QNetworkAccessManager network;
+    int storesSinceSave = 0;
+
+    QStringList prefetchQueue;
+    int activePrefetches = 0;
+
+    qint64 hitCount = 0;
+    qint64 missCount = 0;
+    qint64 revalidationCount = 0;
+
+    QString blobPath(const QByteArray &hash) const;
+    bool readBlob(const QByteArray &hash, QByteArray &body) const;
+    void fetchFromNetwork(const QUrl &url, const QString &key, const Callback &done, bool conditional);
+    static Response networkResponse(const QUrl &url, QNetworkReply *reply, int status);
+    void store(const QString &key, QNetworkReply *reply, const QByteArray &body);
+    void updateFreshness(Entry &entry, QNetworkReply *reply) const;
+    void removeEntry(const QString &key);
+    void evictToBudget();
+    void loadIndex();
+    void pumpPrefetch();
+};
+
+#endif // HTTPCACHE_H
@@ -1,11 +1,85 @@
 #include "mainwindow.h"
+#include "benchmarks.h"
+#include "httpcache.h"
+#include "searchschemehandler.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QWebEngineUrlScheme>
 
 int main(int argc, char *argv[])
 {
+    // Le schéma du cache HTTP doit être déclaré avant la création de l'application.
+    // Il se comporte comme http(s) : hôte, port, origine sécurisée, fetch() et CORS autorisés.
+    QWebEngineUrlScheme cacheScheme(HttpCache::kScheme);
+    cacheScheme.setSyntax(QWebEngineUrlScheme::Syntax::HostAndPort);
+    cacheScheme.setDefaultPort(80);
+    cacheScheme.setFlags(QWebEngineUrlScheme::SecureScheme | QWebEngineUrlScheme::CorsEnabled
+                         | QWebEngineUrlScheme::FetchApiAllowed);
+    QWebEngineUrlScheme::registerScheme(cacheScheme);
+    // Page de recherche dans les pages visitées : un chemin et une requête, sans hôte
+    QWebEngineUrlScheme searchScheme(SearchSchemeHandler::kScheme);
+    searchScheme.setSyntax(QWebEngineUrlScheme::Syntax::Path);
+    searchScheme.setFlags(QWebEngineUrlScheme::SecureScheme);
+    QWebEngineUrlScheme::registerScheme(searchScheme);
+
     QApplication a(argc, argv);
+
+    // Options de la ligne de commande ; les options inconnues (drapeaux Chromium) sont ignorées
+    QCommandLineParser parser;
+    QCommandLineOption memoryBudgetOption("tab-memory-budget", "Budget mémoire des onglets, en Mio.", "Mio");
+    QCommandLineOption processLimitOption("renderer-process-limit", "Nombre maximal de processus de rendu.", "n");
+    QCommandLineOption benchOmniboxOption("bench-omnibox", "Mesure l'autocomplétion sur un historique de n URL.", "n");
+    QCommandLineOption benchTabsOption("bench-tabs", "Mesure la mémoire de n onglets avant/après déchargement.", "n");
+    QCommandLineOption benchStartupOption("bench-startup", "Mesure le démarrage avec une session de n onglets.", "n");
+    QCommandLineOption benchCacheOption("bench-cache", "Mesure le cache HTTP sur n requêtes vers un serveur local.", "n");
+    QCommandLineOption benchBlockingOption("bench-blocking", "Mesure le blocage de 10 n URL avec n règles de filtrage.", "n");
+    QCommandLineOption benchSearchOption("bench-search", "Mesure l'index plein texte sur n pages synthétiques.", "n");
+    QCommandLineOption benchDownloadOption("bench-download", "Mesure le téléchargement d'un fichier de n Mio (plages, reprise).", "n");
+    QCommandLineOption benchBookmarksOption("bench-bookmarks", "Mesure l'import, la relecture et la recherche de n favoris.", "n");
+    parser.addOptions({memoryBudgetOption, processLimitOption, benchOmniboxOption, benchTabsOption, benchStartupOption,
+                       benchCacheOption, benchBlockingOption, benchSearchOption, benchDownloadOption, benchBookmarksOption});
+    parser.parse(a.arguments());
+
+    // Doit être positionné avant la création du premier onglet (démarrage du moteur Chromium)
+    if (parser.isSet(processLimitOption)) {
+        QByteArray flags = qgetenv("QTWEBENGINE_CHROMIUM_FLAGS");
+        flags += " --renderer-process-limit=" + parser.value(processLimitOption).toLatin1();
+        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", flags.trimmed());
+    }
+
+    if (parser.isSet(benchOmniboxOption)) {
+        return Benchmarks::omnibox(parser.value(benchOmniboxOption).toInt());
+    }
+    if (parser.isSet(benchTabsOption)) {
+        MainWindow w(nullptr, QString()); // Sans session : ni restauration ni sauvegarde
+        w.show();
+        return Benchmarks::tabMemory(w, parser.value(benchTabsOption).toInt());
+    }
+    if (parser.isSet(benchStartupOption)) {
+        return Benchmarks::sessionStartup(parser.value(benchStartupOption).toInt());
+    }
+    if (parser.isSet(benchCacheOption)) {
+        return Benchmarks::httpCache(parser.value(benchCacheOption).toInt());
+    }
+    if (parser.isSet(benchBlockingOption)) {
+        const int n = parser.value(benchBlockingOption).toInt();
+        return Benchmarks::filterMatching(n, 10 * n);
+    }
+    if (parser.isSet(benchSearchOption)) {
+        return Benchmarks::fullTextSearch(parser.value(benchSearchOption).toInt());
+    }
+    if (parser.isSet(benchDownloadOption)) {
+        return Benchmarks::downloads(parser.value(benchDownloadOption).toInt());
+    }
+    if (parser.isSet(benchBookmarksOption)) {
+        return Benchmarks::bookmarks(parser.value(benchBookmarksOption).toInt());
+    }
+
     MainWindow w;
+    if (parser.isSet(memoryBudgetOption)) {
+        w.setTabMemoryBudget(parser.value(memoryBudgetOption).toLongLong() * 1024 * 1024);
+    }
     w.show();
     return a.exec();
 }
@@ -2,24 +2,66 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h" // En-tête de l'interface utilisateur générée
 #include <QMessageBox>     // Optionnel : pour afficher les messages d'erreur
+#include <QDateTime>       // Horodatage des visites pour le classement des suggestions
+#include "omniboxindex.h"  // Index d'autocomplétion de la barre d'adresse
+#include "browsertab.h"     // Un onglet : vue web + historique de session
+#include "processmemory.h"  // Mémoire résidente du navigateur et de ses processus de rendu
+#include "sessionstore.h"   // Sauvegarde/restauration des onglets et de leur historique
+#include "httpcache.h"      // Cache HTTP local des pages de l'intranet
+#include "cacheschemehandler.h"
+#include "requestinterceptor.h"
+#include "webcookiejar.h"   // Cookies du profil web pour le cache HTTP et les téléchargements
+#include "contentfilter.h"  // Listes de filtres de blocage des publicités et pisteurs
+#include "pageindexer.h"    // Index plein texte des pages visitées
+#include "searchschemehandler.h"
+#include "diagnosticsdialog.h"  // Centiles des temps de navigation par hôte, export CSV/JSON
+#include "downloadmanager.h"    // Téléchargements en file, par plages parallèles, avec reprise
+#include "downloadsdialog.h"
+#include "bookmarkstore.h"      // Favoris : arbre de dossiers, fichier binaire compact, import/export HTML
+#include "bookmarksdialog.h"
+#include <QHash>
+#include <QShortcut>
+#include <QStatusBar>
+#include <QFileInfo>
+#include <QTabBar>
+#include <QToolButton>
+#include <QWebEngineDownloadRequest>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+#include <QWebEngineView>
+#include <algorithm>
 
-MainWindow::MainWindow(QWidget *parent)
+namespace {
+const char *const kStartPage = "https://www.google.com"; // Page des nouveaux onglets
+const int kMemoryCheckIntervalMs = 5000;                 // Fréquence de contrôle du budget mémoire
+const qint64 kDefaultTabMemoryBudget = qint64(1536) * 1024 * 1024; // 1,5 Gio pour tout le navigateur
+const int kTabTitleLength = 24;                          // Longueur maximale d'un titre d'onglet
+const qint64 kHttpCacheBudget = qint64(256) * 1024 * 1024; // Espace disque du cache HTTP
+const int kPrefetchIdleMs = 30000;                       // Inactivité avant le préchargement
+const int kPrefetchCount = 20;                           // Nombre d'URL préchargées
+}
+
+MainWindow::MainWindow(QWidget *parent, const QString &sessionFile)
     : QMainWindow(parent) // Appelle le constructeur de la classe de base
     , ui(new Ui::MainWindow) // Initialise l'objet UI
+    , tabMemoryBudget(kDefaultTabMemoryBudget)
 {
     ui->setupUi(this); // Configure les éléments de l'interface utilisateur définis dans mainwindow.ui
     this->setStyleSheet("background-image: url(C:/Users/Lenovo/OneDrive/Documenten/NAVIGATEUR/360_F_1440411675_8EUXKOnS3deAKGXMbqLob9ZWzvZVzHHp.jpg); background-repeat no-repeat; background-position: center;");
     this->setWindowIcon(QIcon("C:/Users/Lenovo/OneDrive/Documenten/NAVIGATEUR/apps_web_browser_15742.ico"));
     this->showMaximized(); // Affiche la fenêtre maximisée
 
-    // 1. Créer et ajouter le QWebEngineView
-    webView = new QWebEngineView(this);
+    // 1. Créer et ajouter la barre d'onglets (chaque onglet contient son QWebEngineView)
+    tabs = new QTabWidget(this);
+    tabs->setTabsClosable(true);
+    tabs->setMovable(true);
+    tabs->setDocumentMode(true);
     // En supposant que ui->verticalLayout est la disposition principale de votre widget central
-    // Ajoute la vue web à la disposition, de sorte qu'elle occupe la zone de contenu principale.
-    ui->verticalLayout->addWidget(webView);
+    // Ajoute les onglets à la disposition, de sorte qu'ils occupent la zone de contenu principale.
+    ui->verticalLayout->addWidget(tabs);
     this->setWindowTitle("ICTU SEARCH"); // Définit le titre initial de la fenêtre
-    // Faire en sorte que la vue web s'étende pour remplir l'espace disponible
-    webView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    // Faire en sorte que les onglets s'étendent pour remplir l'espace disponible
+    tabs->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     // Supprimer les marges et l'espacement pour la disposition contenant la vue web
     ui->verticalLayout->setContentsMargins(0, 0, 0, 0);
     ui->verticalLayout->setSpacing(0);
@@ -30,71 +72,183 @@ MainWindow::MainWindow(QWidget *parent)
 
     // this->setWindowIcon(QIcon("C:/Users/Lenovo/Desktop/b2/apps_web_browser_15742.ico"));
 
-    // Initialiser currentString à une URL vide
-    currentString = "";
+    // Autocomplétion : l'index vit dans son propre thread, seules les suggestions reviennent ici
+    completionModel = new QStringListModel(this);
+    completer = new QCompleter(completionModel, this);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion); // Le filtrage est fait par l'index
+    completer->setMaxVisibleItems(10);
+    ui->inputLineEdit->setCompleter(completer);
+
+    omniboxIndex = new OmniboxIndex;
+    omniboxIndex->moveToThread(&omniboxThread);
+    connect(&omniboxThread, &QThread::finished, omniboxIndex, &QObject::deleteLater);
+    connect(omniboxIndex, &OmniboxIndex::suggestionsReady, this, &MainWindow::onSuggestionsReady);
+    omniboxThread.start();
+    const QString historyPath = historyFilePath();
+    QMetaObject::invokeMethod(omniboxIndex, [this, historyPath]() {
+        omniboxIndex->loadHistory(historyPath);
+    }, Qt::QueuedConnection);
+
+    // Favoris : chargés ici, puis transmis à l'index d'autocomplétion qui les classe plus haut
+    bookmarkStore = new BookmarkStore(QCoreApplication::applicationDirPath() + "/bookmarks.bin", this);
+    bookmarkStore->load();
+    QStringList bookmarkUrls;
+    QStringList bookmarkTitles;
+    QVector<qint64> bookmarkDates;
+    bookmarkStore->bookmarks(bookmarkUrls, bookmarkTitles, bookmarkDates);
+    QMetaObject::invokeMethod(omniboxIndex, [this, bookmarkUrls, bookmarkTitles, bookmarkDates]() {
+        omniboxIndex->loadBookmarks(bookmarkUrls, bookmarkTitles, bookmarkDates);
+    }, Qt::QueuedConnection);
+    connect(bookmarkStore, &BookmarkStore::bookmarkedChanged, this,
+            [this](const QString &url, const QString &title, bool bookmarked, qint64 addedSecs) {
+        QMetaObject::invokeMethod(omniboxIndex, [this, url, title, bookmarked, addedSecs]() {
+            omniboxIndex->setBookmarked(url, title, bookmarked, addedSecs);
+        }, Qt::QueuedConnection);
+        updateBookmarkButton();
+    });
+    bookmarkButton = new QToolButton(this);
+    bookmarkButton->setAutoRaise(true);
+    statusBar()->addPermanentWidget(bookmarkButton);
+    connect(bookmarkButton, &QToolButton::clicked, this, &MainWindow::toggleBookmark);
+    updateBookmarkButton();
 
     // 3. Connecter les signaux de l'interface utilisateur aux slots
     // Connecter la touche Entrée dans lineEdit au slot du bouton "Go"
     connect(ui->inputLineEdit, &QLineEdit::returnPressed, this, &MainWindow::on_setButton_clicked);
-    // Connecter le bouton Retour à son slot
-    connect(ui->prevButton, &QPushButton::clicked, this, &MainWindow::on_prevButton_clicked);
-    // Connecter le bouton Avance à son slot
-    connect(ui->nextButton, &QPushButton::clicked, this, &MainWindow::on_nextButton_clicked);
-    // Connecter le bouton Go à son slot (s'il n'est pas géré par lineEdit returnPressed)
-    connect(ui->setButton, &QPushButton::clicked, this, &MainWindow::on_setButton_clicked);
-
-
-    // 4. Connecter les signaux de QWebEngineView aux mises à jour de l'interface utilisateur
-    // Lorsque l'URL de la vue web change, mettez à jour l'étiquette d'affichage de l'URL
-    connect(webView, &QWebEngineView::urlChanged, this, [this](const QUrl &url){
-        ui->displayLabel->setText(url.toString()); // Met à jour l'étiquette avec la nouvelle URL
-        // Si l'URL change PAS à cause d'une action de l'utilisateur, mettez à jour currentString et l'historique
-        // Cela gère les redirections ou les liens cliqués dans la vue web.
-        if (url.toString() != currentString) {
-            if (!currentString.isEmpty()) {
-                backStack.push(currentString); // Ajoute l'URL actuelle à la pile "arrière"
-            }
-            currentString = url.toString(); // Définit la nouvelle URL comme l'URL actuelle
-            forwardStack.clear(); // Toute nouvelle navigation efface l'historique "avant"
-            updateButtonStates(); // Met à jour l'état des boutons
-            saveStringToFile(currentString); // Sauvegarde la nouvelle URL dans le fichier
-        }
+    // Les boutons Retour, Avance et Go sont déjà reliés par setupUi() (connectSlotsByName sur
+    // les slots on_<objet>_clicked) : les connecter une seconde fois déclencherait deux fois le slot.
+    // Chaque frappe dans la barre d'adresse relance le calcul des suggestions
+    connect(ui->inputLineEdit, &QLineEdit::textEdited, this, &MainWindow::onInputTextEdited);
+    // Choisir une suggestion charge directement la page
+    connect(completer, QOverload<const QString &>::of(&QCompleter::activated), this, [this](const QString &url) {
+        ui->inputLineEdit->setText(url);
+        on_setButton_clicked();
     });
 
-    // Lorsque le titre de la vue web change, mettez à jour le titre de la fenêtre
-    connect(webView, &QWebEngineView::titleChanged, this, &QMainWindow::setWindowTitle);
+
+    // 4. Onglets : chaque onglet possède sa vue web et son historique ; les signaux de
+    // l'onglet courant mettent à jour la barre d'adresse et les boutons
+    connect(tabs, &QTabWidget::currentChanged, this, &MainWindow::onCurrentTabChanged);
+    connect(tabs, &QTabWidget::tabCloseRequested, this, &MainWindow::closeTab);
+    connect(tabs->tabBar(), &QTabBar::tabMoved, this, &MainWindow::scheduleSessionSave);
+    QToolButton *newTabButton = new QToolButton(tabs);
+    newTabButton->setText("+");
+    newTabButton->setToolTip("Nouvel onglet (Ctrl+T)");
+    tabs->setCornerWidget(newTabButton, Qt::TopRightCorner);
+    connect(newTabButton, &QToolButton::clicked, this, [this]() { openTab(QUrl(kStartPage), true); });
+    new QShortcut(QKeySequence::AddTab, this, [this]() { openTab(QUrl(kStartPage), true); });
+    new QShortcut(QKeySequence::Close, this, [this]() { closeTab(tabs->currentIndex()); });
+    new QShortcut(QKeySequence("Ctrl+Shift+D"), this, [this]() { showDiagnostics(); });
+    new QShortcut(QKeySequence("Ctrl+J"), this, [this]() { showDownloads(); });
+    new QShortcut(QKeySequence("Ctrl+D"), this, [this]() { toggleBookmark(); });
+    new QShortcut(QKeySequence("Ctrl+Shift+O"), this, [this]() { showBookmarks(); });
+
+    // Cache HTTP : les requêtes vers les origines configurées sont redirigées vers le schéma
+    // du cache, qui répond depuis le disque ou revalide auprès du serveur
+    httpCache = new HttpCache(QCoreApplication::applicationDirPath() + "/cache", kHttpCacheBudget, this);
+    httpCache->setCachedOrigins(readCachedOrigins());
+    // Le cache demande les pages avec les cookies du profil : une session ouverte dans une page
+    // (intranet authentifié) vaut aussi pour lui, et les cookies qu'il reçoit reviennent au moteur
+    cookieJar = new WebCookieJar(QWebEngineProfile::defaultProfile()->cookieStore(), this);
+    httpCache->setCookieJar(cookieJar);
+    QHash<QString, QString> cachedOrigins;
+    for (const QString &origin : httpCache->cachedOrigins()) {
+        cachedOrigins.insert(HttpCache::originKey(QUrl(origin)), QUrl(origin).scheme());
+    }
+    cacheSchemeHandler = new CacheSchemeHandler(httpCache, this);
+    requestInterceptor = new RequestInterceptor(cachedOrigins, this);
+    QWebEngineProfile::defaultProfile()->installUrlSchemeHandler(HttpCache::kScheme, cacheSchemeHandler);
+    QWebEngineProfile::defaultProfile()->setUrlRequestInterceptor(requestInterceptor);
+    // Blocage des publicités et pisteurs : les listes filters/*.txt sont compilées (ou relues
+    // depuis filters.bin) hors du thread graphique ; le moteur est branché dès qu'il est prêt
+    const QString appDir = QCoreApplication::applicationDirPath();
+    filterThread = QThread::create([this, appDir]() {
+        requestInterceptor->setFilterEngine(ContentFilter::load(appDir + "/filters", appDir + "/filters.bin"));
+    });
+    filterThread->start();
+    // Recherche plein texte : le texte de chaque page chargée est indexé dans un thread de
+    // basse priorité ; les résultats sont servis par le schéma ictu-search
+    pageIndexer = new PageIndexer(appDir + "/search_index");
+    pageIndexer->moveToThread(&indexerThread);
+    connect(&indexerThread, &QThread::finished, pageIndexer, &QObject::deleteLater);
+    indexerThread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(pageIndexer, [this]() { pageIndexer->open(); }, Qt::QueuedConnection);
+    searchSchemeHandler = new SearchSchemeHandler(pageIndexer, this);
+    QWebEngineProfile::defaultProfile()->installUrlSchemeHandler(SearchSchemeHandler::kScheme, searchSchemeHandler);
+    ui->inputLineEdit->setPlaceholderText("Adresse, ou « ? mots » pour chercher dans les pages visitées");
+    // Téléchargements : les fichiers interrompus lors d'une session précédente sont proposés en pause
+    downloadManager = new DownloadManager(this);
+    downloadManager->setCookieJar(cookieJar);
+    downloadManager->restoreInterrupted(QWebEngineProfile::defaultProfile()->downloadPath());
+    connect(QWebEngineProfile::defaultProfile(), &QWebEngineProfile::downloadRequested,
+            this, &MainWindow::onDownloadRequested);
+    // Après kPrefetchIdleMs sans navigation, les pages les plus fréquentées sont préchargées
+    prefetchTimer.setSingleShot(true);
+    prefetchTimer.setInterval(kPrefetchIdleMs);
+    connect(&prefetchTimer, &QTimer::timeout, this, &MainWindow::prefetchTopSites);
+    connect(omniboxIndex, &OmniboxIndex::topVisitedReady, httpCache, &HttpCache::prefetch);
+    if (!cachedOrigins.isEmpty()) {
+        prefetchTimer.start();
+    }
+
+    // Budget mémoire : au-delà, les onglets en arrière-plan les moins récemment utilisés sont déchargés
+    baselineMemory = ProcessMemory::residentBytes();
+    connect(&memoryTimer, &QTimer::timeout, this, &MainWindow::enforceMemoryBudget);
+    memoryTimer.start(kMemoryCheckIntervalMs);
 
     // 5. Définir les états initiaux des boutons
     updateButtonStates();
 
-    // 6. Charger une page par défaut au démarrage (optionnel)
-    onLoadUrl("https://www.google.com");
+    // 6. Restaurer la session précédente ; à défaut, charger une page par défaut
+    if (!sessionFile.isEmpty()) {
+        SessionData session;
+        if (SessionStore::readFile(sessionFile, session) && !session.tabs.isEmpty()) {
+            restoreSession(session);
+        } else {
+            openTab(QUrl(kStartPage), true);
+        }
+        // Créée après la restauration : les onglets restaurés ne déclenchent pas de réécriture
+        sessionStore = new SessionStore(sessionFile, [this]() { return captureSession(); }, this);
+    }
 }
 
 MainWindow::~MainWindow()
 {
-    delete ui; // Supprime l'objet UI (ce qui supprime également webView car c'est un enfant)
+    // Dernière sauvegarde de la session, tant que les onglets existent encore
+    if (sessionStore) {
+        sessionStore->saveNow();
+    }
+    // Arrête le thread d'autocomplétion (l'index est détruit par deleteLater)
+    omniboxThread.quit();
+    omniboxThread.wait();
+    // L'index plein texte écrit ses dernières pages sur disque à sa destruction
+    indexerThread.quit();
+    indexerThread.wait();
+    filterThread->wait();
+    delete filterThread;
+    // Le profil par défaut survit à la fenêtre : il ne doit plus référencer le cache ni les filtres
+    QWebEngineProfile::defaultProfile()->removeUrlSchemeHandler(cacheSchemeHandler);
+    QWebEngineProfile::defaultProfile()->removeUrlSchemeHandler(searchSchemeHandler);
+    QWebEngineProfile::defaultProfile()->setUrlRequestInterceptor(nullptr);
+    disconnect(QWebEngineProfile::defaultProfile(), nullptr, this, nullptr);
+    delete ui; // Supprime l'objet UI (ce qui supprime également les onglets car ce sont des enfants)
 }
 
 // Slot pour le bouton "Retour" (prevButton)
 void MainWindow::on_prevButton_clicked()
 {
-    if (!backStack.isEmpty()) { // S'il y a des URL dans la pile "arrière"
-        // Pousser l'URL actuelle dans forwardStack avant de revenir en arrière
-        forwardStack.push(currentString);
-        QString previousUrl = backStack.pop(); // Récupère l'URL précédente
-        onLoadUrl(previousUrl); // Charge l'URL précédente
+    if (BrowserTab *tab = currentTab()) {
+        tab->goBack(); // Revient à la page précédente de l'onglet courant
+        ui->displayLabel->setText(displayUrl(tab->url()).toString());
     }
 }
 
 // Slot pour le bouton "Avance" (nextButton)
 void MainWindow::on_nextButton_clicked()
 {
-    if (!forwardStack.isEmpty()) { // S'il y a des URL dans la pile "avant"
-        // Pousser l'URL actuelle dans backStack avant d'aller en avant
-        backStack.push(currentString);
-        QString nextUrl = forwardStack.pop(); // Récupère l'URL suivante
-        onLoadUrl(nextUrl); // Charge l'URL suivante
+    if (BrowserTab *tab = currentTab()) {
+        tab->goForward(); // Avance à la page suivante de l'onglet courant
+        ui->displayLabel->setText(displayUrl(tab->url()).toString());
     }
 }
 
@@ -104,13 +258,7 @@ void MainWindow::on_setButton_clicked()
     QString url = ui->inputLineEdit->text().trimmed(); // Récupère l'URL du champ de saisie
 
     if (!url.isEmpty()) { // Si l'URL n'est pas vide
-        // S'il y a une URL actuelle, poussez-la dans backStack pour l'historique
-        if (!currentString.isEmpty()) {
-            backStack.push(currentString);
-        }
-        currentString = url; // Définir la nouvelle URL comme actuelle
-        onLoadUrl(currentString); // Charger l'URL
-        forwardStack.clear(); // Effacer l'historique "avant" car nous commençons un nouveau chemin
+        onLoadUrl(url); // Charger l'URL ; l'historique est mis à jour par urlChanged
     }
     ui->inputLineEdit->clear(); // Effacer le champ de saisie
 }
@@ -119,33 +267,39 @@ void MainWindow::on_setButton_clicked()
 void MainWindow::onLoadUrl(const QString &url)
 {
     QString finalUrl = url; // Copie l'URL pour la manipulation
+    // "? mots" : recherche dans le texte des pages visitées
+    if (finalUrl.startsWith('?')) {
+        finalUrl = SearchSchemeHandler::searchUrl(finalUrl.mid(1).trimmed()).toString();
+    }
     // Préfixer "https://" si l'URL ne commence pas par un schéma
-    if (!finalUrl.contains("://") && !finalUrl.startsWith("file:///")) {
+    if (!finalUrl.contains("://") && !finalUrl.startsWith("file:///")
+        && !finalUrl.startsWith(QString(SearchSchemeHandler::kScheme) + ':')) {
         finalUrl = "https://" + finalUrl;
     }
 
-    webView->load(QUrl(finalUrl)); // Charge l'URL dans le QWebEngineView
+    BrowserTab *tab = currentTab();
+    if (!tab) {
+        tab = openTab(QUrl(), true); // Plus aucun onglet ouvert : on en recrée un
+    }
+    tab->load(QUrl(finalUrl)); // Charge l'URL dans l'onglet courant
     ui->displayLabel->setText(finalUrl);   // Met à jour l'étiquette avec l'URL
 
-    // Nous ne poussons pas directement dans les piles d'historique ici.
-    // Le signal webView->urlChanged gérera cela pour toutes les navigations
-    // (saisie utilisateur, liens internes, redirections, retour/avant).
+    // Nous ne poussons pas directement dans l'historique ici, ni dans le fichier :
+    // le signal pageVisited de l'onglet gérera cela pour toutes les navigations
+    // (saisie utilisateur, liens internes, redirections), une seule fois par visite.
 
-    saveStringToFile(finalUrl);     // Sauvegarde l'URL chargée dans le fichier
     updateButtonStates();           // Met à jour l'état des boutons
 }
 
 
-// Fonction d'aide pour sauvegarder une chaîne (URL) dans un fichier dans le répertoire de l'EXE
+// Fonction d'aide pour sauvegarder une chaîne (URL) dans un fichier dans le répertoire de l'EXE,
+// suivie de l'heure de la visite : l'autocomplétion retrouve ainsi la récence réelle au démarrage
 void MainWindow::saveStringToFile(const QString &str)
 {
-    QString appDirPath = QCoreApplication::applicationDirPath(); // Obtient le répertoire de l'application
-    QString filePath = appDirPath + "/entered_strings.txt"; // Construit le chemin complet du fichier
-
-    QFile file(filePath); // Crée un objet QFile
+    QFile file(historyFilePath()); // Crée un objet QFile (entered_strings.txt dans le répertoire de l'application)
     if (file.open(QFile::Append | QFile::Text)) { // Ouvre le fichier en mode ajout de texte
         QTextStream out(&file); // Crée un flux de texte pour écrire
-        out << str << "\n"; // Écrit la chaîne suivie d'un retour à la ligne
+        out << str << '\t' << QDateTime::currentSecsSinceEpoch() << "\n"; // URL, tabulation, secondes Unix
         file.close(); // Ferme le fichier
     } else {
         QMessageBox::warning(this, "Erreur de fichier", "Impossible d'ouvrir le fichier en écriture : " + file.errorString()); // Affiche un message d'erreur si l'ouverture échoue
@@ -155,6 +309,387 @@ void MainWindow::saveStringToFile(const QString &str)
 // Fonction d'aide pour mettre à jour l'état activé des boutons de navigation
 void MainWindow::updateButtonStates()
 {
-    ui->prevButton->setEnabled(!backStack.isEmpty());   // Active le bouton "Retour" si la pile "arrière" n'est pas vide
-    ui->nextButton->setEnabled(!forwardStack.isEmpty()); // Active le bouton "Avance" si la pile "avant" n'est pas vide
+    BrowserTab *tab = currentTab();
+    ui->prevButton->setEnabled(tab && tab->canGoBack());    // Active le bouton "Retour" s'il y a une page avant
+    ui->nextButton->setEnabled(tab && tab->canGoForward()); // Active le bouton "Avance" s'il y a une page après
+}
+
+BrowserTab *MainWindow::currentTab() const
+{
+    return qobject_cast<BrowserTab *>(tabs->currentWidget());
+}
+
+int MainWindow::tabCount() const
+{
+    return tabs->count();
+}
+
+BrowserTab *MainWindow::tabAt(int index) const
+{
+    return qobject_cast<BrowserTab *>(tabs->widget(index));
+}
+
+// Ouvre un onglet ; une URL vide donne un onglet vierge
+BrowserTab *MainWindow::openTab(const QUrl &url, bool makeCurrent)
+{
+    BrowserTab *tab = new BrowserTab(QWebEngineProfile::defaultProfile(), tabs);
+    const int index = tabs->addTab(tab, "Nouvel onglet");
+
+    // Les mises à jour d'interface ne concernent que l'onglet courant, l'historique et
+    // l'autocomplétion concernent tous les onglets
+    connect(tab, &BrowserTab::urlChanged, this, [this, tab](const QUrl &pageUrl) {
+        const QString visited = displayUrl(pageUrl).toString();
+        if (tab == currentTab()) {
+            ui->displayLabel->setText(visited); // Met à jour l'étiquette avec la nouvelle URL
+            updateBookmarkButton();
+        }
+        if (prefetchTimer.isActive()) {
+            prefetchTimer.start(); // Le navigateur n'est pas inactif : on repousse le préchargement
+        }
+        // Mise à jour incrémentale de l'index d'autocomplétion (dans son thread)
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        QMetaObject::invokeMethod(omniboxIndex, [this, visited, now]() {
+            omniboxIndex->recordVisit(visited, now);
+        }, Qt::QueuedConnection);
+    });
+    connect(tab, &BrowserTab::pageVisited, this, [this](const QUrl &pageUrl) {
+        saveStringToFile(displayUrl(pageUrl).toString()); // Sauvegarde la nouvelle URL dans le fichier
+    });
+    connect(tab, &BrowserTab::historyChanged, this, [this, tab]() {
+        if (tab == currentTab()) {
+            updateButtonStates(); // Met à jour l'état des boutons
+        }
+        scheduleSessionSave(); // Toute navigation modifie la session
+    });
+    connect(tab, &BrowserTab::titleChanged, this, [this, tab](const QString &title) {
+        const int tabIndex = tabs->indexOf(tab);
+        tabs->setTabText(tabIndex, title.left(kTabTitleLength));
+        tabs->setTabToolTip(tabIndex, title);
+        if (tab == currentTab()) {
+            setWindowTitle(title); // Le titre de la fenêtre suit celui de l'onglet courant
+        }
+        scheduleSessionSave();
+        // Le titre est aussi indexé pour que l'autocomplétion trouve la page par ses mots
+        const QString pageUrl = displayUrl(tab->url()).toString();
+        QMetaObject::invokeMethod(omniboxIndex, [this, pageUrl, title]() {
+            omniboxIndex->updateTitle(pageUrl, title);
+        }, Qt::QueuedConnection);
+    });
+
+    connect(tab, &BrowserTab::loadFinished, this, [this, tab](bool ok) {
+        if (ok) {
+            indexPage(tab);
+        }
+    });
+    connect(tab, &BrowserTab::navigationTimed, this, [this](const NavigationTiming &timing) {
+        NavigationTiming t = timing;
+        t.url = displayUrl(t.url); // Une page servie par le cache compte pour son hôte d'origine
+        navigationLog.append(t);
+        if (diagnosticsDialog && diagnosticsDialog->isVisible()) {
+            diagnosticsDialog->refresh();
+        }
+    });
+
+    if (!url.isEmpty()) {
+        tab->load(url);
+    }
+    if (makeCurrent) {
+        tabs->setCurrentIndex(index);
+    }
+    return tab;
+}
+
+void MainWindow::closeTab(int index)
+{
+    BrowserTab *tab = tabAt(index);
+    if (!tab) {
+        return;
+    }
+    tabs->removeTab(index);
+    tab->deleteLater(); // Détruit la vue web et libère son processus de rendu
+    scheduleSessionSave();
+}
+
+void MainWindow::onCurrentTabChanged(int index)
+{
+    BrowserTab *tab = tabAt(index);
+    if (!tab) {
+        ui->displayLabel->clear();
+        updateButtonStates();
+        updateBookmarkButton();
+        return;
+    }
+    tab->activate(); // Un onglet déchargé ou restauré est chargé seulement maintenant
+    ui->displayLabel->setText(displayUrl(tab->url()).toString());
+    setWindowTitle(tab->title().isEmpty() ? QString("ICTU SEARCH") : tab->title());
+    updateButtonStates();
+    updateBookmarkButton();
+    scheduleSessionSave();
+}
+
+QString MainWindow::defaultSessionFile()
+{
+    return QCoreApplication::applicationDirPath() + "/session.bin";
+}
+
+SessionData MainWindow::captureSession() const
+{
+    SessionData session;
+    session.activeTab = tabs->currentIndex();
+    session.tabs.reserve(tabs->count());
+    for (int i = 0; i < tabs->count(); ++i) {
+        session.tabs.append(tabAt(i)->saveState());
+    }
+    return session;
+}
+
+// Recrée les onglets de la session : seul l'onglet actif charge sa page, les autres
+// attendent d'être sélectionnés
+void MainWindow::restoreSession(const SessionData &session)
+{
+    for (const TabState &state : session.tabs) {
+        openTab(QUrl(), false)->restoreState(state);
+    }
+    tabs->setCurrentIndex(qBound(0, session.activeTab, tabs->count() - 1));
+    // Le premier onglet ajouté est devenu courant avant d'avoir son historique : on
+    // (ré)active explicitement l'onglet courant maintenant qu'il est restauré
+    onCurrentTabChanged(tabs->currentIndex());
+}
+
+void MainWindow::scheduleSessionSave()
+{
+    if (sessionStore) {
+        sessionStore->scheduleSave();
+    }
+}
+
+void MainWindow::setTabMemoryBudget(qint64 bytes)
+{
+    tabMemoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+// Décharge au plus maxCount onglets en arrière-plan, du moins récemment utilisé au plus récent
+int MainWindow::discardBackgroundTabs(int maxCount)
+{
+    QVector<BrowserTab *> candidates;
+    for (int i = 0; i < tabs->count(); ++i) {
+        BrowserTab *tab = tabAt(i);
+        if (tab != currentTab() && tab->isLive()) {
+            candidates.append(tab);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](BrowserTab *a, BrowserTab *b) {
+        return a->lastActivatedMSecs() < b->lastActivatedMSecs();
+    });
+
+    int discarded = 0;
+    for (BrowserTab *tab : candidates) {
+        if (discarded >= maxCount) {
+            break;
+        }
+        if (tab->discard()) {
+            ++discarded;
+        }
+    }
+    return discarded;
+}
+
+// Contrôle périodique : si le navigateur dépasse son budget, on décharge juste assez d'onglets
+void MainWindow::enforceMemoryBudget()
+{
+    int liveTabs = 0;
+    for (int i = 0; i < tabs->count(); ++i) {
+        liveTabs += tabAt(i)->isLive() ? 1 : 0;
+    }
+    // Les processus de rendu ne changent guère qu'avec les onglets ouverts ou chargés : la liste
+    // des processus n'est refaite qu'à ce moment-là
+    const bool rescan = tabs->count() != memoryTabCount || liveTabs != memoryLiveTabs;
+    memoryTabCount = tabs->count();
+    memoryLiveTabs = liveTabs;
+    const qint64 resident = ProcessMemory::residentBytes(rescan);
+    if (resident <= tabMemoryBudget) {
+        return;
+    }
+    if (liveTabs <= 1) {
+        return; // Seul l'onglet courant est chargé : rien à décharger
+    }
+
+    // Coût moyen d'un onglet chargé, au-delà de la mémoire du navigateur sans onglet
+    const qint64 perTab = qMax<qint64>(1, (resident - baselineMemory) / liveTabs);
+    const qint64 excess = resident - tabMemoryBudget;
+    discardBackgroundTabs(static_cast<int>((excess + perTab - 1) / perTab));
+}
+
+// Origines à mettre en cache : une par ligne dans cached_origins.txt ("#" pour un commentaire)
+QStringList MainWindow::readCachedOrigins()
+{
+    QStringList origins;
+    QFile file(QCoreApplication::applicationDirPath() + "/cached_origins.txt");
+    if (file.open(QFile::ReadOnly | QFile::Text)) {
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            const QString line = in.readLine().trimmed();
+            if (!line.isEmpty() && !line.startsWith('#')) {
+                origins.append(line);
+            }
+        }
+    }
+    return origins;
+}
+
+QUrl MainWindow::displayUrl(const QUrl &url) const
+{
+    return httpCache->toOriginUrl(url);
+}
+
+// Navigateur inactif : l'index d'autocomplétion fournit les URL les mieux classées, le cache
+// télécharge celles des origines mises en cache qui ne sont pas déjà fraîches
+void MainWindow::prefetchTopSites()
+{
+    QMetaObject::invokeMethod(omniboxIndex, [this]() {
+        omniboxIndex->topVisited(kPrefetchCount);
+    }, Qt::QueuedConnection);
+    prefetchTimer.start();
+}
+
+// Extrait le texte de la page de l'onglet (de façon asynchrone, par le processus de rendu)
+// et le transmet à l'index plein texte
+void MainWindow::indexPage(BrowserTab *tab)
+{
+    const QUrl pageUrl = displayUrl(tab->url());
+    if (!tab->view() || (pageUrl.scheme() != "http" && pageUrl.scheme() != "https")) {
+        return;
+    }
+    const QString url = pageUrl.toString();
+    const QString title = tab->title();
+    tab->view()->page()->toPlainText([this, url, title](const QString &text) {
+        QMetaObject::invokeMethod(pageIndexer, [this, url, title, text]() {
+            pageIndexer->enqueue(url, title, text);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// Fenêtre de diagnostic (Ctrl+Maj+D), créée à la première ouverture
+void MainWindow::showDiagnostics()
+{
+    if (!diagnosticsDialog) {
+        diagnosticsDialog = new DiagnosticsDialog(&navigationLog, this);
+    }
+    diagnosticsDialog->refresh();
+    diagnosticsDialog->show();
+    diagnosticsDialog->raise();
+    diagnosticsDialog->activateWindow();
+}
+
+// Les téléchargements http(s) sont repris au moteur web pour être faits par plages parallèles
+// et pouvoir reprendre ; le DownloadManager partage les cookies du profil, un fichier réservé
+// à une session ouverte est donc obtenu aussi. Restent au moteur les autres schémas (blob:,
+// data:...) et les réponses à un formulaire : un GET ne les redemanderait pas à l'identique.
+// Un fichier d'une origine mise en cache est demandé à l'origine, pas au schéma du cache.
+void MainWindow::onDownloadRequested(QWebEngineDownloadRequest *request)
+{
+    const QUrl url = displayUrl(request->url());
+    if ((url.scheme() != "http" && url.scheme() != "https") || requestInterceptor->wasPosted(url)) {
+        request->accept();
+        return;
+    }
+    request->cancel();
+    // Même URL déjà en file, en pause ou interrompue : on la reprend plutôt que de repartir de zéro
+    if (const int id = downloadManager->findUnfinished(url)) {
+        downloadManager->resume(id);
+        showDownloads();
+        return;
+    }
+    // Un fichier (ou un fichier partiel) du même nom existe déjà : "nom (1).ext", "nom (2).ext"...
+    const QFileInfo suggested(request->downloadDirectory() + '/' + request->downloadFileName());
+    QString destination = suggested.filePath();
+    for (int n = 1; QFileInfo::exists(destination) || QFileInfo::exists(destination + ".part"); ++n) {
+        destination = suggested.path() + '/' + suggested.completeBaseName() + QString(" (%1)").arg(n)
+                    + (suggested.suffix().isEmpty() ? QString() : '.' + suggested.suffix());
+    }
+    downloadManager->enqueue(url, destination);
+    showDownloads();
+}
+
+// Fenêtre des téléchargements (Ctrl+J), créée à la première ouverture
+void MainWindow::showDownloads()
+{
+    if (!downloadsDialog) {
+        downloadsDialog = new DownloadsDialog(downloadManager, this);
+    }
+    downloadsDialog->show();
+    downloadsDialog->raise();
+}
+
+// Ajoute la page courante aux favoris (à la racine), ou l'en retire si elle y est déjà
+void MainWindow::toggleBookmark()
+{
+    BrowserTab *tab = currentTab();
+    if (!tab || tab->url().isEmpty()) {
+        return;
+    }
+    const QString url = displayUrl(tab->url()).toString();
+    const int id = bookmarkStore->findBookmark(url);
+    if (id >= 0) {
+        bookmarkStore->remove(id);
+    } else {
+        bookmarkStore->addBookmark(BookmarkStore::kRootId, url, tab->title());
+    }
+}
+
+// Appelé à chaque changement d'URL de l'onglet courant : la recherche est en temps constant
+void MainWindow::updateBookmarkButton()
+{
+    BrowserTab *tab = currentTab();
+    const bool bookmarked = tab && bookmarkStore->isBookmarked(displayUrl(tab->url()).toString());
+    bookmarkButton->setEnabled(tab != nullptr);
+    bookmarkButton->setText(bookmarked ? "★" : "☆");
+    bookmarkButton->setToolTip(bookmarked ? "Retirer des favoris (Ctrl+D)" : "Ajouter aux favoris (Ctrl+D)");
+}
+
+// Fenêtre des favoris (Ctrl+Maj+O), créée à la première ouverture
+void MainWindow::showBookmarks()
+{
+    if (!bookmarksDialog) {
+        bookmarksDialog = new BookmarksDialog(bookmarkStore, this);
+        connect(bookmarksDialog, &BookmarksDialog::openRequested, this, [this](const QUrl &url) {
+            openTab(url, true);
+        });
+    }
+    bookmarksDialog->show();
+    bookmarksDialog->raise();
+}
+
+// Chemin du fichier d'historique, partagé par la sauvegarde et l'index d'autocomplétion
+QString MainWindow::historyFilePath()
+{
+    return QCoreApplication::applicationDirPath() + "/entered_strings.txt";
+}
+
+// Autocomplétion : chaque frappe incrémente la génération, les anciennes requêtes sont abandonnées
+void MainWindow::onInputTextEdited(const QString &text)
+{
+    const quint64 generation = ++completionGeneration;
+    omniboxIndex->latestGeneration.store(generation, std::memory_order_relaxed);
+    if (text.trimmed().isEmpty()) {
+        completionModel->setStringList({});
+        return;
+    }
+    QMetaObject::invokeMethod(omniboxIndex, [this, text, generation]() {
+        omniboxIndex->query(text, generation);
+    }, Qt::QueuedConnection);
+}
+
+// Autocomplétion : affiche les suggestions si elles correspondent toujours au texte saisi
+void MainWindow::onSuggestionsReady(quint64 generation, const QStringList &urls, const QStringList &titles)
+{
+    Q_UNUSED(titles);
+    if (generation != completionGeneration) {
+        return; // Réponse à une frappe déjà dépassée
+    }
+    completionModel->setStringList(urls);
+    if (!urls.isEmpty()) {
+        completer->complete();
+    }
 }
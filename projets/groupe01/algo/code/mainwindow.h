@@ -3,8 +3,8 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QStack>         // Nécessaire pour les piles d'historique (retour/avance)
-#include <QWebEngineView> // Nécessaire pour la fonctionnalité de navigateur web
+#include <QTabWidget>     // Nécessaire pour la navigation par onglets
+#include <QTimer>         // Contrôle périodique du budget mémoire des onglets
 #include <QUrl>           // Nécessaire pour la manipulation des URL
 
 // Nécessaire pour la sauvegarde de fichier
@@ -12,6 +12,31 @@
 #include <QTextStream>    // Pour écrire du texte dans un fichier
 #include <QCoreApplication> // Pour obtenir le chemin du répertoire de l'application (applicationDirPath()) lors de la sauvegarde du fichier
 
+// Nécessaire pour l'autocomplétion de la barre d'adresse
+#include <QCompleter>       // Liste déroulante des suggestions sous inputLineEdit
+#include <QStringListModel> // Modèle contenant les suggestions courantes
+#include <QThread>          // Thread de calcul des suggestions
+
+#include "navigationlog.h"  // Mesures des dernières navigations
+
+class BookmarkStore;
+class BookmarksDialog;
+class BrowserTab;
+class CacheSchemeHandler;
+class DiagnosticsDialog;
+class DownloadManager;
+class DownloadsDialog;
+class QWebEngineDownloadRequest;
+class HttpCache;
+class OmniboxIndex;
+class QToolButton;
+class PageIndexer;
+class RequestInterceptor;
+class SearchSchemeHandler;
+class SessionStore;
+class WebCookieJar;
+struct SessionData;
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class MainWindow;
@@ -23,11 +48,26 @@ class MainWindow : public QMainWindow
     Q_OBJECT // Macro requise pour les objets Qt qui utilisent des signaux et des slots
 
 public:
-    // Constructeur : initialise la fenêtre principale
-    explicit MainWindow(QWidget *parent = nullptr);
+    // Constructeur : initialise la fenêtre principale et restaure la session de sessionFile.
+    // Avec un chemin vide, la fenêtre démarre sans onglet et sans sauvegarde (mesures).
+    explicit MainWindow(QWidget *parent = nullptr, const QString &sessionFile = defaultSessionFile());
     // Destructeur : nettoie les ressources
     ~MainWindow();
 
+    // Onglets
+    BrowserTab *openTab(const QUrl &url, bool makeCurrent);
+    BrowserTab *currentTab() const;
+    BrowserTab *tabAt(int index) const;
+    int tabCount() const;
+
+    // Fichier de session par défaut (session.bin à côté de l'exécutable)
+    static QString defaultSessionFile();
+
+    // Budget mémoire de l'ensemble des onglets (processus de rendu compris)
+    void setTabMemoryBudget(qint64 bytes);
+    // Décharge au plus maxCount onglets en arrière-plan ; renvoie le nombre déchargé
+    int discardBackgroundTabs(int maxCount);
+
 private slots:
     // Slots pour les boutons de l'interface utilisateur
     void on_prevButton_clicked();   // Bouton "Retour"
@@ -40,14 +80,79 @@ private slots:
     // Fonction d'aide pour sauvegarder une chaîne dans un fichier
     void saveStringToFile(const QString &str);
 
+    // Autocomplétion : envoie le texte saisi au thread d'indexation
+    void onInputTextEdited(const QString &text);
+    // Autocomplétion : reçoit les suggestions calculées par le thread d'indexation
+    void onSuggestionsReady(quint64 generation, const QStringList &urls, const QStringList &titles);
+
+    // Onglets : fermeture, changement d'onglet courant, contrôle du budget mémoire
+    void closeTab(int index);
+    void onCurrentTabChanged(int index);
+    void enforceMemoryBudget();
+
 private:
     Ui::MainWindow *ui; // Pointeur vers l'objet UI généré
-    QStack<QString> backStack;    // Stocke les URL visitées avant l'actuelle
-    QStack<QString> forwardStack; // Stocke les URL visitées après l'actuelle (si navigation arrière)
-    QString currentString;        // L'URL actuellement affichée dans la vue web
 
-    // Le widget de la vue web
-    QWebEngineView *webView;
+    // Les onglets (chacun contient sa vue web et son historique de session)
+    QTabWidget *tabs;
+    QTimer memoryTimer;
+    qint64 tabMemoryBudget;
+    qint64 baselineMemory = 0; // Mémoire du navigateur avant l'ouverture des onglets
+    int memoryTabCount = -1;   // Onglets ouverts et chargés lors de la dernière liste des processus
+    int memoryLiveTabs = -1;
+
+    // Sauvegarde de session (nullptr si désactivée)
+    SessionStore *sessionStore = nullptr;
+    SessionData captureSession() const;
+    void restoreSession(const SessionData &session);
+    void scheduleSessionSave();
+
+    // Autocomplétion de la barre d'adresse (index calculé hors du thread graphique)
+    QThread omniboxThread;
+    OmniboxIndex *omniboxIndex;
+    QCompleter *completer;
+    QStringListModel *completionModel;
+    quint64 completionGeneration = 0;
+
+    // Cache HTTP local des origines listées dans cached_origins.txt, et son préchargement
+    HttpCache *httpCache;
+    WebCookieJar *cookieJar; // Cookies du profil web, partagés par le cache et les téléchargements
+    CacheSchemeHandler *cacheSchemeHandler;
+    RequestInterceptor *requestInterceptor;
+    QThread *filterThread; // Chargement des listes de filtres de blocage (voir ContentFilter)
+    QTimer prefetchTimer; // Relancé à chaque navigation : expire quand le navigateur est inactif
+    void prefetchTopSites();
+    static QStringList readCachedOrigins();
+    // URL à afficher : une page servie par le cache est montrée sous son adresse d'origine
+    QUrl displayUrl(const QUrl &url) const;
+
+    // Recherche plein texte dans les pages visitées (index construit dans son propre thread)
+    QThread indexerThread;
+    PageIndexer *pageIndexer;
+    SearchSchemeHandler *searchSchemeHandler;
+    void indexPage(BrowserTab *tab);
+
+    // Mesures de performance des navigations de tous les onglets, et leur fenêtre de diagnostic
+    NavigationLog navigationLog;
+    DiagnosticsDialog *diagnosticsDialog = nullptr;
+    void showDiagnostics();
+
+    // Téléchargements : pris en charge par le DownloadManager plutôt que par le moteur web
+    DownloadManager *downloadManager;
+    DownloadsDialog *downloadsDialog = nullptr;
+    void onDownloadRequested(QWebEngineDownloadRequest *request);
+    void showDownloads();
+
+    // Favoris : l'étoile de la barre d'état indique si la page courante en fait partie
+    BookmarkStore *bookmarkStore;
+    BookmarksDialog *bookmarksDialog = nullptr;
+    QToolButton *bookmarkButton;
+    void toggleBookmark();
+    void updateBookmarkButton();
+    void showBookmarks();
+
+    // Chemin du fichier d'historique (entered_strings.txt à côté de l'exécutable)
+    static QString historyFilePath();
 
     // Fonction d'aide pour mettre à jour l'état activé des boutons de navigation
     void updateButtonStates();
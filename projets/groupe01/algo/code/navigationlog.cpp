@@ -0,0 +1,162 @@
+// navigationlog.cpp
+#include "navigationlog.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int kProgressPercent[NavigationTiming::kProgressSteps] = {25, 50, 75, 100};
+
+// Centile p (0..1) par rang le plus proche ; les valeurs inconnues (< 0) sont ignorées
+double percentile(QVector<double> values, double p)
+{
+    values.erase(std::remove_if(values.begin(), values.end(), [](double v) { return v < 0; }), values.end());
+    if (values.isEmpty()) {
+        return -1;
+    }
+    std::sort(values.begin(), values.end());
+    const qsizetype rank = static_cast<qsizetype>(std::ceil(p * values.size())) - 1;
+    return values[qBound<qsizetype>(0, rank, values.size() - 1)];
+}
+
+QByteArray csvNumber(double ms)
+{
+    return ms < 0 ? QByteArray() : QByteArray::number(ms, 'f', 1);
+}
+
+QByteArray csvField(const QString &text)
+{
+    QByteArray field = text.toUtf8();
+    if (field.contains(',') || field.contains('"') || field.contains('\n')) {
+        field.replace('"', "\"\"");
+        field = '"' + field + '"';
+    }
+    return field;
+}
+
+QJsonValue jsonNumber(double ms)
+{
+    return ms < 0 ? QJsonValue(QJsonValue::Null) : QJsonValue(std::round(ms * 10) / 10);
+}
+
+} // namespace
+
+NavigationLog::NavigationLog(int capacity)
+    : ring(qMax(1, capacity))
+{
+}
+
+void NavigationLog::append(const NavigationTiming &timing)
+{
+    if (count < ring.size()) {
+        ring[(head + count) % ring.size()] = timing;
+        ++count;
+    } else {
+        ring[head] = timing; // Anneau plein : on écrase la plus ancienne
+        head = (head + 1) % ring.size();
+    }
+}
+
+QVector<NavigationLog::HostStats> NavigationLog::hostStatistics() const
+{
+    struct Samples {
+        int failures = 0;
+        QVector<double> load;
+        QVector<double> ttfb;
+        QVector<double> domContentLoaded;
+    };
+    QHash<QString, Samples> byHost;
+    for (int i = 0; i < count; ++i) {
+        const NavigationTiming &t = at(i);
+        Samples &s = byHost[t.url.host().isEmpty() ? t.url.scheme() : t.url.host()];
+        if (!t.ok) {
+            ++s.failures;
+        }
+        s.load.append(t.loadFinishedMs);
+        s.ttfb.append(t.ttfbMs);
+        s.domContentLoaded.append(t.domContentLoadedMs);
+    }
+
+    QVector<HostStats> stats;
+    stats.reserve(byHost.size());
+    for (auto it = byHost.cbegin(); it != byHost.cend(); ++it) {
+        HostStats h;
+        h.host = it.key();
+        h.count = it->load.size();
+        h.failures = it->failures;
+        h.loadP50 = percentile(it->load, 0.50);
+        h.loadP90 = percentile(it->load, 0.90);
+        h.loadP99 = percentile(it->load, 0.99);
+        h.ttfbP50 = percentile(it->ttfb, 0.50);
+        h.domContentLoadedP50 = percentile(it->domContentLoaded, 0.50);
+        stats.append(h);
+    }
+    std::sort(stats.begin(), stats.end(), [](const HostStats &a, const HostStats &b) {
+        return a.count != b.count ? a.count > b.count : a.host < b.host;
+    });
+    return stats;
+}
+
+QByteArray NavigationLog::toCsv() const
+{
+    QByteArray csv = "started_at,url,ok,request_to_start_ms";
+    for (int percent : kProgressPercent) {
+        csv += ",progress_" + QByteArray::number(percent) + "_ms";
+    }
+    csv += ",load_finished_ms,dns_ms,connect_ms,ttfb_ms,response_end_ms,dom_interactive_ms,"
+           "dom_content_loaded_ms,load_event_ms,transfer_bytes\n";
+    for (int i = 0; i < count; ++i) {
+        const NavigationTiming &t = at(i);
+        csv += QDateTime::fromMSecsSinceEpoch(t.startedAtMSecs).toString(Qt::ISODateWithMs).toUtf8();
+        csv += ',' + csvField(t.url.toString());
+        csv += t.ok ? ",1," : ",0,";
+        csv += csvNumber(t.requestToStartMs);
+        for (double ms : t.progressMs) {
+            csv += ',' + csvNumber(ms);
+        }
+        for (double ms : {t.loadFinishedMs, t.dnsMs, t.connectMs, t.ttfbMs, t.responseEndMs, t.domInteractiveMs,
+                          t.domContentLoadedMs, t.loadEventMs}) {
+            csv += ',' + csvNumber(ms);
+        }
+        csv += ',' + (t.transferBytes < 0 ? QByteArray() : QByteArray::number(t.transferBytes));
+        csv += '\n';
+    }
+    return csv;
+}
+
+QByteArray NavigationLog::toJson() const
+{
+    QJsonArray navigations;
+    for (int i = 0; i < count; ++i) {
+        const NavigationTiming &t = at(i);
+        QJsonObject progress;
+        for (int step = 0; step < NavigationTiming::kProgressSteps; ++step) {
+            progress.insert(QString::number(kProgressPercent[step]), jsonNumber(t.progressMs[step]));
+        }
+        navigations.append(QJsonObject{
+            {"startedAt", QDateTime::fromMSecsSinceEpoch(t.startedAtMSecs).toString(Qt::ISODateWithMs)},
+            {"url", t.url.toString()},
+            {"ok", t.ok},
+            {"requestToStartMs", jsonNumber(t.requestToStartMs)},
+            {"progressMs", progress},
+            {"loadFinishedMs", jsonNumber(t.loadFinishedMs)},
+            {"navigationTiming", QJsonObject{
+                {"dnsMs", jsonNumber(t.dnsMs)},
+                {"connectMs", jsonNumber(t.connectMs)},
+                {"ttfbMs", jsonNumber(t.ttfbMs)},
+                {"responseEndMs", jsonNumber(t.responseEndMs)},
+                {"domInteractiveMs", jsonNumber(t.domInteractiveMs)},
+                {"domContentLoadedMs", jsonNumber(t.domContentLoadedMs)},
+                {"loadEventMs", jsonNumber(t.loadEventMs)},
+                {"transferBytes", t.transferBytes < 0 ? QJsonValue(QJsonValue::Null) : QJsonValue(t.transferBytes)},
+            }},
+        });
+    }
+    return QJsonDocument(navigations).toJson(QJsonDocument::Indented);
+}
@@ -0,0 +1,72 @@
+// navigationlog.h
+#ifndef NAVIGATIONLOG_H
+#define NAVIGATIONLOG_H
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+
+// Mesures d'une navigation (page principale d'un onglet). Durées en millisecondes, -1 si inconnues.
+struct NavigationTiming {
+    static constexpr int kProgressSteps = 4; // loadProgress : 25, 50, 75 et 100 %
+
+    qint64 startedAtMSecs = 0; // Horodatage de loadStarted (depuis l'époque)
+    QUrl url;
+    bool ok = false;
+
+    // Côté navigateur, à partir de loadStarted
+    double requestToStartMs = -1; // Saisie (onLoadUrl) -> loadStarted ; -1 pour un lien ou un script
+    double progressMs[kProgressSteps] = {-1, -1, -1, -1};
+    double loadFinishedMs = -1;
+
+    // Côté page : API Navigation Timing, à partir du début de la navigation dans le moteur
+    double dnsMs = -1;              // Résolution DNS (durée)
+    double connectMs = -1;          // Connexion TCP + TLS (durée)
+    double ttfbMs = -1;             // Premier octet de la réponse
+    double responseEndMs = -1;      // Dernier octet de la réponse
+    double domInteractiveMs = -1;
+    double domContentLoadedMs = -1; // Fin de DOMContentLoaded
+    double loadEventMs = -1;        // Début de l'événement load
+    qint64 transferBytes = -1;      // Taille transférée du document (0 : servi par un cache)
+};
+
+// Journal des dernières navigations, dans un anneau de taille fixe : la plus ancienne est
+// écrasée au-delà de la capacité, sans aucune allocation après la construction.
+class NavigationLog
+{
+public:
+    // Statistiques d'un hôte sur les navigations du journal
+    struct HostStats {
+        QString host;
+        int count = 0;
+        int failures = 0;
+        double loadP50 = -1; // Durée loadStarted -> loadFinished : médiane, 90e et 99e centiles
+        double loadP90 = -1;
+        double loadP99 = -1;
+        double ttfbP50 = -1;
+        double domContentLoadedP50 = -1;
+    };
+
+    explicit NavigationLog(int capacity = 2048);
+
+    void append(const NavigationTiming &timing);
+    int size() const { return count; }
+    int capacity() const { return ring.size(); }
+    // index 0 : la plus ancienne navigation conservée
+    const NavigationTiming &at(int index) const { return ring[(head + index) % ring.size()]; }
+
+    // Un élément par hôte, du plus visité au moins visité
+    QVector<HostStats> hostStatistics() const;
+
+    // Export pour l'analyse hors ligne : une ligne (ou un objet) par navigation
+    QByteArray toCsv() const;
+    QByteArray toJson() const;
+
+private:
+    QVector<NavigationTiming> ring;
+    int head = 0;  // Position de la plus ancienne navigation
+    int count = 0;
+};
+
+#endif // NAVIGATIONLOG_H
@@ -0,0 +1,101 @@
+// omniboxindex.cpp
+#include "omniboxindex.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+namespace {
+const int kMaxSuggestions = 10; // Nombre de lignes affichées dans la liste déroulante
+}
+
+OmniboxIndex::OmniboxIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void OmniboxIndex::loadHistory(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return; // Pas encore d'historique : premier lancement
+    }
+
+    // Une ligne "URL<tab>secondes Unix" par visite. Les lignes écrites avant l'horodatage
+    // (URL seule) sont plus anciennes que toutes les autres : on les place, dans leur ordre,
+    // juste avant la plus ancienne visite datée, une seconde d'écart entre elles.
+    QStringList urls;
+    QVector<double> times;
+    double oldest = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        const qsizetype tab = line.lastIndexOf('\t');
+        bool dated = false;
+        const qint64 secs = tab > 0 ? line.mid(tab + 1).toLongLong(&dated) : 0;
+        urls.append(dated ? line.left(tab) : line);
+        times.append(dated ? double(secs) : -1.0);
+        if (dated) {
+            oldest = qMin(oldest, double(secs));
+        }
+    }
+
+    qsizetype undated = times.count(-1.0);
+    for (qsizetype i = 0; i < urls.size(); ++i) {
+        const double t = times[i] >= 0 ? times[i] : oldest - static_cast<double>(undated--);
+        trie.recordVisit(urls[i].toStdString(), t);
+    }
+}
+
+void OmniboxIndex::recordVisit(const QString &url, qint64 visitedAtMSecs)
+{
+    trie.recordVisit(url.toStdString(), visitedAtMSecs / 1000.0);
+}
+
+void OmniboxIndex::updateTitle(const QString &url, const QString &title)
+{
+    trie.setTitle(url.toStdString(), title.toStdString());
+}
+
+void OmniboxIndex::setBookmarked(const QString &url, const QString &title, bool bookmarked, qint64 addedSecs)
+{
+    const std::string key = url.toStdString();
+    trie.setBookmarked(key, bookmarked, double(addedSecs));
+    if (bookmarked) {
+        trie.setTitle(key, title.toStdString()); // Seul titre connu d'un favori jamais visité
+    }
+}
+
+void OmniboxIndex::loadBookmarks(const QStringList &urls, const QStringList &titles, const QVector<qint64> &addedSecs)
+{
+    for (qsizetype i = 0; i < urls.size(); ++i) {
+        setBookmarked(urls[i], titles[i], true, addedSecs[i]);
+    }
+}
+
+void OmniboxIndex::query(const QString &text, quint64 generation)
+{
+    if (generation != latestGeneration.load(std::memory_order_relaxed)) {
+        return; // L'utilisateur a déjà tapé autre chose
+    }
+
+    QStringList urls;
+    QStringList titles;
+    for (const UrlTrie::Suggestion &s : trie.complete(text.trimmed().toStdString(), kMaxSuggestions)) {
+        urls.append(QString::fromStdString(s.url));
+        titles.append(QString::fromStdString(s.title));
+    }
+    emit suggestionsReady(generation, urls, titles);
+}
+
+void OmniboxIndex::topVisited(int count)
+{
+    QStringList urls;
+    for (const UrlTrie::Suggestion &s : trie.topEntries(count)) {
+        urls.append(QString::fromStdString(s.url));
+    }
+    emit topVisitedReady(urls);
+}
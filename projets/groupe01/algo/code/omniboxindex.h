@@ -0,0 +1,49 @@
+// omniboxindex.h
+#ifndef OMNIBOXINDEX_H
+#define OMNIBOXINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+#include "urltrie.h"
+
+// Index d'autocomplétion de la barre d'adresse, exécuté dans un thread dédié.
+// Toutes les méthodes publiques sont des slots appelés par connexion "queued" depuis
+// le thread de l'interface : le UrlTrie n'est jamais touché par le thread graphique.
+class OmniboxIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OmniboxIndex(QObject *parent = nullptr);
+
+    // Numéro de la dernière requête émise par l'interface ; les requêtes plus anciennes
+    // encore dans la file d'événements sont ignorées sans être calculées.
+    std::atomic<quint64> latestGeneration{0};
+
+public slots:
+    // Charge l'historique existant (une ligne "URL<tab>secondes Unix" par visite)
+    void loadHistory(const QString &filePath);
+    // Mise à jour incrémentale à chaque urlChanged / titleChanged de la vue web
+    void recordVisit(const QString &url, qint64 visitedAtMSecs);
+    void updateTitle(const QString &url, const QString &title);
+    // Favoris : classés plus haut dans les suggestions, même s'ils n'ont jamais été visités
+    void setBookmarked(const QString &url, const QString &title, bool bookmarked, qint64 addedSecs);
+    void loadBookmarks(const QStringList &urls, const QStringList &titles, const QVector<qint64> &addedSecs);
+    // Calcule les suggestions pour le texte saisi
+    void query(const QString &text, quint64 generation);
+    // Les URL les plus fréquentées/récentes, pour le préchargement du cache HTTP
+    void topVisited(int count);
+
+signals:
+    void suggestionsReady(quint64 generation, const QStringList &urls, const QStringList &titles);
+    void topVisitedReady(const QStringList &urls);
+
+private:
+    UrlTrie trie;
+};
+
+#endif // OMNIBOXINDEX_H
@@ -0,0 +1,143 @@
+// pageindexer.cpp
+#include "pageindexer.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+
+namespace {
+const int kSliceIntervalMs = 100;      // Une tranche d'indexation au plus toutes les 100 ms...
+const int kSliceBudgetMs = 20;         // ... de 20 ms au plus : 20 % d'un cœur
+const int kMaxQueuedPages = 200;       // Au-delà, les pages les plus anciennes sont abandonnées
+const int kMaxTextChars = 200000;      // Texte indexé par page (les très longues pages sont tronquées)
+const int kExcerptChars = 240;         // Extrait affiché dans les résultats
+const size_t kDocsPerSegment = 64;     // Pages accumulées en mémoire avant d'écrire un segment
+const qint64 kFlushDelayMs = 60000;    // ... ou délai maximal avant de les écrire
+const int kMinTokenLength = 2;
+const int kMaxTokenLength = 40;
+const size_t kMaxResults = 50;
+
+// FNV-1a sur le texte UTF-16 : stable d'une exécution à l'autre, contrairement à qHash
+uint64_t contentHash(const QString &title, const QString &text)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (const QString *s : {&title, &text}) {
+        for (const QChar c : *s) {
+            h = (h ^ c.unicode()) * 0x100000001b3ull;
+        }
+        h = (h ^ 0xFFFF) * 0x100000001b3ull;
+    }
+    return h;
+}
+}
+
+PageIndexer::PageIndexer(const QString &directory, QObject *parent)
+    : QObject(parent)
+    , index(QFile::encodeName(directory).toStdString())
+    , directory(directory)
+    , sliceTimer(new QTimer(this)) // Enfant : suit l'indexeur dans son thread
+{
+    sliceTimer->setInterval(kSliceIntervalMs);
+    connect(sliceTimer, &QTimer::timeout, this, &PageIndexer::runSlice);
+}
+
+PageIndexer::~PageIndexer()
+{
+    // Les pages encore en file sont abandonnées : elles seront indexées à la prochaine visite
+    index.flush();
+}
+
+void PageIndexer::open()
+{
+    QDir().mkpath(directory);
+    if (!index.open()) {
+        qWarning() << "Index plein texte illisible, il est reconstruit :" << directory;
+    }
+}
+
+void PageIndexer::enqueue(const QString &url, const QString &title, const QString &text)
+{
+    if (queue.size() >= kMaxQueuedPages) {
+        queue.dequeue();
+    }
+    queue.enqueue({url, title, text.left(kMaxTextChars)});
+    if (!sliceTimer->isActive()) {
+        sliceTimer->start();
+    }
+}
+
+// Une tranche : écriture du segment en attente, pages en file, puis une fusion s'il reste du budget
+void PageIndexer::runSlice()
+{
+    QElapsedTimer slice;
+    slice.start();
+
+    const size_t buffered = index.bufferedDocuments();
+    if (buffered >= kDocsPerSegment || (buffered > 0 && sinceFirstBuffered.elapsed() >= kFlushDelayMs)) {
+        index.flush();
+    }
+    while (!queue.isEmpty() && slice.elapsed() < kSliceBudgetMs) {
+        indexPage(queue.dequeue());
+    }
+    bool merged = false;
+    if (slice.elapsed() < kSliceBudgetMs) {
+        merged = index.mergeStep();
+    }
+    if (queue.isEmpty() && !merged && index.bufferedDocuments() == 0) {
+        sliceTimer->stop(); // Plus rien à faire jusqu'à la prochaine page
+    }
+}
+
+void PageIndexer::indexPage(const PendingPage &page)
+{
+    const std::string url = page.url.toStdString();
+    const uint64_t hash = contentHash(page.title, page.text);
+    if (index.isCurrent(url, hash)) {
+        return; // Page revisitée sans changement
+    }
+    // Le titre compte comme une partie du texte
+    std::vector<std::string> tokens = tokenize(page.title);
+    const std::vector<std::string> body = tokenize(page.text);
+    tokens.insert(tokens.end(), body.begin(), body.end());
+    index.addDocument(url, page.title.toStdString(), page.text.simplified().left(kExcerptChars).toStdString(), hash, tokens);
+    if (index.bufferedDocuments() == 1) {
+        sinceFirstBuffered.start();
+    }
+}
+
+void PageIndexer::search(quint64 requestId, const QString &query)
+{
+    QStringList urls;
+    QStringList titles;
+    QStringList excerpts;
+    for (const FullTextIndex::Hit &hit : index.search(tokenize(query), kMaxResults)) {
+        urls.append(QString::fromStdString(hit.url));
+        titles.append(QString::fromStdString(hit.title));
+        excerpts.append(QString::fromStdString(hit.excerpt));
+    }
+    emit searchReady(requestId, urls, titles, excerpts);
+}
+
+std::vector<std::string> PageIndexer::tokenize(const QString &text)
+{
+    std::vector<std::string> tokens;
+    // La décomposition sépare les lettres de leurs accents (marques), qui sont ensuite sautés
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+    QString word;
+    auto endWord = [&tokens, &word]() {
+        if (word.size() >= kMinTokenLength && word.size() <= kMaxTokenLength) {
+            tokens.push_back(word.toStdString());
+        }
+        word.clear();
+    };
+    for (const QChar c : decomposed) {
+        if (c.isLetterOrNumber()) {
+            word += c.toLower();
+        } else if (!c.isMark()) {
+            endWord();
+        }
+    }
+    endWord();
+    return tokens;
+}
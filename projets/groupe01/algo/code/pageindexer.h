@@ -0,0 +1,59 @@
+// pageindexer.h
+#ifndef PAGEINDEXER_H
+#define PAGEINDEXER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <string>
+#include <vector>
+
+#include "fulltextindex.h"
+
+class QTimer;
+
+// Indexation plein texte des pages visitées, exécutée dans un thread dédié (comme l'OmniboxIndex).
+// Les textes extraits par le thread graphique sont mis en file ; l'indexation avance par
+// tranches de kSliceBudgetMs toutes les kSliceIntervalMs au plus, pour ne prendre qu'une
+// fraction d'un cœur même quand beaucoup de pages arrivent d'un coup.
+class PageIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PageIndexer(const QString &directory, QObject *parent = nullptr);
+    ~PageIndexer(); // Écrit les pages encore en mémoire
+
+    // Découpe un texte en mots normalisés : minuscules, accents retirés ("Été" -> "ete")
+    static std::vector<std::string> tokenize(const QString &text);
+
+public slots:
+    void open();
+    // Ajoute une page à indexer ; une page déjà indexée avec le même texte est ignorée
+    void enqueue(const QString &url, const QString &title, const QString &text);
+    // Recherche ; le résultat revient par searchReady avec le même requestId
+    void search(quint64 requestId, const QString &query);
+
+signals:
+    void searchReady(quint64 requestId, const QStringList &urls, const QStringList &titles, const QStringList &excerpts);
+
+private:
+    struct PendingPage {
+        QString url;
+        QString title;
+        QString text;
+    };
+
+    FullTextIndex index;
+    QString directory;
+    QQueue<PendingPage> queue;
+    QTimer *sliceTimer;
+    QElapsedTimer sinceFirstBuffered; // Âge de la plus ancienne page pas encore écrite sur disque
+
+    void runSlice();
+    void indexPage(const PendingPage &page);
+};
+
+#endif // PAGEINDEXER_H
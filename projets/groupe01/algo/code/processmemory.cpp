@@ -0,0 +1,146 @@
+// processmemory.cpp
+#include "processmemory.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>    // GetProcessMemoryInfo
+#include <tlhelp32.h> // Énumération des processus (pour trouver les processus fils)
+#elif defined(Q_OS_LINUX)
+#include <QDir>
+#include <QFile>
+#include <unistd.h>   // sysconf(_SC_PAGESIZE)
+#endif
+
+namespace {
+
+// Descendants (et soi-même) de root, à partir de la table parent -> enfants
+QList<qint64> processTree(qint64 root, const QMultiHash<qint64, qint64> &children)
+{
+    QList<qint64> tree{root};
+    for (qsizetype i = 0; i < tree.size(); ++i) {
+        const QList<qint64> direct = children.values(tree[i]);
+        tree.append(direct);
+    }
+    return tree;
+}
+
+#if defined(Q_OS_WIN)
+
+qint64 workingSet(DWORD pid)
+{
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!process) {
+        return 0;
+    }
+    PROCESS_MEMORY_COUNTERS counters;
+    qint64 bytes = 0;
+    if (GetProcessMemoryInfo(process, &counters, sizeof(counters))) {
+        bytes = static_cast<qint64>(counters.WorkingSetSize);
+    }
+    CloseHandle(process);
+    return bytes;
+}
+
+#elif defined(Q_OS_LINUX)
+
+// Lit le PID parent dans /proc/<pid>/stat ("pid (nom) état ppid ...", le nom peut contenir des espaces)
+qint64 parentPid(const QString &pid)
+{
+    QFile stat("/proc/" + pid + "/stat");
+    if (!stat.open(QFile::ReadOnly)) {
+        return -1;
+    }
+    const QByteArray line = stat.readAll();
+    const qsizetype end = line.lastIndexOf(')');
+    const QList<QByteArray> fields = line.mid(end + 2).split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() : -1;
+}
+
+qint64 statmResident(qint64 pid)
+{
+    // /proc/<pid>/statm : taille totale puis pages résidentes
+    QFile statm(QString("/proc/%1/statm").arg(pid));
+    if (!statm.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+}
+
+#endif
+
+// Mémoire résidente d'un processus ; 0 s'il n'existe plus (ou plateforme non prise en charge)
+qint64 residentOf(qint64 pid)
+{
+#if defined(Q_OS_WIN)
+    return workingSet(static_cast<DWORD>(pid));
+#elif defined(Q_OS_LINUX)
+    return statmResident(pid);
+#else
+    Q_UNUSED(pid);
+    return 0;
+#endif
+}
+
+// Le processus courant et tous ses descendants, d'après la table complète des processus
+QList<qint64> scanProcessTree()
+{
+    const qint64 self = QCoreApplication::applicationPid();
+    QMultiHash<qint64, qint64> children;
+
+#if defined(Q_OS_WIN)
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return {self};
+    }
+    PROCESSENTRY32W entry;
+    entry.dwSize = sizeof(entry);
+    for (BOOL ok = Process32FirstW(snapshot, &entry); ok; ok = Process32NextW(snapshot, &entry)) {
+        children.insert(entry.th32ParentProcessID, entry.th32ProcessID);
+    }
+    CloseHandle(snapshot);
+#elif defined(Q_OS_LINUX)
+    const QStringList pids = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &pid : pids) {
+        bool numeric = false;
+        const qint64 id = pid.toLongLong(&numeric);
+        if (numeric) {
+            children.insert(parentPid(pid), id);
+        }
+    }
+#endif
+
+    return processTree(self, children);
+}
+
+} // namespace
+
+namespace ProcessMemory {
+
+qint64 residentBytes()
+{
+    return residentBytes(true);
+}
+
+qint64 residentBytes(bool rescan)
+{
+    static QList<qint64> tree; // Dernière arborescence connue (thread graphique)
+    if (rescan || tree.isEmpty()) {
+        tree = scanProcessTree();
+    }
+    qint64 total = 0;
+    for (qint64 pid : tree) {
+        const qint64 bytes = residentOf(pid);
+        if (bytes == 0 && !rescan) {
+            return residentBytes(true); // Processus disparu : l'arborescence a changé
+        }
+        total += bytes;
+    }
+    return total;
+}
+
+} // namespace ProcessMemory
@@ -0,0 +1,22 @@
+// processmemory.h
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+#include <QtGlobal>
+
+// Mesure de la mémoire résidente du navigateur.
+// QtWebEngine exécute les pages dans des processus fils (QtWebEngineProcess) : la mémoire
+// des onglets n'apparaît pas dans celle du processus principal, on additionne donc celle
+// de toute l'arborescence de processus.
+namespace ProcessMemory {
+
+// Mémoire résidente (octets) du processus courant et de tous ses descendants ; 0 si inconnue
+qint64 residentBytes();
+// Même mesure pour un contrôle périodique : la liste des descendants, longue à établir (tous
+// les /proc/<pid>/stat sous Linux), n'est refaite que si rescan est vrai ou si l'un des
+// processus connus a disparu ; sinon seule la mémoire de ces processus est relue.
+qint64 residentBytes(bool rescan);
+
+} // namespace ProcessMemory
+
+#endif // PROCESSMEMORY_H
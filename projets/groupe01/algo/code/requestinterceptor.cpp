@@ -0,0 +1,124 @@
+// requestinterceptor.cpp
+#include "requestinterceptor.h"
+
+#include "contentfilter.h"
+#include "httpcache.h"
+
+#include <QMutexLocker>
+#include <string>
+
+namespace {
+const int kPostedUrls = 16; // Cibles de formulaires retenues pour wasPosted()
+
+// Ajoute une composante encodée d'URL (ASCII) à out, sans passer par un QByteArray
+void appendAscii(std::string &out, const QString &text)
+{
+    for (const QChar c : text) {
+        out.push_back(static_cast<char>(c.unicode()));
+    }
+}
+
+// Écrit url.toEncoded(QUrl::RemoveFragment) dans out, tampon réutilisé d'une requête à l'autre.
+// Les composantes d'une URL déjà encodée sont partagées par QUrl : rien n'est alloué.
+void encodeUrl(const QUrl &url, std::string &out)
+{
+    out.clear();
+    appendAscii(out, url.scheme());
+    out += "://";
+    const QString userInfo = url.userInfo(QUrl::FullyEncoded);
+    if (!userInfo.isEmpty()) {
+        appendAscii(out, userInfo);
+        out += '@';
+    }
+    appendAscii(out, url.host(QUrl::FullyEncoded));
+    if (url.port() != -1) {
+        out += ':';
+        out += std::to_string(url.port());
+    }
+    appendAscii(out, url.path(QUrl::FullyEncoded));
+    if (url.hasQuery()) {
+        out += '?';
+        appendAscii(out, url.query(QUrl::FullyEncoded));
+    }
+}
+}
+
+RequestInterceptor::RequestInterceptor(const QHash<QString, QString> &cachedOrigins, QObject *parent)
+    : QWebEngineUrlRequestInterceptor(parent)
+    , cachedOrigins(cachedOrigins)
+{
+}
+
+void RequestInterceptor::setFilterEngine(std::shared_ptr<const FilterEngine> engine)
+{
+    std::atomic_store(&filterEngine, std::move(engine));
+}
+
+bool RequestInterceptor::wasPosted(const QUrl &url) const
+{
+    QMutexLocker locker(&postedMutex);
+    return postedUrls.contains(url);
+}
+
+void RequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo &info)
+{
+    const QUrl url = info.requestUrl();
+    const QString scheme = url.scheme();
+    if (scheme == QLatin1String(HttpCache::kScheme)) {
+        // Le cache ne sert que des GET : un formulaire posté depuis une de ses pages (action
+        // relative) est envoyé à l'origine, avec sa méthode et son corps. Les autres requêtes
+        // (fetch(), XMLHttpRequest) sont transmises par CacheSchemeHandler.
+        const QWebEngineUrlRequestInfo::ResourceType type = info.resourceType();
+        if (info.requestMethod() != "GET"
+            && (type == QWebEngineUrlRequestInfo::ResourceTypeMainFrame
+                || type == QWebEngineUrlRequestInfo::ResourceTypeSubFrame)) {
+            QUrl originUrl(url);
+            originUrl.setScheme(cachedOrigins.value(HttpCache::originKey(url), QStringLiteral("http")));
+            info.redirect(originUrl);
+        }
+        return;
+    }
+    if (scheme != "http" && scheme != "https" && scheme != "ws" && scheme != "wss") {
+        return;
+    }
+
+    // Formulaire envoyé par une page ou un cadre : sa réponse peut devenir un téléchargement
+    const QWebEngineUrlRequestInfo::ResourceType type = info.resourceType();
+    if (info.requestMethod() != "GET"
+        && (type == QWebEngineUrlRequestInfo::ResourceTypeMainFrame || type == QWebEngineUrlRequestInfo::ResourceTypeSubFrame)) {
+        QMutexLocker locker(&postedMutex);
+        postedUrls.removeOne(url);
+        postedUrls.append(url);
+        if (postedUrls.size() > kPostedUrls) {
+            postedUrls.removeFirst();
+        }
+    }
+
+    // La page elle-même n'est jamais bloquée : seules ses sous-ressources le sont
+    if (type != QWebEngineUrlRequestInfo::ResourceTypeMainFrame) {
+        if (const std::shared_ptr<const FilterEngine> engine = std::atomic_load(&filterEngine)) {
+            // Tampons réutilisés d'une requête à l'autre : pas d'allocation. L'hôte du document ne
+            // change qu'avec la page, il n'est reconverti en UTF-8 qu'à ce moment-là.
+            thread_local std::string encoded;
+            thread_local QString lastDocumentHost;
+            thread_local std::string documentHost;
+            encodeUrl(url, encoded);
+            const QString firstPartyHost = info.firstPartyUrl().host();
+            if (firstPartyHost != lastDocumentHost) {
+                lastDocumentHost = firstPartyHost;
+                const QByteArray utf8 = firstPartyHost.toUtf8();
+                documentHost.assign(utf8.constData(), static_cast<size_t>(utf8.size()));
+            }
+            if (engine->shouldBlock(encoded, documentHost, ContentFilter::resourceType(type))) {
+                info.block(true);
+                blocked.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    if (!cachedOrigins.isEmpty() && info.requestMethod() == "GET" && scheme.startsWith("http")
+        && cachedOrigins.contains(HttpCache::originKey(url))) {
+        info.redirect(HttpCache::toCacheUrl(url));
+    }
+}
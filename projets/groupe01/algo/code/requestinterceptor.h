@@ -0,0 +1,48 @@
+// requestinterceptor.h
+#ifndef REQUESTINTERCEPTOR_H
+#define REQUESTINTERCEPTOR_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+#include <QWebEngineUrlRequestInterceptor>
+#include <atomic>
+#include <memory>
+
+class FilterEngine;
+
+// Voit passer chaque requête du moteur web avant son envoi :
+//  - les sous-ressources qui correspondent aux listes de filtres sont bloquées ;
+//  - les requêtes GET vers une origine mise en cache sont redirigées vers le schéma du cache ;
+//  - les formulaires envoyés au schéma du cache par une page ou un cadre qu'il a servis
+//    repartent vers l'origine (les fetch() et XMLHttpRequest sont transmis par CacheSchemeHandler).
+// Installé par QWebEngineProfile::setUrlRequestInterceptor, interceptRequest() est appelé
+// dans le thread graphique (Qt 6) : chaque requête l'attend, il doit rester bref. Le moteur
+// de filtres, compilé dans un autre thread, est remplacé d'un bloc (shared_ptr atomique).
+class RequestInterceptor : public QWebEngineUrlRequestInterceptor
+{
+    Q_OBJECT
+
+public:
+    explicit RequestInterceptor(const QHash<QString, QString> &cachedOrigins, QObject *parent = nullptr);
+
+    void interceptRequest(QWebEngineUrlRequestInfo &info) override;
+
+    // Peut être appelé de n'importe quel thread, par exemple à la fin de la compilation des listes
+    void setFilterEngine(std::shared_ptr<const FilterEngine> engine);
+    quint64 blockedCount() const { return blocked.load(std::memory_order_relaxed); }
+    // Vrai si une page a récemment envoyé un formulaire (requête non GET) à cette URL : un
+    // téléchargement qui en résulte ne peut pas être redemandé par un simple GET
+    bool wasPosted(const QUrl &url) const;
+
+private:
+    const QHash<QString, QString> cachedOrigins; // Clé HttpCache::originKey() -> schéma de l'origine
+    std::shared_ptr<const FilterEngine> filterEngine; // Accès par std::atomic_load/atomic_store
+    std::atomic<quint64> blocked{0};
+    mutable QMutex postedMutex;
+    QList<QUrl> postedUrls; // Dernières cibles de formulaires, de la plus ancienne à la plus récente
+};
+
+#endif // REQUESTINTERCEPTOR_H
@@ -0,0 +1,79 @@
+// searchschemehandler.cpp
+#include "searchschemehandler.h"
+
+#include <QBuffer>
+#include <QUrlQuery>
+
+#include "pageindexer.h"
+
+SearchSchemeHandler::SearchSchemeHandler(PageIndexer *indexer, QObject *parent)
+    : QWebEngineUrlSchemeHandler(parent)
+    , indexer(indexer)
+{
+    connect(indexer, &PageIndexer::searchReady, this, &SearchSchemeHandler::onSearchReady);
+}
+
+QUrl SearchSchemeHandler::searchUrl(const QString &query)
+{
+    QUrl url;
+    url.setScheme(kScheme);
+    QUrlQuery urlQuery;
+    urlQuery.addQueryItem("q", query);
+    url.setQuery(urlQuery);
+    return url;
+}
+
+void SearchSchemeHandler::requestStarted(QWebEngineUrlRequestJob *job)
+{
+    if (job->requestMethod() != "GET") {
+        job->fail(QWebEngineUrlRequestJob::RequestDenied);
+        return;
+    }
+    const QString query = QUrlQuery(job->requestUrl()).queryItemValue("q", QUrl::FullyDecoded).trimmed();
+    const quint64 requestId = ++nextRequestId;
+    pending.insert(requestId, job); // La page peut être fermée avant la réponse
+    pendingQueries.insert(requestId, query);
+    QMetaObject::invokeMethod(indexer, [this, requestId, query]() {
+        indexer->search(requestId, query);
+    }, Qt::QueuedConnection);
+}
+
+void SearchSchemeHandler::onSearchReady(quint64 requestId, const QStringList &urls, const QStringList &titles,
+                                        const QStringList &excerpts)
+{
+    const QPointer<QWebEngineUrlRequestJob> job = pending.take(requestId);
+    const QString query = pendingQueries.take(requestId);
+    if (!job) {
+        return;
+    }
+    auto *buffer = new QBuffer(job);
+    buffer->setData(renderPage(query, urls, titles, excerpts));
+    buffer->open(QIODevice::ReadOnly);
+    job->reply("text/html", buffer);
+}
+
+QByteArray SearchSchemeHandler::renderPage(const QString &query, const QStringList &urls, const QStringList &titles,
+                                           const QStringList &excerpts)
+{
+    QString html;
+    html += "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Recherche : " + query.toHtmlEscaped()
+          + "</title><style>"
+            "body{font-family:sans-serif;max-width:48em;margin:2em auto;color:#222}"
+            "input{width:70%;font-size:1.1em;padding:.3em}"
+            ".r{margin:1.2em 0}.r a{font-size:1.1em}.u{color:#2a7a2a;font-size:.85em}.e{color:#555;font-size:.9em}"
+            "</style></head><body>";
+    html += "<form action=\"" + QString(kScheme) + ":\" method=\"get\"><input name=\"q\" value=\""
+          + query.toHtmlEscaped() + "\" autofocus placeholder=\"Rechercher dans les pages visitées\">"
+            " <button>Rechercher</button></form>";
+    if (!query.isEmpty()) {
+        html += "<p>" + QString::number(urls.size()) + (urls.size() > 1 ? " résultats" : " résultat") + "</p>";
+    }
+    for (qsizetype i = 0; i < urls.size(); ++i) {
+        const QString title = titles.value(i).isEmpty() ? urls[i] : titles.value(i);
+        html += "<div class=\"r\"><a href=\"" + urls[i].toHtmlEscaped() + "\">" + title.toHtmlEscaped() + "</a>"
+              + "<div class=\"u\">" + urls[i].toHtmlEscaped() + "</div>"
+              + "<div class=\"e\">" + excerpts.value(i).toHtmlEscaped() + "</div></div>";
+    }
+    html += "</body></html>";
+    return html.toUtf8();
+}
@@ -0,0 +1,41 @@
+// searchschemehandler.h
+#ifndef SEARCHSCHEMEHANDLER_H
+#define SEARCHSCHEMEHANDLER_H
+
+#include <QHash>
+#include <QPointer>
+#include <QStringList>
+#include <QUrl>
+#include <QWebEngineUrlRequestJob>
+#include <QWebEngineUrlSchemeHandler>
+
+class PageIndexer;
+
+// Page de recherche dans le texte des pages visitées : ictu-search:?q=mots
+// La requête est transmise au PageIndexer (dans son thread) ; la page de résultats est
+// construite quand la réponse revient.
+class SearchSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *kScheme = "ictu-search";
+
+    explicit SearchSchemeHandler(PageIndexer *indexer, QObject *parent = nullptr);
+
+    static QUrl searchUrl(const QString &query);
+
+    void requestStarted(QWebEngineUrlRequestJob *job) override;
+
+private:
+    PageIndexer *indexer;
+    quint64 nextRequestId = 0;
+    QHash<quint64, QPointer<QWebEngineUrlRequestJob>> pending;
+    QHash<quint64, QString> pendingQueries;
+
+    void onSearchReady(quint64 requestId, const QStringList &urls, const QStringList &titles, const QStringList &excerpts);
+    static QByteArray renderPage(const QString &query, const QStringList &urls, const QStringList &titles,
+                                 const QStringList &excerpts);
+};
+
+#endif // SEARCHSCHEMEHANDLER_H
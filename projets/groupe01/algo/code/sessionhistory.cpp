@@ -0,0 +1,181 @@
+// sessionhistory.cpp
+#include "sessionhistory.h"
+
+#include <QtGlobal>
+
+qint64 HistoryEntry::cost() const
+{
+    // Les QString sont en UTF-16 : 2 octets par caractère
+    return static_cast<qint64>(sizeof(HistoryEntry))
+           + 2 * (url.toString().size() + title.size())
+           + pageState.size();
+}
+
+SessionHistory::SessionHistory(int maxEntries, qint64 memoryBudgetBytes)
+    : ring(qMax(1, maxEntries))
+    , capacity(qMax(1, maxEntries))
+    , budget(memoryBudgetBytes)
+{
+}
+
+void SessionHistory::setMaxEntries(int maxEntries)
+{
+    maxEntries = qMax(1, maxEntries);
+    if (maxEntries == capacity) {
+        return;
+    }
+
+    // On garde les entrées les plus récentes, en ordre, au début du nouvel anneau
+    const int kept = qMin(count, maxEntries);
+    const int first = count - kept;
+    QVector<HistoryEntry> resized(maxEntries);
+    usage = 0;
+    for (int i = 0; i < kept; ++i) {
+        resized[i] = ring[slot(first + i)];
+        usage += resized[i].cost();
+    }
+    ring.swap(resized);
+    capacity = maxEntries;
+    head = 0;
+    count = kept;
+    cursor = qMax(-1, qMin(cursor - first, count - 1));
+    if (count > 0 && cursor < 0) {
+        cursor = 0;
+    }
+    enforceBudget();
+}
+
+void SessionHistory::setMemoryBudget(qint64 bytes)
+{
+    budget = bytes;
+    enforceBudget();
+}
+
+void SessionHistory::navigate(const QUrl &url)
+{
+    truncateForward();
+    if (count == capacity) {
+        dropOldest();
+    }
+
+    HistoryEntry &entry = ring[slot(count)];
+    entry = HistoryEntry();
+    entry.url = url;
+    usage += entry.cost();
+    cursor = count;
+    ++count;
+    enforceBudget();
+}
+
+void SessionHistory::replaceCurrent(const QUrl &url)
+{
+    if (cursor < 0) {
+        navigate(url);
+        return;
+    }
+
+    // L'instantané décrit la page avant redirection : il n'est plus valable
+    HistoryEntry &entry = ring[slot(cursor)];
+    usage -= entry.cost();
+    entry.url = url;
+    entry.scrollPosition = QPointF();
+    entry.pageState.clear();
+    usage += entry.cost();
+}
+
+void SessionHistory::snapshotCurrent(const QString &title, const QPointF &scrollPosition, const QByteArray &pageState)
+{
+    if (cursor < 0) {
+        return;
+    }
+
+    HistoryEntry &entry = ring[slot(cursor)];
+    usage -= entry.cost();
+    entry.title = title;
+    entry.scrollPosition = scrollPosition;
+    entry.pageState = pageState;
+    usage += entry.cost();
+    enforceBudget();
+}
+
+const HistoryEntry &SessionHistory::goBack()
+{
+    if (canGoBack()) {
+        --cursor;
+    }
+    return at(cursor);
+}
+
+const HistoryEntry &SessionHistory::goForward()
+{
+    if (canGoForward()) {
+        ++cursor;
+    }
+    return at(cursor);
+}
+
+void SessionHistory::restore(const QVector<HistoryEntry> &entries, int currentIndex)
+{
+    head = 0;
+    count = 0;
+    cursor = -1;
+    usage = 0;
+
+    const int first = qMax(0, static_cast<int>(entries.size()) - capacity);
+    for (int i = first; i < entries.size(); ++i) {
+        ring[count] = entries[i];
+        usage += ring[count].cost();
+        ++count;
+    }
+    if (count > 0) {
+        cursor = qBound(0, currentIndex - first, count - 1);
+    }
+    enforceBudget();
+}
+
+void SessionHistory::dropOldest()
+{
+    usage -= ring[head].cost();
+    ring[head] = HistoryEntry();
+    head = (head + 1) % capacity;
+    --count;
+    --cursor;
+}
+
+void SessionHistory::truncateForward()
+{
+    while (count > cursor + 1) {
+        HistoryEntry &entry = ring[slot(count - 1)];
+        usage -= entry.cost();
+        entry = HistoryEntry();
+        --count;
+    }
+}
+
+void SessionHistory::enforceBudget()
+{
+    // 1. Libérer les instantanés, du plus éloigné de la page courante au plus proche
+    while (usage > budget) {
+        int farthest = -1;
+        int farthestDistance = 0;
+        for (int i = 0; i < count; ++i) {
+            const int distance = qAbs(i - cursor);
+            if (i != cursor && !at(i).pageState.isEmpty() && distance > farthestDistance) {
+                farthest = i;
+                farthestDistance = distance;
+            }
+        }
+        if (farthest < 0) {
+            break;
+        }
+        HistoryEntry &entry = ring[slot(farthest)];
+        usage -= entry.pageState.size();
+        entry.pageState.clear();
+        entry.pageState.squeeze();
+    }
+
+    // 2. Toujours trop : oublier les entrées les plus anciennes (jamais la page courante)
+    while (usage > budget && cursor > 0) {
+        dropOldest();
+    }
+}
@@ -0,0 +1,75 @@
+// sessionhistory.h
+#ifndef SESSIONHISTORY_H
+#define SESSIONHISTORY_H
+
+#include <QByteArray>
+#include <QPointF>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+
+// Une page de l'historique de session, avec de quoi la réafficher instantanément
+struct HistoryEntry {
+    QUrl url;
+    QString title;
+    QPointF scrollPosition; // Position de défilement au moment où l'on a quitté la page
+    QByteArray pageState;   // QWebEngineHistory sérialisé (QDataStream) au même moment
+
+    // Estimation de la mémoire occupée par l'entrée (pour le budget mémoire)
+    qint64 cost() const;
+};
+
+// Historique de session retour/avance d'un onglet.
+// Les entrées sont rangées dans un anneau de taille fixe : au-delà de maxEntries la plus
+// ancienne est écrasée. Quand la mémoire des instantanés dépasse le budget, on libère
+// d'abord les instantanés les plus éloignés de la page courante (l'URL reste, la page
+// sera simplement rechargée), puis les entrées les plus anciennes.
+class SessionHistory
+{
+public:
+    explicit SessionHistory(int maxEntries = 100, qint64 memoryBudgetBytes = 16 * 1024 * 1024);
+
+    void setMaxEntries(int maxEntries);
+    void setMemoryBudget(qint64 bytes);
+    int maxEntries() const { return capacity; }
+    qint64 memoryBudget() const { return budget; }
+    qint64 memoryUsage() const { return usage; }
+
+    // Nouvelle navigation : l'historique "avant" est effacé et l'URL devient la page courante
+    void navigate(const QUrl &url);
+    // Redirection : l'URL remplace la page courante sans créer de nouvelle entrée
+    void replaceCurrent(const QUrl &url);
+    // Mémorise l'état de la page courante avant de la quitter
+    void snapshotCurrent(const QString &title, const QPointF &scrollPosition, const QByteArray &pageState);
+
+    bool canGoBack() const { return cursor > 0; }
+    bool canGoForward() const { return cursor + 1 < count; }
+    // Déplace la page courante et renvoie l'entrée à afficher
+    const HistoryEntry &goBack();
+    const HistoryEntry &goForward();
+
+    bool isEmpty() const { return count == 0; }
+    int size() const { return count; }
+    int currentIndex() const { return cursor; }
+    const HistoryEntry &at(int index) const { return ring[slot(index)]; }
+    const HistoryEntry *current() const { return cursor >= 0 ? &at(cursor) : nullptr; }
+
+    // Reconstruit l'historique à partir d'entrées déjà ordonnées (restauration de session)
+    void restore(const QVector<HistoryEntry> &entries, int currentIndex);
+
+private:
+    QVector<HistoryEntry> ring;
+    int capacity;
+    int head = 0;    // Position dans ring de l'entrée la plus ancienne
+    int count = 0;   // Nombre d'entrées valides
+    int cursor = -1; // Index logique (0 = plus ancienne) de la page courante
+    qint64 budget;
+    qint64 usage = 0;
+
+    int slot(int index) const { return (head + index) % capacity; }
+    void dropOldest();
+    void truncateForward();
+    void enforceBudget();
+};
+
+#endif // SESSIONHISTORY_H
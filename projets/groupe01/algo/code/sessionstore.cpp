@@ -0,0 +1,115 @@
+// sessionstore.cpp
+#include "sessionstore.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+namespace {
+const quint32 kMagic = 0x49435453; // "ICTS"
+const quint16 kVersion = 1;
+const int kHeaderSize = 6;         // kMagic + kVersion
+const int kSaveDelayMs = 1000;     // Regroupe les modifications rapprochées en une seule écriture
+}
+
+SessionStore::SessionStore(const QString &filePath, std::function<SessionData()> collect, QObject *parent)
+    : QObject(parent)
+    , filePath(filePath)
+    , collect(std::move(collect))
+{
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(kSaveDelayMs);
+    connect(&saveTimer, &QTimer::timeout, this, &SessionStore::saveNow);
+}
+
+void SessionStore::scheduleSave()
+{
+    saveTimer.start(); // Redémarre le délai : on n'écrit qu'une fois la navigation calmée
+}
+
+bool SessionStore::saveNow()
+{
+    saveTimer.stop();
+    return writeFile(filePath, collect());
+}
+
+bool SessionStore::readFile(const QString &filePath, SessionData &session)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+    return deserialize(file.readAll(), session);
+}
+
+bool SessionStore::writeFile(const QString &filePath, const SessionData &session)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QFile::WriteOnly)) {
+        return false;
+    }
+    file.write(serialize(session));
+    return file.commit();
+}
+
+QByteArray SessionStore::serialize(const SessionData &session)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << qint32(session.activeTab) << quint32(session.tabs.size());
+    for (const TabState &tab : session.tabs) {
+        out << qint32(tab.currentIndex) << quint32(tab.entries.size());
+        for (const HistoryEntry &entry : tab.entries) {
+            out << entry.url << entry.title << entry.scrollPosition << entry.pageState;
+        }
+    }
+
+    QByteArray data;
+    QDataStream header(&data, QIODevice::WriteOnly);
+    header << kMagic << kVersion;
+    data += qCompress(payload);
+    return data;
+}
+
+bool SessionStore::deserialize(const QByteArray &data, SessionData &session)
+{
+    if (data.size() < kHeaderSize) {
+        return false;
+    }
+    QDataStream header(data);
+    quint32 magic = 0;
+    quint16 version = 0;
+    header >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        return false;
+    }
+
+    const QByteArray payload = qUncompress(data.mid(kHeaderSize));
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    qint32 activeTab = 0;
+    quint32 tabCount = 0;
+    in >> activeTab >> tabCount;
+    SessionData result;
+    result.activeTab = activeTab;
+    for (quint32 t = 0; t < tabCount && in.status() == QDataStream::Ok; ++t) {
+        TabState tab;
+        qint32 currentIndex = -1;
+        quint32 entryCount = 0;
+        in >> currentIndex >> entryCount;
+        tab.currentIndex = currentIndex;
+        for (quint32 e = 0; e < entryCount && in.status() == QDataStream::Ok; ++e) {
+            HistoryEntry entry;
+            in >> entry.url >> entry.title >> entry.scrollPosition >> entry.pageState;
+            tab.entries.append(entry);
+        }
+        result.tabs.append(tab);
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false; // Fichier tronqué ou corrompu : on garde une session vide
+    }
+    session = result;
+    return true;
+}
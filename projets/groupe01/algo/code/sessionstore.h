@@ -0,0 +1,50 @@
+// sessionstore.h
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+#include "sessionhistory.h"
+
+// État d'un onglet à sauvegarder : son historique de session et la page courante
+struct TabState {
+    QVector<HistoryEntry> entries;
+    int currentIndex = -1;
+};
+
+// État complet du navigateur : les onglets ouverts et l'onglet actif
+struct SessionData {
+    QVector<TabState> tabs;
+    int activeTab = 0;
+};
+
+// Sauvegarde de session dans un fichier binaire compact (QDataStream compressé).
+// Les modifications appellent scheduleSave() : l'écriture est regroupée après un court
+// délai d'inactivité pour ne pas réécrire le fichier à chaque événement de navigation.
+// L'écriture passe par QSaveFile : un arrêt brutal laisse toujours l'ancien fichier intact.
+class SessionStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    // collect est appelé au moment de l'écriture pour obtenir l'état courant
+    SessionStore(const QString &filePath, std::function<SessionData()> collect, QObject *parent = nullptr);
+
+    void scheduleSave();
+    bool saveNow();
+
+    static bool readFile(const QString &filePath, SessionData &session);
+    static bool writeFile(const QString &filePath, const SessionData &session);
+    static QByteArray serialize(const SessionData &session);
+    static bool deserialize(const QByteArray &data, SessionData &session);
+
+private:
+    QString filePath;
+    std::function<SessionData()> collect;
+    QTimer saveTimer;
+};
+
+#endif // SESSIONSTORE_H
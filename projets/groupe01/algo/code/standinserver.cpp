@@ -0,0 +1,190 @@
+// standinserver.cpp
+#include "standinserver.h"
+
+#include <QCryptographicHash>
+#include <QHostAddress>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QTimer>
+
+namespace {
+const int kSendIntervalMs = 10; // Débit limité : envoi par tranches toutes les 10 ms
+}
+
+StandInServer::StandInServer(QObject *parent)
+    : QTcpServer(parent)
+{
+    connect(this, &QTcpServer::newConnection, this, &StandInServer::onNewConnection);
+}
+
+bool StandInServer::start()
+{
+    return listen(QHostAddress::LocalHost, 0);
+}
+
+QUrl StandInServer::url(const QString &path) const
+{
+    return QUrl(QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(path));
+}
+
+void StandInServer::setResource(const QString &path, const QByteArray &body,
+                                const QByteArray &contentType, int maxAgeSecs)
+{
+    Resource resource;
+    resource.body = body;
+    resource.contentType = contentType;
+    resource.etag = '"' + QCryptographicHash::hash(body, QCryptographicHash::Md5).toHex().left(16) + '"';
+    resource.maxAgeSecs = maxAgeSecs;
+    resources.insert(path, resource);
+}
+
+void StandInServer::setBandwidth(qint64 bytesPerSecond)
+{
+    bandwidth = bytesPerSecond;
+    if (bandwidth > 0 && !sendTimer) {
+        sendTimer = new QTimer(this);
+        sendTimer->setInterval(kSendIntervalMs);
+        connect(sendTimer, &QTimer::timeout, this, &StandInServer::drainOutgoing);
+    }
+}
+
+void StandInServer::onNewConnection()
+{
+    while (QTcpSocket *socket = nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            pending.remove(socket);
+            outgoing.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void StandInServer::onReadyRead(QTcpSocket *socket)
+{
+    QByteArray &buffer = pending[socket];
+    buffer += socket->readAll();
+
+    // Connexions persistantes : plusieurs requêtes peuvent se suivre (ni corps, ni POST ici)
+    qsizetype end;
+    while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+        const QByteArray request = buffer.left(end);
+        buffer.remove(0, end + 4);
+        ++requests;
+        if (latencyMs > 0) {
+            QPointer<QTcpSocket> guard(socket);
+            QTimer::singleShot(latencyMs, this, [this, guard, request]() {
+                if (guard) {
+                    respond(guard, request);
+                }
+            });
+        } else {
+            respond(socket, request);
+        }
+    }
+}
+
+void StandInServer::respond(QTcpSocket *socket, const QByteArray &request)
+{
+    const QList<QByteArray> lines = request.split('\n');
+    const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QString path = QString::fromUtf8(requestLine.value(1));
+
+    QByteArray ifNoneMatch;
+    QByteArray range;
+    QByteArray ifRange;
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines[i].trimmed();
+        const QByteArray lower = line.toLower();
+        if (lower.startsWith("if-none-match:")) {
+            ifNoneMatch = line.mid(14).trimmed();
+        } else if (lower.startsWith("range:")) {
+            range = lower.mid(6).trimmed();
+        } else if (lower.startsWith("if-range:")) {
+            ifRange = line.mid(9).trimmed();
+        }
+    }
+
+    QByteArray status;
+    QByteArray headers;
+    QByteArray body;
+    auto it = resources.constFind(path);
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+    } else if (it == resources.constEnd()) {
+        status = "404 Not Found";
+    } else {
+        headers += "ETag: " + it->etag + "\r\nAccept-Ranges: bytes\r\n";
+        if (it->maxAgeSecs >= 0) {
+            headers += "Cache-Control: max-age=" + QByteArray::number(it->maxAgeSecs) + "\r\n";
+        }
+        const qint64 size = it->body.size();
+        if (ifNoneMatch == it->etag) {
+            status = "304 Not Modified";
+        } else if (range.startsWith("bytes=") && (ifRange.isEmpty() || ifRange == it->etag)) {
+            // Une seule plage "début-fin" ou "début-" (les plages multiples ne sont pas gérées)
+            const QList<QByteArray> bounds = range.mid(6).split('-');
+            bool startOk = false;
+            bool endOk = true;
+            const qint64 start = bounds.value(0).toLongLong(&startOk);
+            qint64 last = size - 1;
+            if (bounds.size() == 2 && !bounds[1].isEmpty()) {
+                last = qMin(size - 1, bounds[1].toLongLong(&endOk));
+            }
+            if (bounds.size() != 2 || !startOk || !endOk || start > last) {
+                status = "416 Range Not Satisfiable";
+                headers += "Content-Range: bytes */" + QByteArray::number(size) + "\r\n";
+            } else {
+                status = "206 Partial Content";
+                headers += "Content-Type: " + it->contentType + "\r\n";
+                headers += "Content-Range: bytes " + QByteArray::number(start) + '-' + QByteArray::number(last)
+                         + '/' + QByteArray::number(size) + "\r\n";
+                body = it->body.mid(start, last - start + 1);
+            }
+        } else {
+            status = "200 OK";
+            headers += "Content-Type: " + it->contentType + "\r\n";
+            body = it->body;
+        }
+    }
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n" + headers
+                        + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                        + "Connection: keep-alive\r\n\r\n";
+    if (method != "HEAD") {
+        response += body;
+    }
+    send(socket, response);
+}
+
+void StandInServer::send(QTcpSocket *socket, const QByteArray &data)
+{
+    if (bandwidth <= 0) {
+        socket->write(data);
+        return;
+    }
+    Output &output = outgoing[socket];
+    output.data.remove(0, output.sent); // Rare : une requête arrive avant la fin de la réponse précédente
+    output.sent = 0;
+    output.data += data;
+    if (!sendTimer->isActive()) {
+        sendTimer->start();
+    }
+}
+
+// Envoie à chaque connexion au plus sa part de débit pour cet intervalle
+void StandInServer::drainOutgoing()
+{
+    const qint64 quantum = qMax<qint64>(1, bandwidth * kSendIntervalMs / 1000);
+    for (auto it = outgoing.begin(); it != outgoing.end();) {
+        Output &output = it.value();
+        const qint64 chunk = qMin<qint64>(quantum, output.data.size() - output.sent);
+        it.key()->write(output.data.constData() + output.sent, chunk);
+        output.sent += chunk;
+        it = output.sent == output.data.size() ? outgoing.erase(it) : std::next(it);
+    }
+    if (outgoing.isEmpty()) {
+        sendTimer->stop();
+    }
+}
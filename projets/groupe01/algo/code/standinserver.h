@@ -0,0 +1,63 @@
+// standinserver.h
+#ifndef STANDINSERVER_H
+#define STANDINSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QTcpServer>
+#include <QUrl>
+
+class QTcpSocket;
+class QTimer;
+
+// Petit serveur HTTP/1.1 local qui remplace l'intranet pendant les mesures.
+// Il sert des ressources en mémoire avec ETag et Cache-Control, répond 304 aux requêtes
+// conditionnelles, sert des plages d'octets (Range, If-Range) et peut simuler la latence
+// et le débit limité d'un vrai serveur.
+class StandInServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit StandInServer(QObject *parent = nullptr);
+
+    // Écoute sur 127.0.0.1, sur un port libre ; false en cas d'échec
+    bool start();
+    QUrl url(const QString &path) const;
+
+    // maxAgeSecs < 0 : pas de Cache-Control (seul l'ETag permet la revalidation)
+    void setResource(const QString &path, const QByteArray &body,
+                     const QByteArray &contentType = "text/html; charset=utf-8", int maxAgeSecs = -1);
+    void setLatency(int msecs) { latencyMs = msecs; }
+    // Débit maximal de chaque connexion (octets/s) ; 0 : illimité
+    void setBandwidth(qint64 bytesPerSecond);
+    qint64 requestCount() const { return requests; }
+
+private:
+    struct Resource {
+        QByteArray body;
+        QByteArray contentType;
+        QByteArray etag;
+        int maxAgeSecs = -1;
+    };
+
+    QHash<QString, Resource> resources;
+    QHash<QTcpSocket *, QByteArray> pending; // Octets reçus mais pas encore traités
+    struct Output {
+        QByteArray data;
+        qint64 sent = 0;
+    };
+    QHash<QTcpSocket *, Output> outgoing; // Réponses en attente d'envoi (débit limité)
+    QTimer *sendTimer = nullptr;
+    qint64 bandwidth = 0;
+    int latencyMs = 0;
+    qint64 requests = 0;
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    void respond(QTcpSocket *socket, const QByteArray &request);
+    void send(QTcpSocket *socket, const QByteArray &data);
+    void drainOutgoing();
+};
+
+#endif // STANDINSERVER_H
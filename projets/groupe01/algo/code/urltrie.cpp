@@ -0,0 +1,388 @@
+// urltrie.cpp
+#include "urltrie.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <queue>
+
+namespace {
+
+// log(exp(a) + exp(b)) sans dépassement de capacité
+double logAddExp(double a, double b)
+{
+    const double hi = std::max(a, b);
+    const double lo = std::min(a, b);
+    return hi + std::log1p(std::exp(lo - hi));
+}
+
+char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool startsWith(const std::string &s, const char *prefix)
+{
+    return s.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+} // namespace
+
+std::string UrlTrie::normalizeUrl(const std::string &url)
+{
+    std::string key(url.size(), '\0');
+    std::transform(url.begin(), url.end(), key.begin(), asciiLower);
+
+    if (startsWith(key, "https://")) {
+        key.erase(0, 8);
+    } else if (startsWith(key, "http://")) {
+        key.erase(0, 7);
+    }
+    if (startsWith(key, "www.")) {
+        key.erase(0, 4);
+    }
+    while (!key.empty() && key.back() == '/') {
+        key.pop_back();
+    }
+    return key;
+}
+
+std::string UrlTrie::entryKey(const std::string &url)
+{
+    size_t end = std::min(url.find('#'), url.size());
+    while (end > 0 && url[end - 1] == '/') {
+        --end;
+    }
+    return url.substr(0, end);
+}
+
+std::vector<std::string> UrlTrie::titleWords(const std::string &title)
+{
+    // Les octets >= 0x80 (UTF-8) font partie des mots : les lettres accentuées restent entières
+    std::vector<std::string> words;
+    std::string current;
+    for (char c : title) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (u >= 0x80 || std::isalnum(u)) {
+            current += asciiLower(c);
+        } else if (!current.empty()) {
+            words.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        words.push_back(std::move(current));
+    }
+
+    words.erase(std::remove_if(words.begin(), words.end(),
+                               [](const std::string &w) { return w.size() < 2; }),
+                words.end());
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    if (words.size() > 8) {
+        words.resize(8); // Les titres très longs n'apportent rien de plus à l'autocomplétion
+    }
+    return words;
+}
+
+void UrlTrie::recordVisit(const std::string &url, double timestampSecs)
+{
+    double visit = timestampSecs * std::log(2.0) / kHalfLifeSecs;
+
+    const std::string identity = entryKey(url);
+    auto it = entryByUrl.find(identity);
+    if (it == entryByUrl.end()) {
+        const std::string key = normalizeUrl(url);
+        if (key.empty()) {
+            return;
+        }
+        const uint32_t id = static_cast<uint32_t>(entries.size());
+        entries.push_back(Entry{url, std::string(), visit, {}});
+        entryByUrl.emplace(identity, id);
+        attach(insertKey(key), id);
+        return;
+    }
+
+    const uint32_t id = it->second;
+    if (entries[id].bookmarked) {
+        // Le bonus multiplie le poids de chaque visite : la nouvelle visite le reçoit aussi
+        visit += std::log(kBookmarkWeight);
+    }
+    entries[id].score = logAddExp(entries[id].score, visit);
+    for (uint32_t node : entries[id].keyNodes) {
+        promote(node, id);
+    }
+}
+
+void UrlTrie::setBookmarked(const std::string &url, bool bookmarked, double addedSecs)
+{
+    auto it = entryByUrl.find(entryKey(url));
+    if (it == entryByUrl.end()) {
+        if (!bookmarked) {
+            return;
+        }
+        recordVisit(url, addedSecs);
+        it = entryByUrl.find(entryKey(url));
+        if (it == entryByUrl.end()) {
+            return; // URL vide après normalisation
+        }
+    }
+    const uint32_t id = it->second;
+    if (entries[id].bookmarked == bookmarked) {
+        return;
+    }
+    entries[id].bookmarked = bookmarked;
+
+    if (bookmarked) {
+        entries[id].score += std::log(kBookmarkWeight);
+        for (uint32_t node : entries[id].keyNodes) {
+            promote(node, id);
+        }
+        return;
+    }
+    // Le score baisse : l'entrée est retirée puis réinsérée à sa place dans chaque liste.
+    // L'ordre de keyNodes est conservé (keyNodes[0] reste la clé de l'URL).
+    entries[id].score -= std::log(kBookmarkWeight);
+    const std::vector<uint32_t> keys = std::move(entries[id].keyNodes);
+    entries[id].keyNodes.clear();
+    for (uint32_t node : keys) {
+        detach(node, id);
+        attach(node, id);
+    }
+}
+
+void UrlTrie::setTitle(const std::string &url, const std::string &title)
+{
+    auto it = entryByUrl.find(entryKey(url));
+    if (it == entryByUrl.end() || entries[it->second].title == title) {
+        return;
+    }
+    const uint32_t id = it->second;
+
+    // keyNodes[0] est toujours la clé de l'URL : seuls les mots de l'ancien titre sont retirés
+    while (entries[id].keyNodes.size() > 1) {
+        const uint32_t node = entries[id].keyNodes.back();
+        entries[id].keyNodes.pop_back();
+        detach(node, id);
+    }
+
+    entries[id].title = title;
+    for (const std::string &word : titleWords(title)) {
+        const uint32_t node = insertKey(word);
+        const std::vector<uint32_t> &keys = entries[id].keyNodes;
+        if (std::find(keys.begin(), keys.end(), node) == keys.end()) {
+            attach(node, id);
+        }
+    }
+}
+
+uint32_t UrlTrie::findChild(uint32_t node, unsigned char first) const
+{
+    const std::vector<uint32_t> &children = nodes[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), first,
+                               [this](uint32_t child, unsigned char c) {
+                                   return static_cast<unsigned char>(nodes[child].label[0]) < c;
+                               });
+    if (it != children.end() && static_cast<unsigned char>(nodes[*it].label[0]) == first) {
+        return *it;
+    }
+    return kNoNode;
+}
+
+uint32_t UrlTrie::insertKey(const std::string &key)
+{
+    uint32_t node = 0;
+    size_t pos = 0;
+
+    while (pos < key.size()) {
+        const unsigned char first = static_cast<unsigned char>(key[pos]);
+        const uint32_t child = findChild(node, first);
+
+        if (child == kNoNode) {
+            // Aucune arête ne commence par ce caractère : nouvelle feuille
+            const uint32_t leaf = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            nodes[leaf].label = key.substr(pos);
+            nodes[leaf].parent = node;
+            std::vector<uint32_t> &children = nodes[node].children;
+            auto at = std::lower_bound(children.begin(), children.end(), first,
+                                       [this](uint32_t c, unsigned char f) {
+                                           return static_cast<unsigned char>(nodes[c].label[0]) < f;
+                                       });
+            children.insert(at, leaf);
+            return leaf;
+        }
+
+        const std::string &label = nodes[child].label;
+        size_t common = 0;
+        while (common < label.size() && pos + common < key.size()
+               && label[common] == key[pos + common]) {
+            ++common;
+        }
+        if (common == label.size()) {
+            node = child;
+            pos += common;
+            continue;
+        }
+
+        // La clé diverge au milieu de l'arête : on la coupe avec un nœud intermédiaire
+        const uint32_t mid = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes[mid].label = nodes[child].label.substr(0, common);
+        nodes[mid].parent = node;
+        nodes[mid].maxScore = nodes[child].maxScore;
+        nodes[mid].children.push_back(child);
+        nodes[child].label.erase(0, common);
+        nodes[child].parent = mid;
+        std::replace(nodes[node].children.begin(), nodes[node].children.end(), child, mid);
+
+        node = mid;
+        pos += common;
+    }
+    return node;
+}
+
+uint32_t UrlTrie::findSubtree(const std::string &prefix) const
+{
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < prefix.size()) {
+        const uint32_t child = findChild(node, static_cast<unsigned char>(prefix[pos]));
+        if (child == kNoNode) {
+            return kNoNode;
+        }
+        const std::string &label = nodes[child].label;
+        const size_t n = std::min(label.size(), prefix.size() - pos);
+        if (label.compare(0, n, prefix, pos, n) != 0) {
+            return kNoNode;
+        }
+        node = child;
+        pos += n;
+    }
+    return node;
+}
+
+void UrlTrie::attach(uint32_t node, uint32_t entry)
+{
+    std::vector<uint32_t> &list = nodes[node].entries;
+    const double score = entries[entry].score;
+    auto at = std::upper_bound(list.begin(), list.end(), score,
+                               [this](double s, uint32_t e) { return s < entries[e].score; });
+    list.insert(at, entry);
+    entries[entry].keyNodes.push_back(node);
+    raiseMaxScore(node, score);
+}
+
+void UrlTrie::detach(uint32_t node, uint32_t entry)
+{
+    std::vector<uint32_t> &list = nodes[node].entries;
+    list.erase(std::find(list.begin(), list.end(), entry));
+    recomputeMaxScore(node);
+}
+
+void UrlTrie::promote(uint32_t node, uint32_t entry)
+{
+    // Le score vient d'augmenter : l'entrée ne peut que se rapprocher de la fin de la liste.
+    // On cherche depuis la fin, où se trouvent les entrées visitées récemment.
+    std::vector<uint32_t> &list = nodes[node].entries;
+    auto it = std::find(list.rbegin(), list.rend(), entry).base() - 1;
+    const double score = entries[entry].score;
+    auto at = std::upper_bound(it + 1, list.end(), score,
+                               [this](double s, uint32_t e) { return s < entries[e].score; });
+    std::rotate(it, it + 1, at);
+    raiseMaxScore(node, score);
+}
+
+void UrlTrie::raiseMaxScore(uint32_t node, double score)
+{
+    while (node != kNoNode && nodes[node].maxScore < score) {
+        nodes[node].maxScore = score;
+        node = nodes[node].parent;
+    }
+}
+
+void UrlTrie::recomputeMaxScore(uint32_t node)
+{
+    while (node != kNoNode) {
+        double best = -1e300;
+        if (!nodes[node].entries.empty()) {
+            best = entries[nodes[node].entries.back()].score;
+        }
+        for (uint32_t child : nodes[node].children) {
+            best = std::max(best, nodes[child].maxScore);
+        }
+        if (best == nodes[node].maxScore) {
+            return; // Les ancêtres ne changent pas non plus
+        }
+        nodes[node].maxScore = best;
+        node = nodes[node].parent;
+    }
+}
+
+std::vector<UrlTrie::Suggestion> UrlTrie::complete(const std::string &prefix, int maxResults) const
+{
+    std::vector<Suggestion> results;
+    const std::string key = normalizeUrl(prefix);
+    if (key.empty() || maxResults <= 0) {
+        return results;
+    }
+    const uint32_t root = findSubtree(key);
+    if (root == kNoNode) {
+        return results;
+    }
+    return bestInSubtree(root, maxResults);
+}
+
+std::vector<UrlTrie::Suggestion> UrlTrie::topEntries(int maxResults) const
+{
+    if (maxResults <= 0 || entries.empty()) {
+        return {};
+    }
+    return bestInSubtree(0, maxResults);
+}
+
+std::vector<UrlTrie::Suggestion> UrlTrie::bestInSubtree(uint32_t root, int maxResults) const
+{
+    std::vector<Suggestion> results;
+
+    // Parcours "meilleur d'abord" : un élément de la file est soit un sous-arbre (borné par
+    // son maxScore), soit la position courante dans la liste triée d'entrées d'un nœud.
+    struct Item {
+        double score;
+        uint32_t node;
+        uint32_t pos; // kNoNode = sous-arbre entier, sinon index dans nodes[node].entries
+        bool operator<(const Item &other) const { return score < other.score; }
+    };
+    std::priority_queue<Item> queue;
+    queue.push(Item{nodes[root].maxScore, root, kNoNode});
+
+    std::vector<uint32_t> seen; // une entrée peut être atteinte par son URL et par son titre
+    while (!queue.empty() && static_cast<int>(results.size()) < maxResults) {
+        const Item item = queue.top();
+        queue.pop();
+        const Node &node = nodes[item.node];
+
+        if (item.pos == kNoNode) {
+            if (!node.entries.empty()) {
+                const uint32_t last = static_cast<uint32_t>(node.entries.size() - 1);
+                queue.push(Item{entries[node.entries[last]].score, item.node, last});
+            }
+            for (uint32_t child : node.children) {
+                if (nodes[child].maxScore > -1e300) {
+                    queue.push(Item{nodes[child].maxScore, child, kNoNode});
+                }
+            }
+            continue;
+        }
+
+        const uint32_t id = node.entries[item.pos];
+        if (std::find(seen.begin(), seen.end(), id) == seen.end()) {
+            seen.push_back(id);
+            results.push_back(Suggestion{entries[id].url, entries[id].title, entries[id].score});
+        }
+        if (item.pos > 0) {
+            queue.push(Item{entries[node.entries[item.pos - 1]].score, item.node, item.pos - 1});
+        }
+    }
+    return results;
+}
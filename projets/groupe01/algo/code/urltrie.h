@@ -0,0 +1,91 @@
+// urltrie.h
+#ifndef URLTRIE_H
+#define URLTRIE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Index d'autocomplétion de la barre d'adresse.
+// Arbre radix (trie compressé) sur les URL visitées et les mots de leurs titres,
+// classé par "frecency" (fréquence × récence).
+//
+// Le score d'une entrée est log(somme des exp(lambda * t_visite)) : ce score ne fait
+// qu'augmenter à chaque visite et l'ordre entre deux entrées ne dépend pas de l'heure
+// courante, ce qui permet une mise à jour incrémentale en O(1) sans jamais recalculer
+// tout l'index. Chaque nœud mémorise le meilleur score de son sous-arbre, et la
+// recherche parcourt l'arbre en "meilleur d'abord" : elle ne visite que les nœuds
+// nécessaires aux k meilleurs résultats, quelle que soit la taille de l'historique.
+//
+// Cette classe n'est pas thread-safe : elle est possédée par le thread de l'OmniboxIndex.
+class UrlTrie
+{
+public:
+    struct Suggestion {
+        std::string url;
+        std::string title;
+        double score;
+    };
+
+    // Demi-vie de la récence (en secondes) : une visite vieille de 30 jours compte moitié.
+    static constexpr double kHalfLifeSecs = 30.0 * 24 * 3600;
+    // Bonus d'un favori, ajouté au score : un favori compte comme si chacune de ses visites
+    // avait été faite kBookmarkWeight fois
+    static constexpr double kBookmarkWeight = 8.0;
+
+    // Enregistre une visite de l'URL à l'instant donné (secondes depuis l'époque Unix)
+    void recordVisit(const std::string &url, double timestampSecs);
+    // Associe un titre à une URL déjà visitée (indexe les mots du titre)
+    void setTitle(const std::string &url, const std::string &title);
+    // Ajoute ou retire le bonus de favori ; un favori jamais visité compte pour une visite
+    // à sa date d'ajout
+    void setBookmarked(const std::string &url, bool bookmarked, double addedSecs);
+    // Renvoie au plus maxResults suggestions dont l'URL ou un mot du titre commence par prefix
+    std::vector<Suggestion> complete(const std::string &prefix, int maxResults) const;
+    // Les maxResults entrées de meilleur score, toutes URL confondues (préchargement)
+    std::vector<Suggestion> topEntries(int maxResults) const;
+
+    size_t size() const { return entries.size(); }
+
+    // Clé d'indexation d'une URL : minuscules, sans schéma "http(s)://" ni "www."
+    static std::string normalizeUrl(const std::string &url);
+
+private:
+    static constexpr uint32_t kNoNode = 0xFFFFFFFFu;
+
+    struct Entry {
+        std::string url;
+        std::string title;
+        double score;                  // log-frecency (voir plus haut), bonus de favori compris
+        std::vector<uint32_t> keyNodes; // nœuds terminaux qui référencent cette entrée
+        bool bookmarked = false;
+    };
+
+    struct Node {
+        std::string label;              // étiquette de l'arête entrante
+        uint32_t parent = kNoNode;
+        double maxScore = -1e300;       // meilleur score du sous-arbre
+        std::vector<uint32_t> children; // triés par premier octet de l'étiquette
+        std::vector<uint32_t> entries;  // triées par score croissant (la meilleure en dernier)
+    };
+
+    std::vector<Node> nodes = std::vector<Node>(1); // nœud 0 = racine
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, uint32_t> entryByUrl; // Clé : entryKey(url)
+
+    uint32_t insertKey(const std::string &key);
+    uint32_t findChild(uint32_t node, unsigned char first) const;
+    uint32_t findSubtree(const std::string &prefix) const;
+    std::vector<Suggestion> bestInSubtree(uint32_t root, int maxResults) const;
+    void attach(uint32_t node, uint32_t entry);
+    void detach(uint32_t node, uint32_t entry);
+    void promote(uint32_t node, uint32_t entry);
+    void raiseMaxScore(uint32_t node, double score);
+    void recomputeMaxScore(uint32_t node);
+    static std::vector<std::string> titleWords(const std::string &title);
+    // Identité d'une entrée, comme BookmarkStore::urlKey : sans fragment ni '/' final
+    static std::string entryKey(const std::string &url);
+};
+
+#endif // URLTRIE_H
@@ -0,0 +1,40 @@
+// webcookiejar.cpp
+#include "webcookiejar.h"
+
+#include <QNetworkCookie>
+#include <QWebEngineCookieStore>
+
+WebCookieJar::WebCookieJar(QWebEngineCookieStore *store, QObject *parent)
+    : QNetworkCookieJar(parent)
+    , store(store)
+{
+    // Le magasin annonce d'abord tous ses cookies (loadAllCookies), puis chaque changement
+    connect(store, &QWebEngineCookieStore::cookieAdded, this, [this](const QNetworkCookie &cookie) {
+        insertCookie(cookie);
+    });
+    connect(store, &QWebEngineCookieStore::cookieRemoved, this, [this](const QNetworkCookie &cookie) {
+        deleteCookie(cookie);
+    });
+    store->loadAllCookies();
+}
+
+bool WebCookieJar::setCookiesFromUrl(const QList<QNetworkCookie> &cookies, const QUrl &url)
+{
+    // Seuls les cookies valables pour l'URL (domaine, chemin) vont au moteur, qui les renverra
+    // par cookieAdded (insertCookie remplace alors le cookie à l'identique). Un cookie déjà
+    // expiré est une suppression : insertCookie l'a retiré du pot, on le retire du moteur.
+    bool added = false;
+    for (QNetworkCookie cookie : cookies) {
+        cookie.normalize(url);
+        if (!validateCookie(cookie, url)) {
+            continue;
+        }
+        if (insertCookie(cookie)) {
+            store->setCookie(cookie, url);
+            added = true;
+        } else {
+            store->deleteCookie(cookie, url);
+        }
+    }
+    return added;
+}
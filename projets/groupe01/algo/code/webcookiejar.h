@@ -0,0 +1,27 @@
+// webcookiejar.h
+#ifndef WEBCOOKIEJAR_H
+#define WEBCOOKIEJAR_H
+
+#include <QNetworkCookieJar>
+
+class QWebEngineCookieStore;
+
+// Pot de cookies des QNetworkAccessManager de l'application (cache HTTP, téléchargements),
+// tenu à l'image du magasin de cookies du profil web : une session ouverte dans une page
+// vaut aussi pour les requêtes faites hors du moteur, et les cookies que reçoivent ces
+// requêtes (Set-Cookie) sont rendus au moteur.
+// Un même pot sert plusieurs gestionnaires : après setCookieJar(), lui redonner son parent.
+class WebCookieJar : public QNetworkCookieJar
+{
+    Q_OBJECT
+
+public:
+    explicit WebCookieJar(QWebEngineCookieStore *store, QObject *parent = nullptr);
+
+    bool setCookiesFromUrl(const QList<QNetworkCookie> &cookies, const QUrl &url) override;
+
+private:
+    QWebEngineCookieStore *store;
+};
+
+#endif // WEBCOOKIEJAR_H
@@ -0,0 +1,53 @@
+#ifndef CONCURRENT_BOOKING_H
+#define CONCURRENT_BOOKING_H
+
+#include <string>
+#include <vector>
+
+#include "reservation_table.h"
+#include "seat_map.h"
+#include "section_pricing.h"
+
+// Vente concurrente : appelable par autant de threads que d'acheteurs, sans verrou.
+// Les places sont prises par compare-and-swap sur les mots du plan de salle et les numéros
+// viennent du compteur atomique de la table. Chaque thread range ses ventes dans son propre
+// vecteur ; le propriétaire de la ReservationTable les y ajoute ensuite (commitBookings).
+// Avec des prix (pricing), chaque vente met à jour ceux de sa section, sans verrou non plus.
+struct Booking {
+    int reservationNumber;
+    SeatId seat;
+    Cents price;
+};
+
+// count places côte à côte ; false si la salle n'en a plus. La recherche part du rang startRow,
+// qui devient le rang de la vente : l'acheteur suivant du même thread ne repasse pas sur les
+// rangs déjà pleins.
+inline bool bookAdjacent(SeatMap& seats, ReservationTable& table, uint32_t count, uint32_t& startRow,
+                         std::vector<Booking>& out, SectionPricing* pricing = nullptr) {
+    SeatId first;
+    if (!seats.claimAdjacent(count, first, -1, startRow)) return false;
+    startRow = seats.sectionList()[first.section].firstRow + first.row;
+    const Cents price = pricing ? pricing->taken(first.section, count) : 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        out.push_back(Booking{table.nextNumber(), SeatId{first.section, first.row, first.number + i}, price});
+    }
+    return true;
+}
+
+// Une place précise ; false si quelqu'un l'a déjà
+inline bool bookSeat(SeatMap& seats, ReservationTable& table, const SeatId& seat, std::vector<Booking>& out,
+                     SectionPricing* pricing = nullptr) {
+    if (!seats.claim(seat)) return false;
+    out.push_back(Booking{table.nextNumber(), seat, pricing ? pricing->taken(seat.section, 1) : 0});
+    return true;
+}
+
+// Thread propriétaire de la table uniquement
+inline void commitBookings(ReservationTable& table, const SeatMap& seats, const std::vector<Booking>& bookings,
+                           const std::string& event, const std::string& client, const std::string& date) {
+    for (const Booking& b : bookings) {
+        table.add(b.reservationNumber, event, client, date, seats.label(b.seat), b.price);
+    }
+}
+
+#endif // CONCURRENT_BOOKING_H
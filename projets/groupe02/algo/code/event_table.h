@@ -0,0 +1,294 @@
+#ifndef EVENT_TABLE_H
+#define EVENT_TABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "seat_map.h"
+#include "section_pricing.h"
+
+// Dates : un numéro de jour (jours depuis le 01/01/1970, calendrier grégorien).
+// Comparer, trier ou chercher un intervalle de dates revient à comparer des entiers.
+inline int dayNumber(int day, int month, int year) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = year - era * 400;
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline void civilDate(int dayNum, int& day, int& month, int& year) {
+    dayNum += 719468;
+    const int era = (dayNum >= 0 ? dayNum : dayNum - 146096) / 146097;
+    const int doe = dayNum - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2);
+}
+
+// "15/12/2023" -> numéro de jour ; false si la date n'existe pas
+inline bool parseDate(std::string_view text, int& dayNum) {
+    int parts[3] = {0, 0, 0};
+    int field = 0;
+    size_t digits = 0;
+    for (char c : text) {
+        if (c == '/') {
+            if (digits == 0 || ++field > 2) return false;
+            digits = 0;
+        } else if (c >= '0' && c <= '9' && digits < 4) {
+            parts[field] = parts[field] * 10 + (c - '0');
+            ++digits;
+        } else {
+            return false;
+        }
+    }
+    if (field != 2 || digits == 0) return false;
+    int d, m, y;
+    dayNum = dayNumber(parts[0], parts[1], parts[2]);
+    civilDate(dayNum, d, m, y);
+    return d == parts[0] && m == parts[1] && y == parts[2];
+}
+
+inline std::string formatDate(int dayNum) {
+    int d, m, y;
+    civilDate(dayNum, d, m, y);
+    char buffer[32];
+    std::snprintf(buffer, sizeof buffer, "%02d/%02d/%04d", d, m, y);
+    return buffer;
+}
+
+// Shard d'un événement parmi shardCount, par hachage FNV-1a de son nom : contrairement à
+// std::hash, le résultat ne change pas d'une compilation à l'autre, et les journaux des shards
+// restent valables
+inline uint32_t shardOf(std::string_view name, uint32_t shardCount) {
+    uint32_t h = 2166136261u;
+    for (char c : name) h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    return h % shardCount;
+}
+
+// Table des événements, rangée par colonnes : les noms, les jours, les lieux, les plans de
+// salle et les prix sont dans des tableaux séparés, un événement est un indice dans ces tableaux.
+// Une recherche par dates passe par l'index : elle ne touche que les événements de l'intervalle.
+//
+// Index : par nom (hachage), par date (couples jour/événement triés) et, pour chaque lieu,
+// par date également. Un ajout isolé est inséré à sa place ; le catalogue, lui, est ajouté en
+// vrac puis les index sont triés une seule fois.
+class EventTable {
+public:
+    using EventId = uint32_t;
+
+    EventId add(const std::string& name, int day, const std::string& venue) {
+        return append(name, day, venue, true);
+    }
+
+    size_t size() const { return names.size(); }
+    const std::string& name(EventId id) const { return names[id]; }
+    int day(EventId id) const { return days[id]; }
+    const std::string& venue(EventId id) const { return venueNames[venues[id]]; }
+    SeatMap& seats(EventId id) { return seatMaps[id]; }
+    const SeatMap& seats(EventId id) const { return seatMaps[id]; }
+    SectionPricing& pricing(EventId id) { return prices[id]; }
+    const SectionPricing& pricing(EventId id) const { return prices[id]; }
+
+    // Prix de base des sections (dans l'ordre du plan), une fois la salle construite
+    void setPrices(EventId id, const std::vector<Cents>& basePrices) {
+        prices[id] = SectionPricing(seatMaps[id], basePrices);
+    }
+
+    // -1 si l'événement (ou le lieu) n'existe pas
+    int find(const std::string& name) const {
+        auto it = byName.find(name);
+        return it == byName.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    int findVenue(const std::string& venue) const {
+        auto it = venueByName.find(venue);
+        return it == venueByName.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    // Événements du jour fromDay au jour toDay inclus, par date ; venue = -1 : tous les lieux
+    std::vector<EventId> between(int fromDay, int toDay, int venue = -1) const {
+        const std::vector<DateKey>& index = venue < 0 ? byDate : byVenueDate[venue];
+        auto first = std::lower_bound(index.begin(), index.end(), DateKey{fromDay, 0});
+        std::vector<EventId> result;
+        for (auto it = first; it != index.end() && it->day <= toDay; ++it) result.push_back(it->id);
+        return result;
+    }
+
+    // Catalogue : une ligne par événement, lue par blocs sans copie intermédiaire des champs
+    //   nom|jj/mm/aaaa|lieu|plan
+    // Le plan est une liste séparée par des virgules de rangs "A:20" (étiquette:places) et de
+    // sections "Nord=50x300" (nom=rangs x places par rang), chacun suivi au besoin de son prix
+    // de base : "Nord=50x300@45.50". Le prix d'un rang est celui de toute sa section.
+    // Lignes vides et '#' ignorées.
+    // Renvoie false si le fichier ne peut pas être ouvert ; les lignes invalides sont sautées
+    // et leurs numéros ajoutés à badLines. Avec shardCount > 1, seuls les événements du shard
+    // shardIndex sont gardés (shardOf).
+    bool loadCatalogue(const std::string& path, std::vector<size_t>* badLines = nullptr,
+                       uint32_t shardIndex = 0, uint32_t shardCount = 1) {
+        keepShard = shardIndex;
+        shardTotal = shardCount;
+        std::FILE* in = std::fopen(path.c_str(), "rb");
+        if (!in) return false;
+        std::vector<char> buffer(1 << 16);
+        size_t kept = 0;
+        size_t lineNumber = 0;
+        while (true) {
+            const size_t n = std::fread(buffer.data() + kept, 1, buffer.size() - kept, in);
+            const size_t end = kept + n;
+            size_t begin = 0;
+            for (size_t nl; (nl = findNewline(buffer, begin, end)) != end; begin = nl + 1) {
+                ++lineNumber;
+                if (!parseLine(std::string_view(&buffer[begin], nl - begin)) && badLines) badLines->push_back(lineNumber);
+            }
+            if (n == 0) {
+                // Dernière ligne sans retour à la ligne
+                if (begin < end && !parseLine(std::string_view(&buffer[begin], end - begin)) && badLines) {
+                    badLines->push_back(lineNumber + 1);
+                }
+                break;
+            }
+            // La ligne incomplète revient en tête du tampon, agrandi si elle le remplit
+            kept = end - begin;
+            std::copy(buffer.begin() + begin, buffer.begin() + end, buffer.begin());
+            if (kept == buffer.size()) buffer.resize(buffer.size() * 2);
+        }
+        std::fclose(in);
+        sortIndexes();
+        return true;
+    }
+
+private:
+    struct DateKey {
+        int day;
+        EventId id;
+        bool operator<(const DateKey& o) const { return day != o.day ? day < o.day : id < o.id; }
+    };
+
+    // Colonnes
+    std::vector<std::string> names;
+    std::vector<int> days;
+    std::vector<uint32_t> venues;
+    std::vector<SeatMap> seatMaps;
+    std::vector<SectionPricing> prices;
+
+    std::vector<std::string> venueNames;
+    std::unordered_map<std::string, uint32_t> venueByName;
+    std::unordered_map<std::string, EventId> byName;
+    std::vector<DateKey> byDate;
+    std::vector<std::vector<DateKey>> byVenueDate;
+    uint32_t keepShard = 0;   // Shard gardé par loadCatalogue, parmi shardTotal
+    uint32_t shardTotal = 1;
+
+    // sorted = false : les index sont triés plus tard par sortIndexes
+    EventId append(const std::string& name, int day, const std::string& venue, bool sorted) {
+        const EventId id = static_cast<EventId>(names.size());
+        auto [venueIt, isNew] = venueByName.try_emplace(venue, static_cast<uint32_t>(venueNames.size()));
+        if (isNew) {
+            venueNames.push_back(venue);
+            byVenueDate.emplace_back();
+        }
+        names.push_back(name);
+        days.push_back(day);
+        venues.push_back(venueIt->second);
+        seatMaps.emplace_back();
+        prices.emplace_back();
+        byName.emplace(name, id);
+        insert(byDate, DateKey{day, id}, sorted);
+        insert(byVenueDate[venueIt->second], DateKey{day, id}, sorted);
+        return id;
+    }
+
+    static void insert(std::vector<DateKey>& index, const DateKey& key, bool sorted) {
+        if (!sorted || index.empty() || !(key < index.back())) {
+            index.push_back(key);
+        } else {
+            index.insert(std::upper_bound(index.begin(), index.end(), key), key);
+        }
+    }
+
+    void sortIndexes() {
+        std::sort(byDate.begin(), byDate.end());
+        for (std::vector<DateKey>& index : byVenueDate) std::sort(index.begin(), index.end());
+    }
+
+    static size_t findNewline(const std::vector<char>& buffer, size_t begin, size_t end) {
+        const char* p = static_cast<const char*>(std::memchr(buffer.data() + begin, '\n', end - begin));
+        return p ? static_cast<size_t>(p - buffer.data()) : end;
+    }
+
+    static bool parseCount(std::string_view text, uint32_t& value) {
+        if (text.empty() || text.size() > 9) return false;
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + static_cast<uint32_t>(c - '0');
+        }
+        return true;
+    }
+
+    // Découpe text au premier separator : head avant, text après (vide s'il n'y en a pas)
+    static std::string_view split(std::string_view& text, char separator) {
+        const size_t pos = text.find(separator);
+        const std::string_view head = text.substr(0, pos);
+        text = pos == std::string_view::npos ? std::string_view() : text.substr(pos + 1);
+        return head;
+    }
+
+    bool parseLine(std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line[0] == '#') return true;
+
+        const std::string_view name = split(line, '|');
+        if (shardTotal > 1 && !name.empty() && shardOf(name, shardTotal) != keepShard) return true;
+        const std::string_view date = split(line, '|');
+        const std::string_view venue = split(line, '|');
+        std::string_view plan = line;
+        int day;
+        if (name.empty() || !parseDate(date, day) || plan.empty() || find(std::string(name)) >= 0) return false;
+
+        // Le plan est vérifié avant d'ajouter l'événement
+        SeatMap seats;
+        std::vector<Cents> basePrices;
+        while (!plan.empty()) {
+            std::string_view item = split(plan, ',');
+            const size_t at = item.find('@');
+            const std::string_view price = at == std::string_view::npos ? std::string_view() : item.substr(at + 1);
+            item = item.substr(0, at);
+            uint32_t rows, perRow;
+            if (const size_t eq = item.find('='); eq != std::string_view::npos) {
+                std::string_view size = item.substr(eq + 1);
+                const std::string_view rowText = split(size, 'x');
+                if (!parseCount(rowText, rows) || !parseCount(size, perRow) || rows == 0 || perRow == 0) return false;
+                seats.addSection(std::string(item.substr(0, eq)), rows, perRow);
+            } else if (const size_t colon = item.rfind(':'); colon != std::string_view::npos) {
+                if (!parseCount(item.substr(colon + 1), perRow) || perRow == 0) return false;
+                seats.addRow(std::string(item.substr(0, colon)), perRow);
+            } else {
+                return false;
+            }
+            if (at != std::string_view::npos) {
+                Cents cents;
+                if (!parsePrice(std::string(price), cents)) return false;
+                basePrices.resize(seats.sectionList().size());
+                basePrices.back() = cents;
+            }
+        }
+        const EventId id = append(std::string(name), day, std::string(venue), false);
+        prices[id] = SectionPricing(seats, basePrices);
+        seatMaps[id] = std::move(seats);
+        return true;
+    }
+};
+
+#endif // EVENT_TABLE_H
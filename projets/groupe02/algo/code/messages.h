@@ -0,0 +1,152 @@
+#ifndef MESSAGES_H
+#define MESSAGES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Catalogue des messages de l'interface. Chaque ligne donne l'identifiant du message puis son
+// texte dans chaque langue ; "{}" marque un argument, remplacé dans l'ordre par appendMessage.
+// Les identifiants sont des constantes de l'énumération Msg et chaque langue a sa propre table
+// contiguë : afficher un message n'est qu'une indexation kMessages[langue][id].
+//
+// Ajouter une langue : une valeur dans Language, une colonne dans chaque ligne et une table.
+#define RESERVATION_MESSAGES(X) \
+    X(LanguageName, "Français", "English", "Español") \
+    X(InvalidChoice, "Choix invalide!", "Invalid choice!", "¡Opción no válida!") \
+    X(SoldOut, "Aucune place disponible.", "No seats available.", "No quedan asientos.") \
+    X(NotEnoughSeats, "Pas assez de places côte à côte!", "Not enough adjacent seats!", \
+      "¡No hay suficientes asientos contiguos!") \
+    X(InvalidSeat, "Place invalide!", "Invalid seat!", "¡Asiento no válido!") \
+    X(UnknownHold, "Retenue introuvable ou expirée!", "Hold not found or expired!", \
+      "¡Retención no encontrada o caducada!") \
+    X(UnknownReservation, "Réservation introuvable!", "Reservation not found!", "¡Reserva no encontrada!") \
+    X(UnknownWait, "Attente introuvable!", "Waitlist entry not found!", "¡Inscripción en lista de espera no encontrada!") \
+    X(WaitSeatsRange, "De 1 à {} places sur liste d'attente!", "1 to {} seats on a waitlist!", \
+      "¡De 1 a {} asientos en lista de espera!") \
+    X(CatalogueNotFound, "Catalogue introuvable : {}", "Catalogue not found: {}", "Catálogo no encontrado: {}") \
+    X(CatalogueLineIgnored, "{}:{} : ligne ignorée", "{}:{}: line ignored", "{}:{}: línea ignorada") \
+    X(Price, "{} EUR", "{} EUR", "{} EUR") \
+    X(SaveError, "Erreur de sauvegarde : opération annulée.", "Save error: operation cancelled.", \
+      "Error al guardar: operación cancelada.") \
+    X(WaitAllocated, "Liste d'attente n° {} : {} -> {}{}", "Waitlist #{}: {} -> {}{}", "Lista de espera n.º {}: {} -> {}{}") \
+    X(JoinWaitlistPrompt, "S'inscrire sur la liste d'attente ? (o/n) : ", "Join the waitlist? (y/n): ", \
+      "¿Inscribirse en la lista de espera? (s/n): ") \
+    X(AdjacentCountPrompt, "Nombre de places côte à côte : ", "Number of adjacent seats: ", \
+      "Número de asientos contiguos: ") \
+    X(WaitJoined, "Inscrit sur la liste d'attente (n° {})", "Added to the waitlist (#{})", \
+      "Inscrito en la lista de espera (n.º {})") \
+    X(WaitNumberPrompt, "Numéro d'attente : ", "Waitlist number: ", "Número de espera: ") \
+    X(WaitLeft, "Retiré de la liste d'attente.", "Removed from the waitlist.", "Eliminado de la lista de espera.") \
+    X(EventDate, "Date: {}", "Date: {}", "Fecha: {}") \
+    X(EventVenue, "Lieu: {}", "Location: {}", "Lugar: {}") \
+    X(EventSeats, "Places: {}", "Seats: {}", "Asientos: {}") \
+    X(EventPrices, "Prix: {}", "Price: {}", "Precio: {}") \
+    X(FromPrompt, "Du (jj/mm/aaaa) : ", "From (dd/mm/yyyy): ", "Desde (dd/mm/aaaa): ") \
+    X(ToPrompt, "Au (jj/mm/aaaa) : ", "To (dd/mm/yyyy): ", "Hasta (dd/mm/aaaa): ") \
+    X(VenuePrompt, "Lieu (* pour tous) : ", "Venue (* for all): ", "Lugar (* para todos): ") \
+    X(InvalidDate, "Date invalide!", "Invalid date!", "¡Fecha no válida!") \
+    X(UnknownVenue, "Lieu inconnu!", "Unknown venue!", "¡Lugar desconocido!") \
+    X(EventsTitle, "=== ÉVÉNEMENTS DISPONIBLES ===", "=== AVAILABLE EVENTS ===", "=== EVENTOS DISPONIBLES ===") \
+    X(ChooseEventPrompt, "Choisissez un événement (numéro): ", "Choose an event (number): ", \
+      "Elija un evento (número): ") \
+    X(ClientNamePrompt, "Nom du client : ", "Client name: ", "Nombre del cliente: ") \
+    X(SeatRequestPrompt, "Place (ex. A1), ou nombre de places côte à côte : ", \
+      "Seat (e.g. A1), or number of adjacent seats: ", "Asiento (p. ej. A1), o número de asientos contiguos: ") \
+    X(HeldUntil, "Places retenues jusqu'à {} (retenue n° {})", "Seats held until {} (hold #{})", \
+      "Asientos retenidos hasta las {} (retención n.º {})") \
+    X(HoldTotal, "Total: {} EUR", "Total: {} EUR", "Total: {} EUR") \
+    X(ConfirmNowPrompt, "Confirmer maintenant ? (o/n) : ", "Confirm now? (y/n): ", "¿Confirmar ahora? (s/n): ") \
+    X(ConfirmLater, "Confirmez la retenue depuis le menu [4].", "Confirm the hold from menu [4].", \
+      "Confirme la retención desde el menú [4].") \
+    X(ReservationLine, "{} : réservation n° {}  {} EUR", "{}: reservation #{}  {} EUR", "{}: reserva n.º {}  {} EUR") \
+    X(ReservationConfirmed, "Réservation confirmée!", "Reservation confirmed!", "¡Reserva confirmada!") \
+    X(HoldNumberPrompt, "Numéro de la retenue : ", "Hold number: ", "Número de la retención: ") \
+    X(SearchPrompt, "Numéro de réservation ou nom du client : ", "Reservation number or client name: ", \
+      "Número de reserva o nombre del cliente: ") \
+    X(NoReservationFound, "Aucune réservation trouvée.", "No reservation found.", "No se encontró ninguna reserva.") \
+    X(CancelPrompt, "Numéro de la réservation à annuler : ", "Number of the reservation to cancel: ", \
+      "Número de la reserva a cancelar: ") \
+    X(ReservationCancelled, "Réservation annulée.", "Reservation cancelled.", "Reserva cancelada.") \
+    X(MenuTitle, "=== MENU PRINCIPAL ===", "=== MAIN MENU ===", "=== MENÚ PRINCIPAL ===") \
+    X(MenuEvents, "[1] Voir les événements", "[1] View events", "[1] Ver los eventos") \
+    X(MenuFind, "[2] Rechercher une réservation", "[2] Find a reservation", "[2] Buscar una reserva") \
+    X(MenuCancel, "[3] Annuler une réservation", "[3] Cancel a reservation", "[3] Cancelar una reserva") \
+    X(MenuConfirm, "[4] Confirmer une retenue", "[4] Confirm a hold", "[4] Confirmar una retención") \
+    X(MenuLeaveWait, "[5] Quitter une liste d'attente", "[5] Leave a waitlist", "[5] Salir de una lista de espera") \
+    X(MenuLanguage, "[6] Langue", "[6] Language", "[6] Idioma") \
+    X(MenuExit, "[7] Quitter", "[7] Exit", "[7] Salir") \
+    X(ChoicePrompt, "Votre choix : ", "Your choice: ", "Su opción: ") \
+    X(ShardedData, "Données écrites avec {} shards : utilisez --batch --shards {}.", \
+      "Data written with {} shards: use --batch --shards {}.", "Datos escritos con {} shards: use --batch --shards {}.") \
+    X(Goodbye, "Merci et à bientôt !", "Thank you and goodbye!", "¡Gracias y hasta pronto!")
+
+enum Language : uint8_t { FRENCH, ENGLISH, SPANISH, kLanguageCount };
+
+#define MESSAGE_ID(id, fr, en, es) id,
+#define MESSAGE_FR(id, fr, en, es) fr,
+#define MESSAGE_EN(id, fr, en, es) en,
+#define MESSAGE_ES(id, fr, en, es) es,
+
+enum class Msg : uint16_t { RESERVATION_MESSAGES(MESSAGE_ID) Count };
+
+constexpr size_t kMessageCount = static_cast<size_t>(Msg::Count);
+
+inline constexpr std::string_view kMessages[kLanguageCount][kMessageCount] = {
+    {RESERVATION_MESSAGES(MESSAGE_FR)},
+    {RESERVATION_MESSAGES(MESSAGE_EN)},
+    {RESERVATION_MESSAGES(MESSAGE_ES)},
+};
+
+#undef MESSAGE_ID
+#undef MESSAGE_FR
+#undef MESSAGE_EN
+#undef MESSAGE_ES
+
+constexpr std::string_view message(Language lang, Msg id) {
+    return kMessages[lang][static_cast<size_t>(id)];
+}
+
+constexpr size_t placeholderCount(std::string_view text) {
+    size_t count = 0;
+    for (size_t i = 0; i + 1 < text.size(); ++i) {
+        if (text[i] == '{' && text[i + 1] == '}') ++count;
+    }
+    return count;
+}
+
+// Chaque traduction attend les mêmes arguments que le français : vérifié à la compilation
+constexpr bool catalogueConsistent() {
+    for (size_t id = 0; id < kMessageCount; ++id) {
+        for (size_t lang = 0; lang < kLanguageCount; ++lang) {
+            if (kMessages[lang][id].empty()) return false;
+            if (placeholderCount(kMessages[lang][id]) != placeholderCount(kMessages[FRENCH][id])) return false;
+        }
+    }
+    return true;
+}
+static_assert(catalogueConsistent(), "traduction vide ou nombre d'arguments différent du français");
+
+// Longueur du texte une fois ses "{}" remplacés par args (en octets, comme l'affichage centré)
+inline size_t messageLength(std::string_view text, std::initializer_list<std::string_view> args) {
+    size_t length = text.size() - 2 * placeholderCount(text);
+    for (std::string_view arg : args) length += arg.size();
+    return length;
+}
+
+// Ajoute text à out en remplaçant chaque "{}" par l'argument suivant (vide s'il en manque)
+inline void appendMessage(std::string& out, std::string_view text, std::initializer_list<std::string_view> args) {
+    const std::string_view* arg = args.begin();
+    size_t start = 0;
+    for (size_t i = 0; i + 1 < text.size(); ++i) {
+        if (text[i] != '{' || text[i + 1] != '}') continue;
+        out.append(text, start, i - start);
+        if (arg != args.end()) out.append(*arg++);
+        start = ++i + 1;
+    }
+    out.append(text, start);
+}
+
+#endif // MESSAGES_H
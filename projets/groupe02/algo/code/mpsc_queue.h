@@ -0,0 +1,73 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// File plusieurs producteurs / un consommateur, sans verrou (file intrusive de Vyukov).
+// push peut être appelé par n'importe quel thread : un échange atomique sur la tête, puis le
+// chaînage du nouveau maillon. pop n'est appelé que par le thread consommateur.
+//
+// Un producteur interrompu entre l'échange et le chaînage cache momentanément la suite de la
+// file : pop renvoie alors false, et le consommateur réessaie plus tard.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {}
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node;
+        node->value = std::move(value);
+        append(node);
+    }
+
+    // Consommateur uniquement ; false si la file est vide (ou un push pas encore chaîné)
+    bool pop(T& out) {
+        Node* first = tail;
+        Node* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (!next) return false;
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (!next) {
+            // Dernier maillon : on remet le maillon vide derrière lui pour pouvoir le détacher
+            if (first != head.load(std::memory_order_acquire)) return false;
+            stub.next.store(nullptr, std::memory_order_relaxed);
+            append(&stub);
+            next = first->next.load(std::memory_order_acquire);
+            if (!next) return false;
+        }
+        tail = next;
+        out = std::move(first->value);
+        delete first;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    std::atomic<Node*> head;   // Dernier maillon ajouté (côté producteurs)
+    Node* tail;                // Prochain maillon à lire (côté consommateur)
+    Node stub;
+
+    void append(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+};
+
+#endif // MPSC_QUEUE_H
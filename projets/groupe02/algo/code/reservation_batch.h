@@ -0,0 +1,314 @@
+#ifndef RESERVATION_BATCH_H
+#define RESERVATION_BATCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "reservation_engine.h"
+
+// Mode batch : une commande par ligne, champs séparés par '|', une ligne de réponse par commande
+//   HOLD|événement|client|place ou nombre   -> OK|retenue|échéance|A1,A2|total
+//   BOOK|événement|client|place ou nombre   -> OK|12,13|A1,A2|total
+//   CONFIRM|retenue                          -> OK|12,13|total
+//   CANCEL|réservation                       -> OK
+//   FIND|réservation                         -> OK|numéro|événement|client|date|place|prix
+//   FREE|événement                           -> OK|places libres
+//   QUOTE|événement                          -> OK|Nord:4500,Sud:3000 (prix courant par section)
+//   CLIENT|client                            -> OK|12,13 (ses réservations, par numéro)
+//   WAIT|événement|client|nombre[|priorité]  -> OK|attente
+//   LEAVE|attente                            -> OK
+// Les montants sont en centimes. En cas d'échec : ERR|<statut> (UNKNOWN_EVENT, SOLD_OUT...)
+// ou ERR|BAD_COMMAND.
+// Une commande qui libère des places (CANCEL, échéance d'une retenue) ou une inscription
+// servie aussitôt ajoute après sa réponse une ligne ALLOC|attente|12,13|A1,A2 par attente servie.
+// Les lignes vides et celles qui commencent par '#' sont ignorées, sans réponse.
+//
+// L'entrée est lue par blocs de 64 Kio. Les commandes d'un bloc sont rendues durables par un
+// seul commit du journal, puis leurs réponses sont écrites d'un seul tenant. Si ce commit
+// échoue, chaque commande du bloc répond ERR|STORAGE (et aucune ligne ALLOC n'est écrite) :
+// le moteur annule tout le bloc (voir ReservationEngine::commit), comme s'il n'avait pas été
+// reçu. Une commande refusée ainsi peut être renvoyée telle quelle.
+struct BatchStats {
+    size_t commands = 0;
+    size_t failures = 0;
+};
+
+class BatchSession {
+public:
+    // Réponse de chaque commande d'un bloc dont le commit a échoué
+    static constexpr std::string_view kStorageError = "ERR|STORAGE\n";
+
+    explicit BatchSession(ReservationEngine& engine) : engine(engine) {}
+
+    BatchStats run(std::FILE* in, std::FILE* out) {
+        std::vector<char> buffer(1 << 16);
+        size_t kept = 0;
+        while (true) {
+            const size_t n = std::fread(buffer.data() + kept, 1, buffer.size() - kept, in);
+            const size_t end = kept + n;
+            size_t begin = 0;
+            const size_t commandsBefore = stats.commands;
+            const size_t failuresBefore = stats.failures;
+            tick(nowSecs());
+            while (begin < end) {
+                const char* nl = static_cast<const char*>(std::memchr(&buffer[begin], '\n', end - begin));
+                if (!nl && n != 0) break; // Ligne incomplète : attend le bloc suivant
+                const size_t lineEnd = nl ? static_cast<size_t>(nl - buffer.data()) : end;
+                execute(std::string_view(&buffer[begin], lineEnd - begin));
+                begin = lineEnd + 1;
+            }
+            if (!engine.commit()) {
+                const size_t commands = stats.commands - commandsBefore;
+                reply.clear();
+                for (size_t i = 0; i < commands; ++i) reply += kStorageError;
+                stats.failures = failuresBefore + commands;
+            }
+            std::fwrite(reply.data(), 1, reply.size(), out);
+            reply.clear();
+            if (n == 0) break;
+            kept = begin < end ? end - begin : 0;
+            std::memmove(buffer.data(), buffer.data() + end - kept, kept);
+            if (kept == buffer.size()) buffer.resize(buffer.size() * 2);
+        }
+        std::fflush(out);
+        return stats;
+    }
+
+    // Avance l'horloge des commandes : les retenues échues sont rendues, et leurs places
+    // attribuées à la liste d'attente sont annoncées
+    void tick(int64_t nowSecs) {
+        now = nowSecs;
+        engine.expireHolds(now);
+        appendAllocations();
+    }
+
+    const BatchStats& statistics() const { return stats; }
+
+    // Exécute une commande et ajoute sa réponse à reply
+    void execute(std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line[0] == '#') return;
+        ++stats.commands;
+
+        const std::string_view command = split(line);
+        BookingStatus status = BookingStatus::Ok;
+        const size_t replyStart = reply.size();
+        reply += "OK";
+        numbers.clear();
+        int number;
+
+        if (command == "HOLD" || command == "BOOK") {
+            const int event = findEvent(split(line));
+            client.assign(split(line));
+            request.assign(line);
+            if (event < 0) {
+                status = BookingStatus::UnknownEvent;
+            } else if (command == "HOLD") {
+                status = engine.hold(static_cast<ReservationEngine::EventId>(event), client, request, now, &number);
+                if (status == BookingStatus::Ok) appendHold(number);
+            } else {
+                status = engine.book(static_cast<ReservationEngine::EventId>(event), client, request, &numbers);
+                if (status == BookingStatus::Ok) {
+                    appendNumbers();
+                    char separator = '|';
+                    for (int n : numbers) {
+                        reply += separator;
+                        reply += engine.reservationTable().findByNumber(n)->seatNumber;
+                        separator = ',';
+                    }
+                    appendTotal();
+                }
+            }
+        } else if (command == "CONFIRM" && parseNumber(line, number)) {
+            status = engine.confirm(number, now, &numbers);
+            if (status == BookingStatus::Ok) {
+                appendNumbers();
+                appendTotal();
+            }
+        } else if (command == "CANCEL" && parseNumber(line, number)) {
+            status = engine.cancel(number);
+        } else if (command == "FIND" && parseNumber(line, number)) {
+            if (const Reservation* r = engine.reservationTable().findByNumber(number)) {
+                reply += '|';
+                reply += std::to_string(r->reservationNumber);
+                for (const std::string* field : {&r->eventName, &r->clientName, &r->date, &r->seatNumber}) {
+                    reply += '|';
+                    reply += *field;
+                }
+                reply += '|';
+                reply += std::to_string(r->price);
+            } else {
+                status = BookingStatus::UnknownReservation;
+            }
+        } else if (command == "WAIT") {
+            const int event = findEvent(split(line));
+            client.assign(split(line));
+            const std::string_view seats = split(line);
+            int count, priority = 0;
+            if (!parseNumber(seats, count) || (!line.empty() && !parseSigned(line, priority))) {
+                status = BookingStatus::InvalidRequest;
+            } else if (event < 0) {
+                status = BookingStatus::UnknownEvent;
+            } else {
+                status = engine.joinWaitlist(static_cast<ReservationEngine::EventId>(event), client,
+                                             static_cast<uint32_t>(count), priority, &number);
+                if (status == BookingStatus::Ok) {
+                    reply += '|';
+                    reply += std::to_string(number);
+                }
+            }
+        } else if (command == "LEAVE" && parseNumber(line, number)) {
+            status = engine.leaveWaitlist(number);
+        } else if (command == "CLIENT") {
+            client.assign(line);
+            for (const Reservation* r : engine.reservationTable().findByClient(client)) {
+                numbers.push_back(r->reservationNumber);
+            }
+            std::sort(numbers.begin(), numbers.end());
+            appendNumbers();
+        } else if (command == "QUOTE") {
+            const int event = findEvent(line);
+            if (event < 0) {
+                status = BookingStatus::UnknownEvent;
+            } else {
+                const ReservationEngine::EventId e = static_cast<ReservationEngine::EventId>(event);
+                const SectionPricing& pricing = engine.eventTable().pricing(e);
+                char separator = '|';
+                for (uint32_t s = 0; s < pricing.sectionCount(); ++s) {
+                    reply += separator;
+                    const std::string& name = engine.eventTable().seats(e).sectionList()[s].name;
+                    if (!name.empty()) {
+                        reply += name;
+                        reply += ':';
+                    }
+                    reply += std::to_string(pricing.price(s));
+                    separator = ',';
+                }
+            }
+        } else if (command == "FREE") {
+            const int event = findEvent(line);
+            if (event < 0) {
+                status = BookingStatus::UnknownEvent;
+            } else {
+                reply += '|';
+                reply += std::to_string(engine.freeCount(static_cast<ReservationEngine::EventId>(event)));
+            }
+        } else {
+            reply.resize(replyStart);
+            reply += "ERR|BAD_COMMAND\n";
+            ++stats.failures;
+            return;
+        }
+
+        if (status != BookingStatus::Ok) {
+            reply.resize(replyStart);
+            reply += "ERR|";
+            reply += statusName(status);
+            ++stats.failures;
+        }
+        reply += '\n';
+        appendAllocations();
+    }
+
+    // Réponses pas encore écrites (pour un appelant qui utilise execute directement)
+    std::string& pendingReplies() { return reply; }
+
+private:
+    ReservationEngine& engine;
+    BatchStats stats;
+    int64_t now = nowSecs();
+    std::string reply;
+    std::string key;     // Tampons réutilisés d'une commande à l'autre
+    std::string client;
+    std::string request;
+    std::vector<int> numbers;
+
+    // Découpe line au premier '|' : renvoie le champ, line devient la suite
+    static std::string_view split(std::string_view& line) {
+        const size_t pos = line.find('|');
+        const std::string_view field = line.substr(0, pos);
+        line = pos == std::string_view::npos ? std::string_view() : line.substr(pos + 1);
+        return field;
+    }
+
+    static bool parseNumber(std::string_view text, int& value) {
+        if (text.empty() || text.size() > 9) return false;
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + (c - '0');
+        }
+        return true;
+    }
+
+    static bool parseSigned(std::string_view text, int& value) {
+        const bool negative = !text.empty() && text[0] == '-';
+        if (!parseNumber(negative ? text.substr(1) : text, value)) return false;
+        if (negative) value = -value;
+        return true;
+    }
+
+    int findEvent(std::string_view name) {
+        key.assign(name);
+        return engine.eventTable().find(key);
+    }
+
+    void appendNumbers() {
+        char separator = '|';
+        for (int n : numbers) {
+            reply += separator;
+            reply += std::to_string(n);
+            separator = ',';
+        }
+    }
+
+    // Somme des prix des réservations de numbers
+    void appendTotal() {
+        Cents total = 0;
+        for (int n : numbers) total += engine.reservationTable().findByNumber(n)->price;
+        reply += '|';
+        reply += std::to_string(total);
+    }
+
+    void appendAllocations() {
+        for (const ReservationEngine::WaitAllocation& a : engine.takeAllocations()) {
+            reply += "ALLOC|";
+            reply += std::to_string(a.waitNumber);
+            numbers = a.reservations;
+            appendNumbers();
+            char separator = '|';
+            for (int n : a.reservations) {
+                reply += separator;
+                reply += engine.reservationTable().findByNumber(n)->seatNumber;
+                separator = ',';
+            }
+            reply += '\n';
+        }
+    }
+
+    void appendHold(int number) {
+        const SeatHold* h = engine.holdTable().find(number);
+        const SeatMap& seats = engine.eventTable().seats(static_cast<ReservationEngine::EventId>(h->event));
+        reply += '|';
+        reply += std::to_string(number);
+        reply += '|';
+        reply += std::to_string(h->expiresAt);
+        char separator = '|';
+        for (const SeatId& s : h->seats) {
+            reply += separator;
+            reply += seats.label(s);
+            separator = ',';
+        }
+        Cents total = 0;
+        for (Cents price : h->prices) total += price;
+        reply += '|';
+        reply += std::to_string(total);
+    }
+};
+
+#endif // RESERVATION_BATCH_H
@@ -0,0 +1,530 @@
+#ifndef RESERVATION_ENGINE_H
+#define RESERVATION_ENGINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "event_table.h"
+#include "reservation_log.h"
+#include "reservation_table.h"
+#include "seat_holds.h"
+#include "seat_map.h"
+#include "waitlist.h"
+
+// Secondes depuis l'époque Unix : l'échéance d'une retenue survit à un redémarrage
+inline int64_t nowSecs() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+enum class BookingStatus {
+    Ok,
+    UnknownEvent,
+    SoldOut,            // Plus aucune place libre
+    NotEnoughSeats,     // Pas assez de places côte à côte
+    InvalidSeat,        // Place inexistante ou déjà prise
+    UnknownHold,        // Retenue inexistante ou expirée
+    UnknownReservation,
+    UnknownWait,        // Attente inexistante ou déjà servie
+    InvalidRequest,     // Nombre de places hors limites
+};
+
+inline const char* statusName(BookingStatus status) {
+    switch (status) {
+        case BookingStatus::Ok: return "OK";
+        case BookingStatus::UnknownEvent: return "UNKNOWN_EVENT";
+        case BookingStatus::SoldOut: return "SOLD_OUT";
+        case BookingStatus::NotEnoughSeats: return "NOT_ENOUGH_SEATS";
+        case BookingStatus::InvalidSeat: return "INVALID_SEAT";
+        case BookingStatus::UnknownHold: return "UNKNOWN_HOLD";
+        case BookingStatus::UnknownReservation: return "UNKNOWN_RESERVATION";
+        case BookingStatus::UnknownWait: return "UNKNOWN_WAIT";
+        case BookingStatus::InvalidRequest: return "INVALID_REQUEST";
+    }
+    return "?";
+}
+
+struct EngineConfig {
+    std::string eventsFile = "evenements.txt";
+    std::string dataFile = "reservations.log";
+    std::string legacyDataFile = "reservations.txt"; // Ancien format texte, converti au premier lancement
+    std::string layoutFile = "reservations.shards";  // Nombre de shards des journaux (vide : aucun)
+    int64_t holdSeconds = 10 * 60;                    // Durée d'une retenue avant confirmation
+    // Moteur découpé en shards (ReservationShards) : ce moteur ne gère que les événements de
+    // son shard, et ses numéros (réservations, retenues, attentes) sont ceux qui valent
+    // shardIndex + 1 modulo shardCount, pour qu'un numéro désigne son shard
+    uint32_t shardIndex = 0;
+    uint32_t shardCount = 1;
+};
+
+// Moteur de réservation, sans aucune entrée/sortie terminal : le menu interactif et le mode
+// batch n'en sont que des interfaces. Les erreurs prévisibles (place prise, retenue expirée...)
+// sont des BookingStatus, pas des exceptions.
+//
+// Une place libérée (annulation, retenue expirée) est aussitôt attribuée à la liste d'attente
+// de l'événement ; takeAllocations() rend ces attributions à l'interface qui les annonce.
+//
+// Chaque place prise ou rendue met à jour le prix de sa section (SectionPricing). Une place
+// est payée au prix affiché quand elle est prise : une retenue garde ses prix jusqu'à confirm().
+//
+// Chaque opération prépare ses enregistrements dans le journal ; commit() les rend durables,
+// en une seule synchronisation pour toutes les opérations depuis le commit précédent.
+// Un appelant ne doit annoncer un résultat qu'après le commit. Un commit qui échoue annule
+// toutes ces opérations : le moteur revient à l'état du journal sur disque.
+class ReservationEngine {
+public:
+    using EventId = EventTable::EventId;
+
+    // Places attribuées à une attente : une réservation par place
+    struct WaitAllocation {
+        int waitNumber = 0;
+        EventId event = 0;
+        std::string client;
+        std::vector<int> reservations;
+    };
+
+    explicit ReservationEngine(const EngineConfig& config = EngineConfig(), int64_t now = nowSecs())
+        : config(config), holds(now), journal(config.dataFile) {
+        open(now);
+        commit();
+    }
+
+    ~ReservationEngine() {
+        commit();
+    }
+
+    ReservationEngine(const ReservationEngine&) = delete;
+    ReservationEngine& operator=(const ReservationEngine&) = delete;
+
+    const EventTable& eventTable() const { return events; }
+    const ReservationTable& reservationTable() const { return reservations; }
+    const SeatHolds& holdTable() const { return holds; }
+    const Waitlist& waitTable() const { return waitlist; }
+    bool catalogueLoaded() const { return catalogueFound; }
+    const std::vector<size_t>& catalogueLineErrors() const { return catalogueErrors; }
+    uint32_t freeCount(EventId event) const { return freeSeats[event]; }
+
+    // request : une étiquette ("A1", "Nord B12") ou un nombre de places côte à côte ("3").
+    // Les places sont retirées du plan de salle jusqu'à confirm() ou l'échéance.
+    BookingStatus hold(EventId event, const std::string& client, const std::string& request, int64_t now,
+                       int* holdNumber = nullptr) {
+        clock = std::max(clock, now);
+        std::vector<SeatId> seats;
+        std::vector<Cents> prices;
+        const BookingStatus status = claimSeats(event, request, seats, prices);
+        if (status != BookingStatus::Ok) return status;
+        const SeatHold& h = holds.place(event, client, seats, prices, now + config.holdSeconds, takeNumber(nextHold));
+        journal.add(holdRecord(h));
+        if (holdNumber) *holdNumber = h.number;
+        return BookingStatus::Ok;
+    }
+
+    // Transforme une retenue en réservations, une par place ; numbers reçoit leurs numéros
+    BookingStatus confirm(int holdNumber, int64_t now, std::vector<int>* numbers = nullptr) {
+        expireHolds(now);
+        SeatHold h;
+        if (!holds.take(holdNumber, h)) return BookingStatus::UnknownHold;
+        reserve(static_cast<EventId>(h.event), h.client, h.seats, h.prices, numbers);
+        // Les réservations avant la fin de retenue : après un crash entre les deux, la retenue
+        // relue ne peut plus reprendre ses places
+        journal.add(endRecord(ReservationLog::HoldEnd, h.number));
+        return BookingStatus::Ok;
+    }
+
+    // Réservation immédiate, sans retenue
+    BookingStatus book(EventId event, const std::string& client, const std::string& request,
+                       std::vector<int>* numbers = nullptr) {
+        std::vector<SeatId> seats;
+        std::vector<Cents> prices;
+        const BookingStatus status = claimSeats(event, request, seats, prices);
+        if (status == BookingStatus::Ok) reserve(event, client, seats, prices, numbers);
+        return status;
+    }
+
+    // La place annulée redevient disponible, ou passe à la liste d'attente
+    BookingStatus cancel(int number, Reservation* cancelled = nullptr) {
+        Reservation r;
+        if (!reservations.cancel(number, &r)) return BookingStatus::UnknownReservation;
+        journal.add(endRecord(ReservationLog::Cancel, number));
+        SeatId seat;
+        const int e = events.find(r.eventName);
+        if (e >= 0 && events.seats(e).parseLabel(r.seatNumber, seat)) {
+            releaseSeat(static_cast<EventId>(e), seat);
+            reallocate(static_cast<EventId>(e));
+        }
+        if (cancelled) *cancelled = std::move(r);
+        return BookingStatus::Ok;
+    }
+
+    // Rend au plan de salle (ou à la liste d'attente) les places des retenues arrivées à échéance
+    void expireHolds(int64_t now) {
+        clock = std::max(clock, now);
+        holds.expire(now, [&](const SeatHold& h) {
+            const EventId e = static_cast<EventId>(h.event);
+            for (const SeatId& s : h.seats) releaseSeat(e, s);
+            journal.add(endRecord(ReservationLog::HoldEnd, h.number));
+            reallocate(e);
+        });
+    }
+
+    // Attente de seats places côte à côte ; priorité plus forte servie d'abord, puis par ordre
+    // d'inscription. Servie tout de suite si les places sont là.
+    BookingStatus joinWaitlist(EventId event, const std::string& client, uint32_t seats, int priority,
+                               int* waitNumber = nullptr) {
+        if (event >= events.size()) return BookingStatus::UnknownEvent;
+        if (seats == 0 || seats > Waitlist::kMaxSeats) return BookingStatus::InvalidRequest;
+        const Waitlist::Entry& w = waitlist.add(event, client, seats, priority, takeNumber(nextWait));
+        journal.add(waitRecord(w));
+        if (waitNumber) *waitNumber = w.number;
+        reallocate(event);
+        return BookingStatus::Ok;
+    }
+
+    BookingStatus leaveWaitlist(int waitNumber) {
+        if (!waitlist.remove(waitNumber)) return BookingStatus::UnknownWait;
+        journal.add(endRecord(ReservationLog::WaitEnd, waitNumber));
+        return BookingStatus::Ok;
+    }
+
+    // Attributions faites depuis l'appel précédent
+    std::vector<WaitAllocation> takeAllocations() {
+        std::vector<WaitAllocation> result;
+        result.swap(allocations);
+        return result;
+    }
+
+    // Rend durables les opérations en attente. Si l'écriture échoue, elles sont toutes annulées
+    // (réservations, retenues, attentes, attributions, numéros donnés) et false est renvoyé :
+    // l'appelant les annonce comme refusées, et les redemander ne fait pas de double.
+    bool commit() {
+        if (!journal.commit()) {
+            rollback();
+            return false;
+        }
+        if (!layoutRecorded && journal.records() > 0) recordLayout();
+        compactIfNeeded();
+        return true;
+    }
+
+private:
+    EngineConfig config;
+    EventTable events;
+    ReservationTable reservations;
+    SeatHolds holds;
+    Waitlist waitlist;
+    std::vector<WaitAllocation> allocations;
+    ReservationLog journal;
+    // Numéros des retenues et des attentes ; ceux des réservations viennent de la table
+    int nextHold = 1;
+    int nextWait = 1;
+    int64_t clock = 0; // Heure la plus récente reçue, pour relire les retenues après une annulation
+    bool layoutRecorded = false;
+    bool catalogueFound = false;
+    std::vector<size_t> catalogueErrors;
+    // Par événement : places libres, et rang où commencer à chercher des places côte à côte
+    // (les rangs d'avant sont pleins, sauf annulation). Le moteur est seul à modifier les plans
+    // de salle après le chargement : ces colonnes restent exactes sans recompter les bits.
+    std::vector<uint32_t> freeSeats;
+    std::vector<uint32_t> searchRow;
+
+    // Prend les places demandées ; prices reçoit le prix de chacune, au palier d'avant la vente
+    BookingStatus claimSeats(EventId event, const std::string& request, std::vector<SeatId>& out,
+                             std::vector<Cents>& prices) {
+        if (event >= events.size()) return BookingStatus::UnknownEvent;
+        SeatMap& seats = events.seats(event);
+        SeatId seat;
+        if (!request.empty() && request.size() <= 4 && request.find_first_not_of("0123456789") == std::string::npos) {
+            return claimAdjacent(event, static_cast<uint32_t>(std::stoul(request)), out, prices);
+        }
+        if (!seats.parseLabel(request, seat) || !seats.claim(seat)) return BookingStatus::InvalidSeat;
+        --freeSeats[event];
+        out.push_back(seat);
+        prices.push_back(events.pricing(event).taken(seat.section, 1));
+        return BookingStatus::Ok;
+    }
+
+    BookingStatus claimAdjacent(EventId event, uint32_t count, std::vector<SeatId>& out, std::vector<Cents>& prices) {
+        SeatMap& seats = events.seats(event);
+        SeatId seat;
+        if (count == 0) return BookingStatus::InvalidRequest; // Comme WAIT 0, quelles que soient les places
+        if (freeSeats[event] == 0) return BookingStatus::SoldOut;
+        if (count > freeSeats[event] || !seats.claimAdjacent(count, seat, -1, searchRow[event])) {
+            return BookingStatus::NotEnoughSeats;
+        }
+        searchRow[event] = seats.sectionList()[seat.section].firstRow + seat.row;
+        freeSeats[event] -= count;
+        for (uint32_t i = 0; i < count; ++i) out.push_back(SeatId{seat.section, seat.row, seat.number + i});
+        prices.insert(prices.end(), count, events.pricing(event).taken(seat.section, count));
+        return BookingStatus::Ok;
+    }
+
+    // Sert les attentes de l'événement tant que des places libres le permettent
+    void reallocate(EventId event) {
+        if (!waitlist.hasWaiting(event)) return;
+        std::vector<SeatId> seats;
+        std::vector<Cents> prices;
+        waitlist.allocate(event, [&] { return freeSeats[event]; }, [&](const Waitlist::Entry& w) {
+            seats.clear();
+            prices.clear();
+            if (claimAdjacent(event, w.seats, seats, prices) != BookingStatus::Ok) return false;
+            WaitAllocation a;
+            a.waitNumber = w.number;
+            a.event = event;
+            a.client = w.client;
+            reserve(event, w.client, seats, prices, &a.reservations);
+            journal.add(endRecord(ReservationLog::WaitEnd, w.number));
+            allocations.push_back(std::move(a));
+            return true;
+        });
+    }
+
+    void releaseSeat(EventId event, const SeatId& seat) {
+        if (!events.seats(event).release(seat)) return;
+        events.pricing(event).released(seat.section, 1);
+        ++freeSeats[event];
+        searchRow[event] = std::min(searchRow[event], events.seats(event).sectionList()[seat.section].firstRow + seat.row);
+    }
+
+    void reserve(EventId event, const std::string& client, const std::vector<SeatId>& seats,
+                 const std::vector<Cents>& prices, std::vector<int>* numbers) {
+        const std::string date = formatDate(events.day(event));
+        for (size_t i = 0; i < seats.size(); ++i) {
+            const Reservation& r = reservations.add(reservations.nextNumber(), events.name(event), client, date,
+                                                    events.seats(event).label(seats[i]), prices[i]);
+            journal.add(reservationRecord(r));
+            if (numbers) numbers->push_back(r.reservationNumber);
+        }
+    }
+
+    static ReservationLog::Record reservationRecord(const Reservation& r) {
+        ReservationLog::Record rec;
+        rec.type = ReservationLog::Reserve;
+        rec.number = r.reservationNumber;
+        rec.event = r.eventName;
+        rec.client = r.clientName;
+        rec.date = r.date;
+        rec.seats.push_back(r.seatNumber);
+        rec.prices.push_back(r.price);
+        return rec;
+    }
+
+    ReservationLog::Record holdRecord(const SeatHold& h) const {
+        const EventId e = static_cast<EventId>(h.event);
+        ReservationLog::Record rec;
+        rec.type = ReservationLog::Hold;
+        rec.number = h.number;
+        rec.event = events.name(e);
+        rec.client = h.client;
+        rec.expiresAt = h.expiresAt;
+        for (const SeatId& s : h.seats) rec.seats.push_back(events.seats(e).label(s));
+        rec.prices = h.prices;
+        return rec;
+    }
+
+    ReservationLog::Record waitRecord(const Waitlist::Entry& w) const {
+        ReservationLog::Record rec;
+        rec.type = ReservationLog::Wait;
+        rec.number = w.number;
+        rec.event = events.name(w.event);
+        rec.client = w.client;
+        rec.seatCount = w.seats;
+        rec.priority = w.priority;
+        return rec;
+    }
+
+    static ReservationLog::Record endRecord(ReservationLog::Type type, int number) {
+        ReservationLog::Record rec;
+        rec.type = type;
+        rec.number = number;
+        return rec;
+    }
+
+    // Réécrit le journal quand les enregistrements morts (annulations, retenues terminées)
+    // y sont plus nombreux que les vivants
+    void compactIfNeeded() {
+        const size_t live = reservations.size() + holds.size() + waitlist.size();
+        if (journal.records() > 1024 && journal.records() > 2 * live) compactLog();
+    }
+
+    bool compactLog() {
+        return journal.compact([this](auto emit) {
+            reservations.forEach([&](const Reservation& r) { emit(reservationRecord(r)); });
+            holds.forEach([&](const SeatHold& h) { emit(holdRecord(h)); });
+            waitlist.forEach([&](const Waitlist::Entry& w) { emit(waitRecord(w)); });
+        });
+    }
+
+    // Manifeste des journaux, écrit une fois qu'ils contiennent des données durables : un
+    // dossier où rien n'a été écrit peut encore être ouvert avec un autre nombre de shards.
+    // Chaque shard l'écrit à part puis le renomme, le contenu est le même pour tous.
+    void recordLayout() {
+        std::error_code ec;
+        layoutRecorded = true;
+        if (config.layoutFile.empty() || std::filesystem::exists(config.layoutFile, ec)) return;
+        const std::string tmpPath = config.layoutFile + "." + std::to_string(config.shardIndex) + ".tmp";
+        const bool written = static_cast<bool>(std::ofstream(tmpPath) << config.shardCount << '\n');
+        if (written) std::filesystem::rename(tmpPath, config.layoutFile, ec);
+        if (!written || ec) {
+            std::filesystem::remove(tmpPath, ec);
+            layoutRecorded = false; // Réessayé au prochain commit
+        }
+    }
+
+    // Catalogue, puis état relu du journal
+    void open(int64_t now) {
+        clock = now;
+        reservations.setNumbering(static_cast<int>(config.shardIndex) + 1, static_cast<int>(config.shardCount));
+        catalogueFound = events.loadCatalogue(config.eventsFile, &catalogueErrors, config.shardIndex, config.shardCount);
+        load(now);
+        for (EventId e = 0; e < events.size(); ++e) {
+            freeSeats.push_back(static_cast<uint32_t>(events.seats(e).freeCount()));
+            searchRow.push_back(0);
+        }
+        // Places libérées juste avant un arrêt : les attentes relues les reçoivent maintenant
+        for (EventId e = 0; e < events.size(); ++e) reallocate(e);
+    }
+
+    // Commit échoué : les enregistrements préparés sont abandonnés et tout l'état est relu du
+    // journal, revenu à sa dernière fin durable. Défaire les opérations une à une demanderait
+    // l'inverse de chacune (prix, attributions en cascade) ; la relecture est exacte par
+    // construction, et ne coûte qu'en cas de panne du disque.
+    void rollback() {
+        journal.discard();
+        events = EventTable();
+        reservations.clear();
+        holds = SeatHolds(clock);
+        waitlist = Waitlist();
+        allocations.clear();
+        catalogueErrors.clear();
+        freeSeats.clear();
+        searchRow.clear();
+        open(clock);
+    }
+
+    // Prochain numéro de la suite (retenues ou attentes) de ce shard
+    int takeNumber(int& next) {
+        const int number = next;
+        next += static_cast<int>(config.shardCount);
+        return number;
+    }
+
+    // Premier numéro de ce shard après number
+    int firstNumberAfter(int number) const {
+        const int count = static_cast<int>(config.shardCount);
+        const int next = number + 1;
+        return next + ((static_cast<int>(config.shardIndex) - (next - 1) % count) % count + count) % count;
+    }
+
+    // Rejoue le journal, puis reprend dans les plans de salle les places réservées et retenues
+    void load(int64_t now) {
+        std::unordered_map<int, ReservationLog::Record> liveHolds;
+        std::unordered_map<int, ReservationLog::Record> liveWaits;
+        // Plus grands numéros vus, terminés compris : un numéro n'est jamais redonné. Pour les
+        // réservations, c'est la table qui s'en charge à chaque ajout relu.
+        int lastHold = 0, lastWait = 0;
+        journal.load([&](const ReservationLog::Record& r) {
+            if (r.type == ReservationLog::Hold || r.type == ReservationLog::HoldEnd) {
+                lastHold = std::max(lastHold, r.number);
+            } else if (r.type == ReservationLog::Wait || r.type == ReservationLog::WaitEnd) {
+                lastWait = std::max(lastWait, r.number);
+            }
+            switch (r.type) {
+                case ReservationLog::Reserve:
+                    reservations.add(r.number, r.event, r.client, r.date, r.seats[0], r.prices[0]);
+                    break;
+                case ReservationLog::Cancel:
+                    reservations.cancel(r.number);
+                    break;
+                case ReservationLog::Hold:
+                    liveHolds[r.number] = r;
+                    break;
+                case ReservationLog::HoldEnd:
+                    liveHolds.erase(r.number);
+                    break;
+                case ReservationLog::Wait:
+                    liveWaits[r.number] = r;
+                    break;
+                case ReservationLog::WaitEnd:
+                    liveWaits.erase(r.number);
+                    break;
+            }
+        });
+        const bool converted = journal.records() == 0 && loadLegacyFile();
+        for (const auto& entry : liveHolds) lastHold = std::max(lastHold, entry.first);
+        nextHold = firstNumberAfter(lastHold);
+        nextWait = firstNumberAfter(lastWait);
+
+        SeatId seat;
+        reservations.forEach([&](const Reservation& r) {
+            const int e = events.find(r.eventName);
+            if (e >= 0 && events.seats(e).parseLabel(r.seatNumber, seat) && events.seats(e).claim(seat)) {
+                events.pricing(e).taken(seat.section, 1);
+            }
+        });
+        for (const auto& entry : liveHolds) restoreHold(entry.second, now);
+        for (const auto& entry : liveWaits) {
+            const ReservationLog::Record& w = entry.second;
+            const int e = events.find(w.event);
+            if (e >= 0 && w.seatCount >= 1 && w.seatCount <= Waitlist::kMaxSeats) {
+                waitlist.add(static_cast<uint32_t>(e), w.client, w.seatCount, w.priority, w.number);
+            }
+        }
+
+        if (converted) {
+            if (compactLog()) std::remove(config.legacyDataFile.c_str());
+        } else {
+            compactIfNeeded();
+        }
+    }
+
+    // Une retenue échue pendant l'arrêt est abandonnée ; sinon ses places sont reprises
+    void restoreHold(const ReservationLog::Record& r, int64_t now) {
+        const int e = events.find(r.event);
+        if (e < 0 || r.expiresAt <= now) return;
+
+        std::vector<SeatId> seats;
+        std::vector<Cents> prices;
+        SeatId seat;
+        for (size_t i = 0; i < r.seats.size(); ++i) {
+            if (events.seats(e).parseLabel(r.seats[i], seat) && events.seats(e).claim(seat)) {
+                // La place compte pour le palier de sa section ; la retenue garde son prix
+                events.pricing(e).taken(seat.section, 1);
+                seats.push_back(seat);
+                prices.push_back(r.prices[i]);
+            }
+        }
+        if (!seats.empty()) {
+            holds.place(static_cast<size_t>(e), r.client, seats, prices, r.expiresAt, r.number);
+        }
+    }
+
+    // Fichier texte des versions précédentes : numéro|événement|client|date|place par ligne
+    bool loadLegacyFile() {
+        std::ifstream in(config.legacyDataFile);
+        if (!in) return false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            std::stringstream ss(line);
+            std::string token;
+            std::vector<std::string> parts;
+            while (std::getline(ss, token, '|')) {
+                parts.push_back(token);
+            }
+            if (parts.size() == 5) {
+                reservations.add(std::stoi(parts[0]), parts[1], parts[2], parts[3], parts[4]);
+            }
+        }
+        return true;
+    }
+};
+
+#endif // RESERVATION_ENGINE_H
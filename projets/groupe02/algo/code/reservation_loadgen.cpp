@@ -0,0 +1,395 @@
+// Générateur de charge du moteur de réservation : rejoue une ouverture de billetterie
+// synthétique et mesure débit, latences et allocations mémoire.
+//
+//   reservation_loadgen [--events N] [--ops N] [--zipf s] [--seed N] [--shards N] [--json fichier|-]
+//
+// Le trafic : popularité des événements selon une loi de Zipf (quelques têtes d'affiche
+// concentrent la demande), demandes de places côte à côte ou d'une place précise vers l'avant
+// de la salle, retenues dont une partie est abandonnée jusqu'à l'échéance, confirmations,
+// réservations directes, annulations et inscriptions en liste d'attente sur les complets.
+// L'horloge est simulée : 1 000 opérations par seconde, retenues de 2 minutes.
+//
+// Les opérations sont rendues durables par groupes de 256, comme en mode batch. Le code de
+// retour est 1 si une place est perdue ou comptée deux fois à la fin.
+//
+// --shards N mesure la montée en charge du moteur découpé (ReservationShards) : le même flot
+// de commandes batch est rejoué avec 1, 2, 4... puis N shards, et le débit de chaque passe est
+// comparé à celui d'un seul shard.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "reservation_engine.h"
+#include "reservation_shards.h"
+
+// Compteur d'allocations : toute allocation du programme passe par ces opérateurs.
+// GCC prend à tort le free() d'un bloc obtenu par cet operator new pour une erreur.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+enum Operation { Hold, Confirm, Book, Cancel, Wait, Commit, OperationCount };
+const char* const kOperationNames[OperationCount] = {"hold", "confirm", "book", "cancel", "wait", "commit"};
+
+struct Options {
+    uint32_t events = 200;
+    size_t ops = 500000;
+    double zipf = 1.1;
+    uint32_t seed = 42;
+    unsigned shards = 0;   // > 0 : mesure de montée en charge de 1 à shards shards
+    std::string json;      // Vide : pas de résultats JSON ; "-" : sur la sortie standard
+};
+
+// Tirage d'un rang selon Zipf : fonction de répartition précalculée, recherche dichotomique
+class ZipfDistribution {
+public:
+    ZipfDistribution(uint32_t n, double s) : cdf(n) {
+        double sum = 0;
+        for (uint32_t k = 0; k < n; ++k) cdf[k] = sum += 1.0 / std::pow(k + 1.0, s);
+        for (double& c : cdf) c /= sum;
+    }
+
+    template <typename Rng>
+    uint32_t operator()(Rng& rng) {
+        const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        const auto it = std::lower_bound(cdf.begin(), cdf.end(), u);
+        return static_cast<uint32_t>(std::min<size_t>(it - cdf.begin(), cdf.size() - 1));
+    }
+
+private:
+    std::vector<double> cdf;
+};
+
+struct Latencies {
+    std::vector<uint32_t> ns[OperationCount];
+
+    double percentile(Operation op, double p) const {
+        const std::vector<uint32_t>& v = ns[op];
+        return v.empty() ? 0.0 : v[static_cast<size_t>(p * (v.size() - 1))] / 1000.0;
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--events") options.events = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--ops") options.ops = std::strtoull(value, nullptr, 10);
+        else if (arg == "--zipf") options.zipf = std::strtod(value, nullptr);
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--shards") options.shards = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--json") options.json = value;
+        else return false;
+    }
+    return options.events > 0 && options.ops > 0;
+}
+
+// Demande d'un client : surtout des groupes de 1 à 4 places, parfois une place précise,
+// choisie de préférence dans les premiers rangs
+template <typename Rng>
+std::string seatRequest(const SeatMap& seats, Rng& rng) {
+    if (rng() % 4 != 0) {
+        static const char* const counts[] = {"1", "2", "2", "2", "3", "4", "4", "1"};
+        return counts[rng() % 8];
+    }
+    const std::vector<SeatMap::Section>& sections = seats.sectionList();
+    const uint32_t section = static_cast<uint32_t>(rng() % sections.size());
+    const uint32_t rows = sections[section].rowCount;
+    const uint32_t row = std::min<uint32_t>(rows - 1, static_cast<uint32_t>(std::geometric_distribution<>(0.2)(rng)));
+    return seats.label(SeatId{section, row, static_cast<uint32_t>(rng() % 40)});
+}
+
+// Chaque place est soit réservée, soit retenue, soit libre, une seule fois
+bool engineConsistent(const ReservationEngine& engine) {
+    size_t capacity = 0, free = 0, held = 0;
+    bool consistent = true;
+    for (ReservationEngine::EventId e = 0; e < engine.eventTable().size(); ++e) {
+        capacity += engine.eventTable().seats(e).capacity();
+        free += engine.freeCount(e);
+        consistent = consistent && engine.freeCount(e) == engine.eventTable().seats(e).freeCount();
+    }
+    engine.holdTable().forEach([&](const SeatHold& h) { held += h.seats.size(); });
+    return consistent && engine.reservationTable().size() + held + free == capacity;
+}
+
+// Catalogue et journaux dans un dossier temporaire neuf, à supprimer après la mesure
+std::filesystem::path makeWorkspace(const Options& options, const std::string& tag, EngineConfig& config) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / ("loadgen-" + tag + "-" + std::to_string(std::time(nullptr)));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    config.eventsFile = (dir / "evenements.txt").string();
+    config.dataFile = (dir / "reservations.log").string();
+    config.legacyDataFile = (dir / "reservations.txt").string();
+    config.layoutFile = (dir / "reservations.shards").string();
+    config.holdSeconds = 120;
+    std::ofstream catalogue(config.eventsFile);
+    for (uint32_t e = 0; e < options.events; ++e) {
+        catalogue << "Evenement " << e << '|' << formatDate(dayNumber(1, 1, 2030) + int(e % 365))
+                  << "|Salle " << e % 20 << "|Parterre=30x40,Balcon=10x40\n";
+    }
+    return dir;
+}
+
+// Flot de commandes batch : surtout des achats et des retenues, des devis, quelques
+// annulations au hasard et de rares recherches par client (posées à tous les shards)
+std::vector<std::string> scalingCommands(const Options& options) {
+    std::mt19937 rng(options.seed);
+    ZipfDistribution popularity(options.events, options.zipf);
+    std::vector<std::string> blocks(1);
+    SeatMap hall;
+    hall.addSection("Parterre", 30, 40);
+    hall.addSection("Balcon", 10, 40);
+    for (size_t i = 0; i < options.ops; ++i) {
+        const std::string event = "Evenement " + std::to_string(popularity(rng));
+        const std::string client = "Client " + std::to_string(rng() % 100000);
+        const uint32_t roll = static_cast<uint32_t>(rng() % 100);
+        std::string& block = blocks.back();
+        if (roll < 55) {
+            block += "BOOK|" + event + '|' + client + '|' + seatRequest(hall, rng) + '\n';
+        } else if (roll < 75) {
+            block += "HOLD|" + event + '|' + client + '|' + seatRequest(hall, rng) + '\n';
+        } else if (roll < 90) {
+            block += "QUOTE|" + event + '\n';
+        } else if (roll < 99) {
+            block += "CANCEL|" + std::to_string(1 + rng() % (i + 1)) + '\n';
+        } else {
+            block += "CLIENT|" + client + '\n';
+        }
+        if (block.size() >= (1 << 16)) blocks.emplace_back();
+    }
+    return blocks;
+}
+
+int runScaling(const Options& options) {
+    const std::vector<std::string> blocks = scalingCommands(options);
+    std::vector<unsigned> counts;
+    for (unsigned k = 1; k < options.shards; k *= 2) counts.push_back(k);
+    counts.push_back(options.shards);
+
+    std::printf("%zu commandes, %u événements, Zipf %.2f, %u cœurs\n", options.ops, options.events, options.zipf,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %14s %10s %10s\n", "shards", "commandes/s", "refusées", "accél.");
+    std::string json = "{\"events\": " + std::to_string(options.events) + ", \"ops\": " + std::to_string(options.ops)
+                     + ", \"zipf\": " + std::to_string(options.zipf) + ", \"scaling\": [";
+    double base = 0;
+    bool consistent = true;
+    for (unsigned count : counts) {
+        EngineConfig config;
+        const std::filesystem::path dir = makeWorkspace(options, "shards" + std::to_string(count), config);
+        double throughput;
+        BatchStats stats;
+        {
+            ReservationShards shards(config, count);
+            ShardedBatchSession session(shards);
+            std::string replies;
+            const auto start = std::chrono::steady_clock::now();
+            for (const std::string& block : blocks) {
+                session.execute(block, replies);
+                replies.clear();
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            stats = session.statistics();
+            throughput = stats.commands / seconds;
+            // Dans chaque shard, chaque place est réservée, retenue ou libre, une seule fois
+            std::vector<char> valid(count, 0);
+            for (unsigned k = 0; k < count; ++k) {
+                shards.post(k, [&ok = valid[k]](ReservationEngine& engine) { ok = engineConsistent(engine); });
+            }
+            shards.wait();
+            for (char ok : valid) consistent = consistent && ok;
+        }
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+        if (base == 0) base = throughput;
+        std::printf("%8u %14.0f %10zu %9.2fx\n", count, throughput, stats.failures, throughput / base);
+        json += std::string(count == counts.front() ? "" : ", ") + "{\"shards\": " + std::to_string(count)
+              + ", \"throughput\": " + std::to_string(throughput) + ", \"speedup\": "
+              + std::to_string(throughput / base) + "}";
+    }
+    json += std::string("], \"consistent\": ") + (consistent ? "true" : "false") + "}\n";
+    std::printf("%s\n", consistent ? "aucune place perdue ni comptée deux fois"
+                                   : "ERREUR : places réservées + retenues + libres != capacité");
+
+    if (!options.json.empty()) {
+        std::FILE* out = options.json == "-" ? stdout : std::fopen(options.json.c_str(), "w");
+        if (!out) {
+            std::cerr << "Impossible d'écrire " << options.json << std::endl;
+            return 1;
+        }
+        std::fputs(json.c_str(), out);
+        if (out != stdout) std::fclose(out);
+    }
+    return consistent ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage : " << argv[0]
+                  << " [--events N] [--ops N] [--zipf s] [--seed N] [--shards N] [--json fichier|-]" << std::endl;
+        return 2;
+    }
+    if (options.shards > 0) return runScaling(options);
+
+    namespace fs = std::filesystem;
+    EngineConfig config;
+    const fs::path dir = makeWorkspace(options, "engine", config);
+
+    int exitCode = 0;
+    {
+        int64_t now = 1000000;
+        ReservationEngine engine(config, now);
+        std::mt19937 rng(options.seed);
+        ZipfDistribution popularity(options.events, options.zipf);
+        Latencies latencies;
+        size_t statusCounts[static_cast<size_t>(BookingStatus::InvalidRequest) + 1] = {};
+        std::vector<int> pendingHolds;
+        std::vector<int> sold;
+        std::vector<int> numbers;
+        std::string client;
+        size_t seatsBooked = 0;
+
+        auto timed = [&](Operation op, auto body) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const BookingStatus status = body();
+            const auto t1 = std::chrono::steady_clock::now();
+            latencies.ns[op].push_back(static_cast<uint32_t>(
+                std::min<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(), UINT32_MAX)));
+            ++statusCounts[static_cast<size_t>(status)];
+            return status;
+        };
+        auto takeSold = [&](std::vector<int>& from) {
+            seatsBooked += from.size();
+            sold.insert(sold.end(), from.begin(), from.end());
+            from.clear();
+        };
+
+        // Les tableaux du générateur sont alloués d'avance : les allocations mesurées sont celles du moteur
+        for (std::vector<uint32_t>& v : latencies.ns) v.reserve(options.ops);
+        pendingHolds.reserve(options.ops);
+        sold.reserve(options.ops * 4);
+        numbers.reserve(64);
+
+        const size_t allocationsBefore = allocationCount.load();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < options.ops; ++i) {
+            if (i % 1000 == 0) engine.expireHolds(++now);
+            const ReservationEngine::EventId event = popularity(rng);
+            client = "Client " + std::to_string(rng() % 100000);
+            const uint32_t roll = static_cast<uint32_t>(rng() % 100);
+
+            if (roll < 30 && !pendingHolds.empty()) {
+                const size_t pick = rng() % pendingHolds.size();
+                const int hold = pendingHolds[pick];
+                pendingHolds[pick] = pendingHolds.back();
+                pendingHolds.pop_back();
+                timed(Confirm, [&] { return engine.confirm(hold, now, &numbers); });
+                takeSold(numbers);
+            } else if (roll < 40 && !sold.empty()) {
+                const size_t pick = rng() % sold.size();
+                const int number = sold[pick];
+                sold[pick] = sold.back();
+                sold.pop_back();
+                timed(Cancel, [&] { return engine.cancel(number); });
+            } else {
+                const std::string request = seatRequest(engine.eventTable().seats(event), rng);
+                BookingStatus status;
+                if (roll < 55) {
+                    status = timed(Book, [&] { return engine.book(event, client, request, &numbers); });
+                    takeSold(numbers);
+                } else {
+                    int hold = 0;
+                    status = timed(Hold, [&] { return engine.hold(event, client, request, now, &hold); });
+                    if (status == BookingStatus::Ok) pendingHolds.push_back(hold);
+                }
+                // Complet : un acheteur sur cinq s'inscrit sur la liste d'attente
+                if ((status == BookingStatus::SoldOut || status == BookingStatus::NotEnoughSeats) && rng() % 5 == 0) {
+                    const uint32_t count = static_cast<uint32_t>(std::stoul(request));
+                    timed(Wait, [&] { return engine.joinWaitlist(event, client, count, static_cast<int>(rng() % 4)); });
+                }
+            }
+            for (ReservationEngine::WaitAllocation& a : engine.takeAllocations()) takeSold(a.reservations);
+            if (i % 256 == 255) timed(Commit, [&] { return engine.commit() ? BookingStatus::Ok : BookingStatus::InvalidRequest; });
+        }
+        engine.commit();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const size_t allocations = allocationCount.load() - allocationsBefore;
+
+        const bool consistent = sold.size() == engine.reservationTable().size() && engineConsistent(engine);
+        exitCode = consistent ? 0 : 1;
+
+        for (std::vector<uint32_t>& v : latencies.ns) std::sort(v.begin(), v.end());
+        const double throughput = options.ops / seconds;
+        const double allocationsPerBooking = seatsBooked ? double(allocations) / seatsBooked : 0.0;
+
+        std::printf("%zu opérations en %.0f ms : %.0f opérations/s, %zu places réservées, %.1f allocations par place\n",
+                    options.ops, seconds * 1000, throughput, seatsBooked, allocationsPerBooking);
+        std::printf("%-8s %10s %10s %10s %10s\n", "", "nombre", "p50 us", "p99 us", "p999 us");
+        for (int op = 0; op < OperationCount; ++op) {
+            const Operation o = static_cast<Operation>(op);
+            std::printf("%-8s %10zu %10.2f %10.2f %10.2f\n", kOperationNames[op], latencies.ns[op].size(),
+                        latencies.percentile(o, 0.5), latencies.percentile(o, 0.99), latencies.percentile(o, 0.999));
+        }
+        std::printf("statuts :");
+        for (size_t s = 0; s < std::size(statusCounts); ++s) {
+            if (statusCounts[s]) std::printf(" %s=%zu", statusName(static_cast<BookingStatus>(s)), statusCounts[s]);
+        }
+        std::printf("\n%s\n", consistent ? "aucune place perdue ni comptée deux fois"
+                                         : "ERREUR : places réservées + retenues + libres != capacité");
+
+        if (!options.json.empty()) {
+            std::FILE* out = options.json == "-" ? stdout : std::fopen(options.json.c_str(), "w");
+            if (!out) {
+                std::cerr << "Impossible d'écrire " << options.json << std::endl;
+                exitCode = 1;
+            } else {
+                std::fprintf(out, "{\"events\": %u, \"ops\": %zu, \"zipf\": %.3f, \"seed\": %u, \"seconds\": %.6f, "
+                             "\"throughput\": %.1f, \"seats_booked\": %zu, \"allocations\": %zu, "
+                             "\"allocations_per_booking\": %.3f, \"consistent\": %s, \"latency_us\": {",
+                             options.events, options.ops, options.zipf, options.seed, seconds, throughput, seatsBooked,
+                             allocations, allocationsPerBooking, consistent ? "true" : "false");
+                for (int op = 0; op < OperationCount; ++op) {
+                    const Operation o = static_cast<Operation>(op);
+                    std::fprintf(out, "%s\"%s\": {\"count\": %zu, \"p50\": %.3f, \"p99\": %.3f, \"p999\": %.3f}",
+                                 op ? ", " : "", kOperationNames[op], latencies.ns[op].size(), latencies.percentile(o, 0.5),
+                                 latencies.percentile(o, 0.99), latencies.percentile(o, 0.999));
+                }
+                std::fprintf(out, "}}\n");
+                if (out != stdout) std::fclose(out);
+            }
+        }
+    }
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    return exitCode;
+}
@@ -0,0 +1,356 @@
+#ifndef RESERVATION_LOG_H
+#define RESERVATION_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// CRC-32 (polynôme 0xEDB88320, celui de zlib), par table de 256 entrées
+inline uint32_t crc32(const unsigned char* data, size_t size) {
+    static const struct Table {
+        uint32_t v[256];
+        Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                v[i] = c;
+            }
+        }
+    } table;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) c = table.v[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Journal des réservations, en ajout seul. add() prépare les enregistrements en mémoire ;
+// commit() les écrit d'un bloc et les force sur disque en une seule synchronisation. Seul ce
+// qui a été annoncé après un commit réussi est garanti de survivre à un crash. Un commit qui
+// échoue (disque plein...) ramène le fichier à sa dernière fin valide et garde les
+// enregistrements préparés : le commit suivant les réécrit, à moins que discard() ne les
+// abandonne.
+//
+// Un enregistrement : longueur (4 octets) | CRC-32 (4 octets) | type (1 octet) | champs, avec
+// les entiers en varint et les chaînes précédées de leur longueur. Un enregistrement coupé
+// par un crash ou abîmé est reconnu par sa longueur ou son CRC : la relecture s'arrête là
+// et le fichier y est tronqué.
+//
+// Annulations et fins de retenue s'accumulent : compact() réécrit le journal avec le seul
+// état vivant dans un fichier temporaire, puis le met en place par un renommage.
+class ReservationLog {
+public:
+    enum Type : uint8_t { Reserve = 1, Cancel = 2, Hold = 3, HoldEnd = 4, Wait = 5, WaitEnd = 6 };
+
+    struct Record {
+        Type type = Reserve;
+        int number = 0;
+        std::string event;
+        std::string client;
+        std::string date;
+        int64_t expiresAt = 0;          // Hold
+        std::vector<std::string> seats; // Reserve : une place ; Hold : les places retenues
+        std::vector<int64_t> prices;    // Reserve, Hold : centimes, un prix par place
+        uint32_t seatCount = 0;         // Wait : places demandées
+        int priority = 0;               // Wait
+    };
+
+    explicit ReservationLog(std::string path) : path(std::move(path)) {}
+    ~ReservationLog() { close(); }
+
+    ReservationLog(const ReservationLog&) = delete;
+    ReservationLog& operator=(const ReservationLog&) = delete;
+
+    // Relit le journal par blocs de 1 Mio et appelle onRecord(const Record&) pour chaque
+    // enregistrement valide, puis ouvre le fichier en ajout. Renvoie le nombre d'enregistrements.
+    template <typename F>
+    size_t load(F onRecord) {
+        close();
+        recordCount = 0;
+        uint64_t validEnd = 0;
+        bool truncated = false;
+        if (std::FILE* in = std::fopen(path.c_str(), "rb")) {
+            std::vector<unsigned char> buffer(kBlockSize);
+            size_t begin = 0, end = 0;
+            bool eof = false;
+            Record record;
+            while (true) {
+                // Un enregistrement entier est-il dans le tampon ?
+                if (end - begin >= kHeaderSize) {
+                    const uint32_t length = readU32(&buffer[begin]);
+                    if (length == 0 || length > kMaxRecord) {
+                        truncated = true;
+                        break;
+                    }
+                    if (end - begin >= kHeaderSize + length) {
+                        const unsigned char* payload = &buffer[begin + kHeaderSize];
+                        if (crc32(payload, length) != readU32(&buffer[begin + 4]) ||
+                            !decode(payload, length, record)) {
+                            truncated = true;
+                            break;
+                        }
+                        onRecord(static_cast<const Record&>(record));
+                        ++recordCount;
+                        begin += kHeaderSize + length;
+                        validEnd += kHeaderSize + length;
+                        continue;
+                    }
+                    if (kHeaderSize + length > buffer.size()) buffer.resize(kHeaderSize + length);
+                }
+                if (eof) {
+                    truncated = begin != end;
+                    break;
+                }
+                // Le reste d'un enregistrement à cheval sur deux blocs revient en tête du tampon
+                std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+                end -= begin;
+                begin = 0;
+                const size_t n = std::fread(buffer.data() + end, 1, buffer.size() - end, in);
+                end += n;
+                eof = n == 0;
+            }
+            std::fclose(in);
+        }
+        if (truncated) {
+            std::error_code ec;
+            std::filesystem::resize_file(path, validEnd, ec);
+        }
+        out = std::fopen(path.c_str(), "ab");
+        durableSize = validEnd;
+        return recordCount;
+    }
+
+    // Prépare un enregistrement ; il n'est écrit qu'au commit
+    void add(const Record& r) {
+        const size_t start = pending.size();
+        pending.resize(start + kHeaderSize);
+        encode(r, pending);
+        const uint32_t length = static_cast<uint32_t>(pending.size() - start - kHeaderSize);
+        writeU32(&pending[start], length);
+        writeU32(&pending[start + 4], crc32(&pending[start + kHeaderSize], length));
+        ++pendingCount;
+    }
+
+    // Écrit les enregistrements préparés et les force sur disque, en une seule synchronisation.
+    // En cas d'échec, une écriture partielle est retirée du fichier (elle rendrait illisible
+    // tout ce qui serait ajouté après) et pending est gardé pour le commit suivant.
+    bool commit() {
+        if (pending.empty()) return true;
+        if (out && std::fwrite(pending.data(), 1, pending.size(), out) == pending.size() && sync(out)) {
+            durableSize += pending.size();
+            recordCount += pendingCount;
+            pending.clear();
+            pendingCount = 0;
+            return true;
+        }
+        close(); // Les octets encore dans le tampon de stdio partent ici, avant la troncature
+        std::error_code ec;
+        std::filesystem::resize_file(path, durableSize, ec);
+        out = std::fopen(path.c_str(), "ab");
+        return false;
+    }
+
+    // Abandonne les enregistrements préparés depuis le dernier commit réussi
+    void discard() {
+        pending.clear();
+        pendingCount = 0;
+    }
+
+    // Réécrit le journal à partir de l'état vivant : snapshot(emit) appelle emit(const Record&)
+    // pour chaque réservation et chaque retenue en cours
+    template <typename F>
+    bool compact(F snapshot) {
+        if (!commit()) return false; // Disque en échec : pending attend un commit réussi
+        const std::string tmpPath = path + ".tmp";
+        std::FILE* tmp = std::fopen(tmpPath.c_str(), "wb");
+        if (!tmp) return false;
+        size_t count = 0;
+        bool ok = true;
+        uint64_t written = 0;
+        snapshot([&](const Record& r) {
+            add(r);
+            ++count;
+            if (pending.size() >= kBlockSize) {
+                ok = ok && std::fwrite(pending.data(), 1, pending.size(), tmp) == pending.size();
+                written += pending.size();
+                pending.clear();
+            }
+        });
+        ok = ok && std::fwrite(pending.data(), 1, pending.size(), tmp) == pending.size() && sync(tmp);
+        written += pending.size();
+        pending.clear();
+        pendingCount = 0;
+        std::fclose(tmp);
+
+        std::error_code ec;
+        if (ok) {
+            close();
+            std::filesystem::rename(tmpPath, path, ec);
+            out = std::fopen(path.c_str(), "ab");
+        }
+        if (!ok || ec) {
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        recordCount = count;
+        durableSize = written;
+        return true;
+    }
+
+    // Nombre d'enregistrements dans le fichier, morts compris
+    size_t records() const { return recordCount; }
+
+private:
+    static constexpr size_t kHeaderSize = 8;
+    static constexpr size_t kBlockSize = 1 << 20;
+    static constexpr uint32_t kMaxRecord = 1 << 24;
+
+    std::string path;
+    std::FILE* out = nullptr;
+    std::vector<unsigned char> pending;
+    size_t pendingCount = 0;
+    size_t recordCount = 0;
+    uint64_t durableSize = 0; // Fin du dernier enregistrement forcé sur disque
+
+    void close() {
+        if (out) std::fclose(out);
+        out = nullptr;
+    }
+
+    static bool sync(std::FILE* f) {
+        if (std::fflush(f) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(f)) == 0;
+#else
+        return fsync(fileno(f)) == 0;
+#endif
+    }
+
+    static uint32_t readU32(const unsigned char* p) {
+        return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+    }
+
+    static void writeU32(unsigned char* p, uint32_t v) {
+        for (int i = 0; i < 4; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+
+    static void putVarint(std::vector<unsigned char>& buf, uint64_t v) {
+        while (v >= 0x80) {
+            buf.push_back(static_cast<unsigned char>(v | 0x80));
+            v >>= 7;
+        }
+        buf.push_back(static_cast<unsigned char>(v));
+    }
+
+    static void putString(std::vector<unsigned char>& buf, const std::string& s) {
+        putVarint(buf, s.size());
+        buf.insert(buf.end(), s.begin(), s.end());
+    }
+
+    static void encode(const Record& r, std::vector<unsigned char>& buf) {
+        buf.push_back(r.type);
+        putVarint(buf, static_cast<uint32_t>(r.number));
+        if (r.type == Reserve || r.type == Hold) {
+            putString(buf, r.event);
+            putString(buf, r.client);
+            if (r.type == Reserve) {
+                putString(buf, r.date);
+                putString(buf, r.seats.empty() ? std::string() : r.seats[0]);
+            } else {
+                putVarint(buf, static_cast<uint64_t>(r.expiresAt));
+                putVarint(buf, r.seats.size());
+                for (const std::string& s : r.seats) putString(buf, s);
+            }
+            // Un prix par place, toujours : la relecture refuse un enregistrement incomplet
+            for (size_t i = 0; i < r.seats.size(); ++i) {
+                putVarint(buf, static_cast<uint64_t>(i < r.prices.size() ? r.prices[i] : 0));
+            }
+        } else if (r.type == Wait) {
+            putString(buf, r.event);
+            putString(buf, r.client);
+            putVarint(buf, r.seatCount);
+            // Zigzag : une priorité négative reste courte
+            putVarint(buf, (static_cast<uint64_t>(r.priority) << 1) ^ static_cast<uint64_t>(int64_t(r.priority) >> 63));
+        }
+    }
+
+    // Lecture bornée : un champ qui déborde de l'enregistrement le rend invalide
+    struct Reader {
+        const unsigned char* p;
+        const unsigned char* end;
+
+        bool varint(uint64_t& v) {
+            v = 0;
+            for (int shift = 0; p < end && shift < 64; shift += 7) {
+                const unsigned char b = *p++;
+                v |= uint64_t(b & 0x7F) << shift;
+                if (!(b & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool string(std::string& s) {
+            uint64_t n;
+            if (!varint(n) || n > uint64_t(end - p)) return false;
+            s.assign(reinterpret_cast<const char*>(p), static_cast<size_t>(n));
+            p += n;
+            return true;
+        }
+    };
+
+    static bool decode(const unsigned char* data, size_t size, Record& r) {
+        Reader in{data + 1, data + size};
+        uint64_t v;
+        r.type = static_cast<Type>(data[0]);
+        if (r.type < Reserve || r.type > WaitEnd || !in.varint(v)) return false;
+        r.number = static_cast<int>(v);
+        if (r.type == Cancel || r.type == HoldEnd || r.type == WaitEnd) {
+            r.seats.clear();
+            r.prices.clear();
+            return in.p == in.end;
+        }
+        if (!in.string(r.event) || !in.string(r.client)) return false;
+        // Les chaînes de r sont réutilisées d'un enregistrement à l'autre, sans réallocation
+        if (r.type == Reserve) {
+            r.seats.resize(1);
+            return in.string(r.date) && in.string(r.seats[0]) && readPrices(in, r);
+        }
+        if (r.type == Wait) {
+            uint64_t zigzag;
+            if (!in.varint(v) || !in.varint(zigzag)) return false;
+            r.seatCount = static_cast<uint32_t>(v);
+            r.priority = static_cast<int>(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+            r.seats.clear();
+            r.prices.clear();
+            return in.p == in.end;
+        }
+        uint64_t count;
+        if (!in.varint(v) || !in.varint(count) || count > size) return false;
+        r.expiresAt = static_cast<int64_t>(v);
+        r.seats.resize(static_cast<size_t>(count));
+        for (std::string& s : r.seats) {
+            if (!in.string(s)) return false;
+        }
+        return readPrices(in, r);
+    }
+
+    // Un prix par place, en fin d'enregistrement
+    static bool readPrices(Reader& in, Record& r) {
+        r.prices.resize(r.seats.size());
+        uint64_t v;
+        for (int64_t& price : r.prices) {
+            if (!in.varint(v)) return false;
+            price = static_cast<int64_t>(v);
+        }
+        return in.p == in.end;
+    }
+};
+
+#endif // RESERVATION_LOG_H
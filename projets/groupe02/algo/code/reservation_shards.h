@@ -0,0 +1,427 @@
+#ifndef RESERVATION_SHARDS_H
+#define RESERVATION_SHARDS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+#include "reservation_batch.h"
+#include "reservation_engine.h"
+
+// Moteur découpé par événement : chaque shard est un ReservationEngine complet (plans de
+// salle, réservations, retenues, attentes, journal) pour les événements que shardOf lui
+// donne, et un seul thread le modifie. Une vente record sur un événement n'occupe que son
+// shard : les autres événements continuent d'être servis par les autres cœurs.
+//
+// Les tâches arrivent à un shard par une MpscQueue, sans verrou côté producteurs. Le thread
+// du shard les exécute dans l'ordre d'envoi, par lots, et rend chaque lot durable par un seul
+// commit de son journal ; si ce commit échoue, le moteur annule tout le lot, et durable() le
+// dit pour chacune de ses tâches. Un numéro de réservation, de retenue ou d'attente désigne son shard
+// (EngineConfig::shardIndex) ; une question qui touche tous les événements, comme les
+// réservations d'un client, est posée à chaque shard puis les réponses sont réunies.
+//
+// Le nombre de shards fait partie du format des données : chaque shard a son journal
+// (reservations.0.log, reservations.1.log...), à rouvrir avec le même nombre de shards, que
+// le manifeste reservations.shards garde (checkLayout). L'ancien fichier texte n'est converti
+// que par le moteur non découpé.
+class ReservationShards {
+public:
+    using Task = std::function<void(ReservationEngine&)>;
+
+    ReservationShards(const EngineConfig& config, unsigned count) {
+        count = std::max(1u, count);
+        for (unsigned k = 0; k < count; ++k) shards.push_back(std::make_unique<Shard>());
+        // Les journaux sont relus en parallèle, puis chaque shard démarre son thread
+        std::vector<std::thread> loaders;
+        for (unsigned k = 0; k < count; ++k) {
+            loaders.emplace_back([this, &config, k, count] {
+                shards[k]->engine = std::make_unique<ReservationEngine>(shardConfig(config, k, count));
+            });
+        }
+        for (std::thread& t : loaders) t.join();
+        for (auto& shard : shards) shard->worker = std::thread(&ReservationShards::work, this, std::ref(*shard));
+    }
+
+    ~ReservationShards() {
+        wait();
+        stopping.store(true);
+        for (auto& shard : shards) {
+            wake(*shard);
+            shard->worker.join();
+        }
+    }
+
+    ReservationShards(const ReservationShards&) = delete;
+    ReservationShards& operator=(const ReservationShards&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(shards.size()); }
+
+    // À appeler avant d'ouvrir les données avec count shards (1 : moteur non découpé) : faux si
+    // le dossier a été écrit avec un autre nombre de shards, rendu dans recorded, car ses
+    // réservations seraient ignorées. Le nombre vient du manifeste (EngineConfig::layoutFile),
+    // que le moteur écrit au premier commit qui rend des données durables ; sans manifeste, il
+    // se déduit des journaux, et un dossier sans données accepte tous les nombres.
+    static bool checkLayout(const EngineConfig& config, unsigned count, unsigned* recorded = nullptr) {
+        namespace fs = std::filesystem;
+        count = std::max(1u, count);
+        unsigned written = 0;
+        if (std::ifstream in{config.layoutFile}) {
+            in >> written;
+        } else {
+            auto hasData = [](const std::string& path) {
+                std::error_code ec;
+                const auto size = fs::file_size(path, ec);
+                return !ec && size > 0;
+            };
+            // Chaque shard crée son journal, même vide : leur nombre est celui des shards
+            unsigned logs = 0;
+            bool shardData = false;
+            for (; fs::exists(shardConfig(config, logs, 2).dataFile); ++logs) {
+                shardData = shardData || hasData(shardConfig(config, logs, 2).dataFile);
+            }
+            if (shardData) {
+                written = logs;
+            } else if (hasData(config.dataFile) || hasData(config.legacyDataFile)) {
+                written = 1;
+            } else {
+                written = count;
+            }
+        }
+        if (recorded) *recorded = written;
+        return written == count;
+    }
+    unsigned shardOfEvent(std::string_view name) const { return shardOf(name, size()); }
+    unsigned shardOfNumber(int number) const { return number > 0 ? static_cast<unsigned>(number - 1) % size() : 0; }
+
+    // task(ReservationEngine&) sera exécutée par le thread du shard, après les tâches envoyées
+    // avant elle au même shard. Appelée par un seul thread à la fois (celui qui attend ensuite).
+    // Renvoie le ticket de la tâche dans son shard, pour durable().
+    size_t post(unsigned shard, Task task) {
+        Shard& s = *shards[shard];
+        const size_t ticket = s.posted++;
+        s.queue.push(std::move(task));
+        wake(s);
+        return ticket;
+    }
+
+    // Après wait() : les effets de la tâche ticket du shard sont-ils durables ? Faux si le commit
+    // de son lot a échoué : le moteur est alors revenu à l'état d'avant le lot.
+    bool durable(unsigned shard, size_t ticket) const {
+        const Shard& s = *shards[shard];
+        for (auto it = s.lost.rbegin(); it != s.lost.rend() && it->second > ticket; ++it) {
+            if (ticket >= it->first) return false;
+        }
+        return true;
+    }
+
+    // Attend que toutes les tâches envoyées soient exécutées et rendues durables
+    void wait() {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCv.wait(lock, [this] {
+            for (const auto& shard : shards) {
+                if (shard->done.load(std::memory_order_acquire) != shard->posted) return false;
+            }
+            return true;
+        });
+    }
+
+    // Réservations d'un client dans tous les shards, par numéro
+    std::vector<int> clientReservations(const std::string& client) {
+        std::vector<std::vector<int>> parts(size());
+        for (unsigned k = 0; k < size(); ++k) {
+            post(k, [&client, &part = parts[k]](ReservationEngine& engine) {
+                for (const Reservation* r : engine.reservationTable().findByClient(client)) {
+                    part.push_back(r->reservationNumber);
+                }
+            });
+        }
+        wait();
+        std::vector<int> numbers;
+        for (const std::vector<int>& part : parts) numbers.insert(numbers.end(), part.begin(), part.end());
+        std::sort(numbers.begin(), numbers.end());
+        return numbers;
+    }
+
+private:
+    static constexpr size_t kBatchSize = 256;
+
+    struct Shard {
+        std::unique_ptr<ReservationEngine> engine;
+        MpscQueue<Task> queue;
+        size_t posted = 0;                // Côté producteur
+        std::atomic<size_t> done{0};      // Tâches exécutées et passées par un commit
+        std::vector<std::pair<size_t, size_t>> lost; // Tickets [début, fin) des lots annulés
+        std::atomic<bool> sleeping{false};
+        std::mutex sleepMutex;
+        std::condition_variable sleepCv;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<bool> stopping{false};
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+
+    static EngineConfig shardConfig(const EngineConfig& config, unsigned k, unsigned count) {
+        EngineConfig c = config;
+        c.shardIndex = k;
+        c.shardCount = count;
+        if (count > 1) {
+            // reservations.log -> reservations.0.log, reservations.1.log...
+            const size_t dot = c.dataFile.rfind('.');
+            const std::string suffix = "." + std::to_string(k);
+            c.dataFile = dot == std::string::npos || c.dataFile.find('/', dot) != std::string::npos
+                             ? c.dataFile + suffix
+                             : c.dataFile.substr(0, dot) + suffix + c.dataFile.substr(dot);
+            c.legacyDataFile.clear();
+        }
+        return c;
+    }
+
+    // Le producteur publie sa tâche (ou stopping) avant de lire le drapeau, le thread pose le
+    // drapeau avant de relire la file : l'un des deux voit forcément l'autre
+    void wake(Shard& s) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (s.sleeping.load()) {
+            std::lock_guard<std::mutex> lock(s.sleepMutex);
+            s.sleepCv.notify_one();
+        }
+    }
+
+    void work(Shard& s) {
+        Task task;
+        while (true) {
+            size_t ran = 0;
+            while (ran < kBatchSize && s.queue.pop(task)) {
+                task(*s.engine);
+                ++ran;
+            }
+            if (ran == 0) {
+                if (stopping.load()) break;
+                // File vide : le thread dort jusqu'au prochain post (voir wake). Le verrou est
+                // tenu de la dernière lecture de la file jusqu'à l'attente : un notify ne peut
+                // pas tomber entre les deux.
+                std::unique_lock<std::mutex> lock(s.sleepMutex);
+                s.sleeping.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool found = s.queue.pop(task);
+                while (!found && !stopping.load()) {
+                    s.sleepCv.wait(lock);
+                    found = s.queue.pop(task);
+                }
+                s.sleeping.store(false);
+                if (!found) continue;
+                lock.unlock();
+                task(*s.engine);
+                ran = 1;
+            }
+            const size_t first = s.done.load(std::memory_order_relaxed);
+            if (!s.engine->commit()) s.lost.emplace_back(first, first + ran);
+            s.done.fetch_add(ran, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            doneCv.notify_all();
+        }
+    }
+};
+
+// Mode batch sur un moteur découpé : mêmes commandes et mêmes réponses que BatchSession.
+// Chaque ligne part vers le shard de son événement (HOLD, BOOK, WAIT, FREE, QUOTE) ou de son
+// numéro (CONFIRM, CANCEL, FIND, LEAVE) ; CLIENT est posée à tous les shards. Les réponses d'un
+// bloc sont réunies dans l'ordre des lignes une fois tous les shards passés par leur commit.
+// Une ligne dont le lot a été annulé par un commit échoué répond ERR|STORAGE, comme en
+// BatchSession ; CLIENT aussi, si l'une de ses questions était dans un lot annulé.
+class ShardedBatchSession {
+public:
+    explicit ShardedBatchSession(ReservationShards& shards) : shards(shards), sessions(shards.size()) {
+        // Chaque session n'est utilisée que par le thread de son shard
+        for (unsigned k = 0; k < shards.size(); ++k) {
+            shards.post(k, [this, k](ReservationEngine& engine) { sessions[k] = std::make_unique<BatchSession>(engine); });
+        }
+        shards.wait();
+    }
+
+    BatchStats run(std::FILE* in, std::FILE* out) {
+        std::vector<char> buffer(1 << 16);
+        std::string replies;
+        size_t kept = 0;
+        while (true) {
+            const size_t n = std::fread(buffer.data() + kept, 1, buffer.size() - kept, in);
+            const size_t end = kept + n;
+            // Le bloc s'arrête à la dernière ligne complète (tout le reste en fin de fichier)
+            size_t complete = end;
+            if (n != 0) {
+                while (complete > 0 && buffer[complete - 1] != '\n') --complete;
+            }
+            execute(std::string_view(buffer.data(), complete), replies);
+            std::fwrite(replies.data(), 1, replies.size(), out);
+            replies.clear();
+            if (n == 0) break;
+            kept = end - complete;
+            std::memmove(buffer.data(), buffer.data() + complete, kept);
+            if (kept == buffer.size()) buffer.resize(buffer.size() * 2);
+        }
+        std::fflush(out);
+        return statistics();
+    }
+
+    // Exécute les commandes de block (une par ligne) et ajoute leurs réponses à out
+    void execute(std::string_view block, std::string& out) {
+        lines.clear();
+        while (!block.empty()) {
+            const size_t nl = block.find('\n');
+            std::string_view line = block.substr(0, nl);
+            block = nl == std::string_view::npos ? std::string_view() : block.substr(nl + 1);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (!line.empty() && line[0] != '#') lines.push_back(line);
+        }
+
+        // Une case de réponse par shard pour les échéances, puis une par ligne
+        const unsigned count = shards.size();
+        replies.assign(count + lines.size(), std::string());
+        clientParts.clear();
+        tasks.clear();
+        const int64_t now = nowSecs();
+        for (unsigned k = 0; k < count; ++k) {
+            tasks.push_back({k, shards.post(k, [this, k, now](ReservationEngine&) {
+                sessions[k]->tick(now);
+                replies[k].swap(sessions[k]->pendingReplies());
+            })});
+        }
+        for (size_t i = 0; i < lines.size(); ++i) tasks.push_back(dispatch(lines[i], replies[count + i]));
+        shards.wait();
+
+        size_t part = 0;
+        for (size_t i = 0; i < replies.size(); ++i) {
+            const LineTask& task = tasks[i];
+            if (i < count) {
+                if (shards.durable(task.shard, task.ticket)) out += replies[i]; // Sinon, attributions annulées
+                continue;
+            }
+            if (task.shard == kAllShards) {
+                // Réponses des shards réunies
+                bool durable = true;
+                numbers.clear();
+                for (unsigned s = 0; s < count; ++s, ++part) {
+                    durable = durable && shards.durable(s, clientParts[part].ticket);
+                    numbers.insert(numbers.end(), clientParts[part].numbers.begin(), clientParts[part].numbers.end());
+                }
+                ++clientCommands;
+                if (!durable) {
+                    ++storageFailures;
+                    out += BatchSession::kStorageError;
+                    continue;
+                }
+                std::sort(numbers.begin(), numbers.end());
+                out += "OK";
+                char separator = '|';
+                for (int n : numbers) {
+                    out += separator;
+                    out += std::to_string(n);
+                    separator = ',';
+                }
+                out += '\n';
+            } else if (!shards.durable(task.shard, task.ticket)) {
+                if (replies[i].compare(0, 2, "OK") == 0) ++storageFailures;
+                out += BatchSession::kStorageError;
+            } else {
+                out += replies[i];
+            }
+        }
+    }
+
+    BatchStats statistics() const {
+        BatchStats total;
+        total.commands = clientCommands;
+        total.failures = storageFailures;
+        for (const auto& session : sessions) {
+            total.commands += session->statistics().commands;
+            total.failures += session->statistics().failures;
+        }
+        return total;
+    }
+
+private:
+    ReservationShards& shards;
+    std::vector<std::unique_ptr<BatchSession>> sessions;
+    std::vector<std::string_view> lines;
+    std::vector<std::string> replies;
+    // Tâche envoyée pour une échéance ou une ligne : son shard (kAllShards pour CLIENT) et son ticket
+    struct LineTask {
+        unsigned shard;
+        size_t ticket;
+    };
+    // Réponse d'un shard à CLIENT
+    struct ClientPart {
+        std::vector<int> numbers;
+        size_t ticket = 0;
+    };
+    std::deque<ClientPart> clientParts;   // Un deque : les cases ne bougent pas pendant le bloc
+    std::vector<int> numbers;
+    std::vector<LineTask> tasks;          // Une par case de replies
+    size_t clientCommands = 0;
+    size_t storageFailures = 0;        // Réponses OK remplacées par ERR|STORAGE
+
+    static constexpr unsigned kAllShards = ~0u;
+
+    static std::string_view field(std::string_view line, size_t index) {
+        for (size_t i = 0; i < index; ++i) {
+            const size_t pos = line.find('|');
+            if (pos == std::string_view::npos) return std::string_view();
+            line.remove_prefix(pos + 1);
+        }
+        return line.substr(0, line.find('|'));
+    }
+
+    static bool clientLine(std::string_view line) { return field(line, 0) == "CLIENT"; }
+
+    unsigned route(std::string_view line) const {
+        const std::string_view command = field(line, 0);
+        const std::string_view key = field(line, 1);
+        if (command == "HOLD" || command == "BOOK" || command == "WAIT" || command == "FREE" || command == "QUOTE") {
+            return shards.shardOfEvent(key);
+        }
+        if (command == "CONFIRM" || command == "CANCEL" || command == "FIND" || command == "LEAVE") {
+            int number = 0;
+            for (char c : key.substr(0, 9)) number = c >= '0' && c <= '9' ? number * 10 + (c - '0') : 0;
+            return shards.shardOfNumber(number);
+        }
+        return 0; // Commande inconnue : le shard 0 répond BAD_COMMAND
+    }
+
+    // Pour CLIENT, la tâche rendue n'a pas de ticket : ceux de chaque shard sont dans clientParts
+    LineTask dispatch(std::string_view line, std::string& reply) {
+        if (clientLine(line)) {
+            const std::string client(field(line, 1));
+            for (unsigned k = 0; k < shards.size(); ++k) {
+                ClientPart& part = clientParts.emplace_back();
+                part.ticket = shards.post(k, [client, &part](ReservationEngine& engine) {
+                    for (const Reservation* r : engine.reservationTable().findByClient(client)) {
+                        part.numbers.push_back(r->reservationNumber);
+                    }
+                });
+            }
+            return {kAllShards, 0};
+        }
+        const unsigned k = route(line);
+        return {k, shards.post(k, [this, k, command = std::string(line), &reply](ReservationEngine&) {
+                    sessions[k]->execute(command);
+                    reply.swap(sessions[k]->pendingReplies());
+                })};
+    }
+};
+
+#endif // RESERVATION_SHARDS_H
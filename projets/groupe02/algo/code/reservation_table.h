@@ -0,0 +1,178 @@
+#ifndef RESERVATION_TABLE_H
+#define RESERVATION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Reservation {
+    int reservationNumber = 0;
+    std::string eventName;
+    std::string clientName;
+    std::string date;
+    std::string seatNumber;
+    int64_t price = 0;      // Centimes, prix payé pour la place
+    bool active = false;
+};
+
+// Table des réservations : les enregistrements sont rangés côte à côte dans un pool
+// (un std::vector), les cases libérées par une annulation sont réutilisées.
+// Trois index de hachage donnent l'accès direct par numéro, par client et par événement ;
+// chaque case retient sa position dans les listes par client et par événement, une
+// annulation l'en retire donc en O(1) même pour un événement de 100 000 réservations.
+// Les pointeurs renvoyés restent valides jusqu'au prochain ajout.
+// Les numéros de réservation ne viennent que de nextNumber(), pour le moteur comme pour la
+// vente concurrente : seul nextNumber() peut être appelé par plusieurs threads à la fois ; le
+// reste de la table appartient au thread qui la possède.
+class ReservationTable {
+public:
+    using Slot = uint32_t;
+
+    // Numéros first, first + step, first + 2 step... (un shard sur step) ; avant tout ajout
+    void setNumbering(int first, int step) {
+        numberBase = first;
+        numberStep = step;
+        nextReservationNumber.store(first, std::memory_order_relaxed);
+    }
+
+    int nextNumber() { return nextReservationNumber.fetch_add(numberStep, std::memory_order_relaxed); }
+
+    // Ajoute une réservation avec son numéro (déjà attribué, ou relu depuis le fichier). Un
+    // numéro déjà présent (fichier relu en double) remplace l'ancienne réservation, retirée de
+    // tous les index : sinon elle resterait active, introuvable par son numéro.
+    const Reservation& add(int number, const std::string& event, const std::string& client,
+                           const std::string& date, const std::string& seat, int64_t price = 0) {
+        cancel(number);
+        Slot slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<Slot>(pool.size());
+            pool.emplace_back();
+            clientPos.push_back(0);
+            eventPos.push_back(0);
+        }
+        Reservation& r = pool[slot];
+        r.reservationNumber = number;
+        r.eventName = event;
+        r.clientName = client;
+        r.date = date;
+        r.seatNumber = seat;
+        r.price = price;
+        r.active = true;
+
+        byNumber[number] = slot;
+        link(byClient[client], clientPos, slot);
+        link(byEvent[event], eventPos, slot);
+        // Un numéro relu du journal n'est jamais redonné, même s'il est annulé ensuite : le
+        // compteur passe au premier numéro de la suite après lui, sans reculer
+        const int after = number + 1 + ((numberBase - number - 1) % numberStep + numberStep) % numberStep;
+        int current = nextReservationNumber.load(std::memory_order_relaxed);
+        while (current < after
+               && !nextReservationNumber.compare_exchange_weak(current, after, std::memory_order_relaxed)) {
+        }
+        ++activeCount;
+        return r;
+    }
+
+    const Reservation* findByNumber(int number) const {
+        auto it = byNumber.find(number);
+        return it == byNumber.end() ? nullptr : &pool[it->second];
+    }
+
+    std::vector<const Reservation*> findByClient(const std::string& client) const {
+        return collect(byClient, client);
+    }
+
+    std::vector<const Reservation*> findByEvent(const std::string& event) const {
+        return collect(byEvent, event);
+    }
+
+    // Retire la réservation des index et libère sa case ; renvoie une copie de ce qui a été annulé
+    bool cancel(int number, Reservation* cancelled = nullptr) {
+        auto it = byNumber.find(number);
+        if (it == byNumber.end()) return false;
+        const Slot slot = it->second;
+        byNumber.erase(it);
+
+        Reservation& r = pool[slot];
+        unlink(byClient, r.clientName, clientPos, slot);
+        unlink(byEvent, r.eventName, eventPos, slot);
+        if (cancelled) *cancelled = r;
+        r.active = false;
+        r.clientName.clear();
+        r.eventName.clear();
+        freeSlots.push_back(slot);
+        --activeCount;
+        return true;
+    }
+
+    // Parcourt les réservations actives dans l'ordre du pool
+    template <typename F>
+    void forEach(F f) const {
+        for (const Reservation& r : pool) {
+            if (r.active) f(r);
+        }
+    }
+
+    size_t size() const { return activeCount; }
+
+    // Vide la table ; la numérotation est à redonner par setNumbering
+    void clear() {
+        pool.clear();
+        freeSlots.clear();
+        clientPos.clear();
+        eventPos.clear();
+        byNumber.clear();
+        byClient.clear();
+        byEvent.clear();
+        activeCount = 0;
+    }
+
+private:
+    using Index = std::unordered_map<std::string, std::vector<Slot>>;
+
+    std::vector<Reservation> pool;
+    std::vector<Slot> freeSlots;
+    std::vector<uint32_t> clientPos; // Position de chaque case dans sa liste byClient
+    std::vector<uint32_t> eventPos;  // ... et dans sa liste byEvent
+    std::unordered_map<int, Slot> byNumber;
+    Index byClient;
+    Index byEvent;
+    size_t activeCount = 0;
+    int numberBase = 1;
+    int numberStep = 1;
+    std::atomic<int> nextReservationNumber{1};
+
+    std::vector<const Reservation*> collect(const Index& index, const std::string& key) const {
+        std::vector<const Reservation*> result;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            result.reserve(it->second.size());
+            for (Slot slot : it->second) result.push_back(&pool[slot]);
+        }
+        return result;
+    }
+
+    static void link(std::vector<Slot>& slots, std::vector<uint32_t>& positions, Slot slot) {
+        positions[slot] = static_cast<uint32_t>(slots.size());
+        slots.push_back(slot);
+    }
+
+    // La dernière case de la liste prend la place de celle qui part
+    static void unlink(Index& index, const std::string& key, std::vector<uint32_t>& positions, Slot slot) {
+        auto it = index.find(key);
+        if (it == index.end()) return;
+        std::vector<Slot>& slots = it->second;
+        const uint32_t pos = positions[slot];
+        slots[pos] = slots.back();
+        positions[slots[pos]] = pos;
+        slots.pop_back();
+        if (slots.empty()) index.erase(it);
+    }
+};
+
+#endif // RESERVATION_TABLE_H
@@ -0,0 +1,85 @@
+#ifndef SEAT_HOLDS_H
+#define SEAT_HOLDS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "seat_map.h"
+#include "timer_wheel.h"
+
+// Places retenues pendant le paiement : elles sont prises dans le plan de salle dès la
+// retenue, puis deviennent des réservations à la confirmation, ou sont rendues à l'échéance.
+struct SeatHold {
+    int number = 0;
+    size_t event = 0;          // Indice de l'événement
+    std::string client;
+    std::vector<SeatId> seats;
+    std::vector<int64_t> prices; // Centimes, prix de chaque place au moment de la retenue
+    int64_t expiresAt = 0;     // Secondes depuis l'époque Unix
+    TimerWheel<int>::Handle timer;
+};
+
+// Les échéances sont rangées dans une roue de temporisation (un tick par seconde) : des
+// millions de retenues en attente ne coûtent rien tant qu'elles n'expirent pas.
+class SeatHolds {
+public:
+    explicit SeatHolds(int64_t nowSecs) : wheel(static_cast<uint64_t>(nowSecs)) {}
+
+    // number = 0 : nouveau numéro ; sinon numéro relu depuis le fichier
+    const SeatHold& place(size_t event, const std::string& client, const std::vector<SeatId>& seats,
+                          const std::vector<int64_t>& prices, int64_t expiresAt, int number = 0) {
+        if (number == 0) number = nextHoldNumber;
+        if (number >= nextHoldNumber) nextHoldNumber = number + 1;
+        SeatHold& h = holds[number];
+        h.number = number;
+        h.event = event;
+        h.client = client;
+        h.seats = seats;
+        h.prices = prices;
+        h.expiresAt = expiresAt;
+        h.timer = wheel.add(static_cast<uint64_t>(expiresAt), number);
+        return h;
+    }
+
+    const SeatHold* find(int number) const {
+        auto it = holds.find(number);
+        return it == holds.end() ? nullptr : &it->second;
+    }
+
+    // Retire une retenue avant son échéance (confirmée ou abandonnée) ; false si elle a expiré
+    bool take(int number, SeatHold& out) {
+        auto it = holds.find(number);
+        if (it == holds.end()) return false;
+        wheel.cancel(it->second.timer);
+        out = std::move(it->second);
+        holds.erase(it);
+        return true;
+    }
+
+    // Fait expirer les retenues échues ; onExpired(const SeatHold&) doit rendre leurs places
+    template <typename F>
+    void expire(int64_t nowSecs, F onExpired) {
+        wheel.advance(static_cast<uint64_t>(nowSecs), [&](int number) {
+            auto it = holds.find(number);
+            if (it == holds.end()) return;
+            onExpired(it->second);
+            holds.erase(it);
+        });
+    }
+
+    template <typename F>
+    void forEach(F f) const {
+        for (const auto& entry : holds) f(entry.second);
+    }
+
+    size_t size() const { return holds.size(); }
+
+private:
+    TimerWheel<int> wheel;
+    std::unordered_map<int, SeatHold> holds;
+    int nextHoldNumber = 1;
+};
+
+#endif // SEAT_HOLDS_H
@@ -0,0 +1,301 @@
+#ifndef SEAT_MAP_H
+#define SEAT_MAP_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Opérations sur les mots de 64 bits (x != 0 pour ctz et clz)
+inline int countTrailingZeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+inline int countLeadingZeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return 63 - static_cast<int>(i);
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+inline int popCount(uint64_t x) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Position d'une place : section, rang dans la section, numéro dans le rang (à partir de 0)
+struct SeatId {
+    uint32_t section = 0;
+    uint32_t row = 0;
+    uint32_t number = 0;
+};
+
+// Plan de salle : une place = un bit (1 = libre). Chaque rang commence sur un nouveau mot de
+// 64 bits, les bits au-delà de la dernière place d'un rang restent à 0 (jamais libres).
+// Les étiquettes ("A1", "Nord B12", "Table 3") ne sont fabriquées que pour l'affichage.
+//
+// Une fois la salle construite (addSection/addRow), claim, claimAdjacent et release peuvent
+// être appelés par plusieurs threads à la fois : chaque mot est un std::atomic modifié par
+// compare-and-swap, sans aucun verrou. Deux acheteurs ne peuvent pas obtenir la même place.
+class SeatMap {
+public:
+    struct Row {
+        std::string label;   // "A", "B"... ou "Table "
+        uint32_t firstWord = 0;
+        uint32_t seatCount = 0;
+    };
+
+    struct Section {
+        std::string name;    // Vide pour une salle sans sections
+        uint32_t firstRow = 0;
+        uint32_t rowCount = 0;
+    };
+
+    uint32_t addSection(const std::string& name) {
+        sections.push_back(Section{name, static_cast<uint32_t>(rows.size()), 0});
+        return static_cast<uint32_t>(sections.size() - 1);
+    }
+
+    // Ajoute un rang de seatCount places, toutes libres, à la dernière section (créée au besoin)
+    void addRow(const std::string& label, uint32_t seatCount) {
+        if (sections.empty()) addSection("");
+        Row row{label, static_cast<uint32_t>(wordCount), seatCount};
+        const uint32_t rowWords = (seatCount + 63) / 64;
+        if (wordCount + rowWords > wordCapacity) {
+            // Construction de la salle (un seul thread) : on recopie dans un tableau deux fois plus grand
+            const size_t capacity = std::max<size_t>(64, 2 * (wordCount + rowWords));
+            std::unique_ptr<std::atomic<uint64_t>[]> grown(new std::atomic<uint64_t>[capacity]);
+            for (size_t w = 0; w < wordCount; ++w) grown[w].store(words[w].load(std::memory_order_relaxed));
+            words = std::move(grown);
+            wordCapacity = capacity;
+        }
+        for (uint32_t w = 0; w < rowWords; ++w) {
+            const uint32_t bits = seatCount - w * 64;
+            words[wordCount++].store(bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1);
+        }
+        rowByPrefix[labelPrefix(sections.back(), row)] = static_cast<uint32_t>(rows.size());
+        rows.push_back(row);
+        ++sections.back().rowCount;
+        totalSeats += seatCount;
+    }
+
+    // Section de rowCount rangs nommés A, B, ..., Z, AA, AB...
+    void addSection(const std::string& name, uint32_t rowCount, uint32_t seatsPerRow) {
+        addSection(name);
+        for (uint32_t r = 0; r < rowCount; ++r) addRow(rowName(r), seatsPerRow);
+    }
+
+    // Compté à la demande (un popcount par mot) : pas de compteur partagé entre les acheteurs
+    size_t freeCount() const {
+        size_t n = 0;
+        for (size_t w = 0; w < wordCount; ++w) n += popCount(word(w));
+        return n;
+    }
+    size_t capacity() const { return totalSeats; }
+    size_t rowCount() const { return rows.size(); }
+    uint32_t rowSeats(uint32_t rowIdx) const { return rows[rowIdx].seatCount; }
+    const std::vector<Section>& sectionList() const { return sections; }
+
+    bool isFree(const SeatId& s) const {
+        const uint32_t r = rowIndex(s);
+        if (r >= rows.size() || s.number >= rows[r].seatCount) return false;
+        return (word(rows[r].firstWord + s.number / 64) >> (s.number % 64)) & 1;
+    }
+
+    // Prend la place si elle est libre
+    bool claim(const SeatId& s) {
+        const uint32_t r = rowIndex(s);
+        if (r >= rows.size() || s.number >= rows[r].seatCount) return false;
+        return claimBits(rows[r].firstWord + s.number / 64, uint64_t(1) << (s.number % 64));
+    }
+
+    // Rend une place occupée
+    bool release(const SeatId& s) {
+        const uint32_t r = rowIndex(s);
+        if (r >= rows.size() || s.number >= rows[r].seatCount) return false;
+        const uint64_t bit = uint64_t(1) << (s.number % 64);
+        return !(words[rows[r].firstWord + s.number / 64].fetch_or(bit, std::memory_order_acq_rel) & bit);
+    }
+
+    // Prend count places côte à côte (la première est renvoyée dans first). La recherche
+    // commence au rang startRow : des acheteurs qui partent de rangs différents se gênent moins.
+    // Si un autre thread prend une place de la suite trouvée entre-temps, on cherche à nouveau.
+    bool claimAdjacent(uint32_t count, SeatId& first, int section = -1, uint32_t startRow = 0) {
+        while (findAdjacent(count, first, section, startRow)) {
+            if (claimRun(sections[first.section].firstRow + first.row, first.number, count)) return true;
+        }
+        return false;
+    }
+
+    // Première suite de count places libres côte à côte dans un rang (numéro de la première,
+    // -1 si aucune). Dans un mot, x & (x >> 1) & (x >> 2)... ne garde que les débuts de suites
+    // assez longues ; une suite à cheval sur deux mots est suivie par sa longueur.
+    int findAdjacentInRow(uint32_t rowIdx, uint32_t count) const {
+        const Row& row = rows[rowIdx];
+        if (count == 0 || count > row.seatCount) return -1;
+        const uint32_t rowWords = (row.seatCount + 63) / 64;
+        uint32_t run = 0; // Places libres consécutives à la fin des mots précédents
+        for (uint32_t w = 0; w < rowWords; ++w) {
+            const uint64_t x = word(row.firstWord + w);
+            const uint32_t leading = (~x == 0) ? 64 : static_cast<uint32_t>(countTrailingZeros(~x));
+            if (run > 0 && run + leading >= count) return static_cast<int>(w * 64 - run);
+
+            uint64_t starts = x;
+            for (uint32_t len = 1; len < count && starts; ) {
+                const uint32_t shift = std::min(len, count - len);
+                starts &= starts >> shift;
+                len += shift;
+            }
+            if (count <= 64 && starts) return static_cast<int>(w * 64 + countTrailingZeros(starts));
+
+            if (~x == 0) {
+                run += 64;
+            } else {
+                run = (x >> 63) ? static_cast<uint32_t>(countLeadingZeros(~x)) : 0;
+            }
+        }
+        return -1;
+    }
+
+    // Cherche count places côte à côte, rang par rang à partir de startRow (numéro dans toute
+    // la salle), dans une section ou dans toute la salle
+    bool findAdjacent(uint32_t count, SeatId& first, int section = -1, uint32_t startRow = 0) const {
+        const uint32_t total = static_cast<uint32_t>(rows.size());
+        for (uint32_t i = 0; i < total; ++i) {
+            const uint32_t r = (startRow + i) % total;
+            const uint32_t s = sectionOf(r);
+            if (section >= 0 && s != static_cast<uint32_t>(section)) continue;
+            const int n = findAdjacentInRow(r, count);
+            if (n >= 0) {
+                first = SeatId{s, r - sections[s].firstRow, static_cast<uint32_t>(n)};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t freeInSection(uint32_t section) const {
+        size_t n = 0;
+        const Section& sec = sections[section];
+        for (uint32_t r = sec.firstRow; r < sec.firstRow + sec.rowCount; ++r) {
+            for (uint32_t w = 0; w < (rows[r].seatCount + 63) / 64; ++w) n += popCount(word(rows[r].firstWord + w));
+        }
+        return n;
+    }
+
+    // Appelle f(SeatId) pour chaque place libre, dans l'ordre de la salle
+    template <typename F>
+    void forEachFree(F f) const {
+        for (uint32_t s = 0; s < sections.size(); ++s) {
+            for (uint32_t r = 0; r < sections[s].rowCount; ++r) {
+                const Row& row = rows[sections[s].firstRow + r];
+                for (uint32_t w = 0; w < (row.seatCount + 63) / 64; ++w) {
+                    for (uint64_t x = word(row.firstWord + w); x; x &= x - 1) {
+                        f(SeatId{s, r, w * 64 + static_cast<uint32_t>(countTrailingZeros(x))});
+                    }
+                }
+            }
+        }
+    }
+
+    std::string label(const SeatId& s) const {
+        return labelPrefix(sections[s.section], rows[rowIndex(s)]) + std::to_string(s.number + 1);
+    }
+
+    // Inverse de label() : "Nord B12" -> section Nord, rang B, place 12
+    bool parseLabel(const std::string& text, SeatId& s) const {
+        size_t digits = text.size();
+        while (digits > 0 && text[digits - 1] >= '0' && text[digits - 1] <= '9') --digits;
+        if (digits == text.size() || text.size() - digits > 6) return false;
+        auto it = rowByPrefix.find(text.substr(0, digits));
+        if (it == rowByPrefix.end()) return false;
+        const uint32_t number = static_cast<uint32_t>(std::stoul(text.substr(digits)));
+        if (number == 0 || number > rows[it->second].seatCount) return false;
+        const uint32_t section = sectionOf(it->second);
+        s = SeatId{section, it->second - sections[section].firstRow, number - 1};
+        return true;
+    }
+
+    static std::string rowName(uint32_t r) {
+        std::string name;
+        for (uint32_t v = r + 1; v > 0; v = (v - 1) / 26) name.insert(name.begin(), char('A' + (v - 1) % 26));
+        return name;
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    size_t wordCount = 0;
+    size_t wordCapacity = 0;
+    std::vector<Row> rows;
+    std::vector<Section> sections;
+    std::unordered_map<std::string, uint32_t> rowByPrefix; // Étiquette sans le numéro -> rang
+    size_t totalSeats = 0;
+
+    uint64_t word(size_t w) const { return words[w].load(std::memory_order_acquire); }
+
+    // Passe à 0 les bits de mask, seulement s'ils sont tous à 1 (libres)
+    bool claimBits(size_t w, uint64_t mask) {
+        uint64_t x = words[w].load(std::memory_order_relaxed);
+        do {
+            if ((x & mask) != mask) return false;
+        } while (!words[w].compare_exchange_weak(x, x & ~mask, std::memory_order_acq_rel, std::memory_order_relaxed));
+        return true;
+    }
+
+    // Prend les places start..start+count-1 d'un rang, mot par mot ; si un mot échoue,
+    // les mots déjà pris sont rendus
+    bool claimRun(uint32_t rowIdx, uint32_t start, uint32_t count) {
+        const Row& row = rows[rowIdx];
+        for (uint32_t pos = start; pos < start + count; ) {
+            const uint32_t bit = pos % 64;
+            const uint32_t n = std::min(64 - bit, start + count - pos);
+            const uint64_t mask = (n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1) << bit;
+            if (!claimBits(row.firstWord + pos / 64, mask)) {
+                for (uint32_t back = start; back < pos; back += 64 - back % 64) {
+                    const uint32_t m = std::min(64 - back % 64, pos - back);
+                    words[row.firstWord + back / 64].fetch_or((m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1) << (back % 64),
+                                                                std::memory_order_acq_rel);
+                }
+                return false;
+            }
+            pos += n;
+        }
+        return true;
+    }
+
+    uint32_t sectionOf(uint32_t rowIdx) const {
+        uint32_t s = 0;
+        while (rowIdx >= sections[s].firstRow + sections[s].rowCount) ++s;
+        return s;
+    }
+
+    uint32_t rowIndex(const SeatId& s) const {
+        if (s.section >= sections.size() || s.row >= sections[s.section].rowCount) return UINT32_MAX;
+        return sections[s.section].firstRow + s.row;
+    }
+
+    static std::string labelPrefix(const Section& section, const Row& row) {
+        return section.name.empty() ? row.label : section.name + " " + row.label;
+    }
+};
+
+#endif // SEAT_MAP_H
@@ -0,0 +1,132 @@
+#ifndef SECTION_PRICING_H
+#define SECTION_PRICING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "seat_map.h"
+
+// Montants en centimes : aucun arrondi flottant dans les totaux
+using Cents = int64_t;
+
+// "45.50" (ou "45") -> 4550 ; false si le texte n'est pas un montant
+inline bool parsePrice(const std::string& text, Cents& cents) {
+    const size_t dot = text.find('.');
+    const std::string units = text.substr(0, dot);
+    const std::string decimals = dot == std::string::npos ? std::string() : text.substr(dot + 1);
+    if (units.empty() || units.size() > 7 || decimals.size() > 2 || (dot != std::string::npos && decimals.empty())) {
+        return false;
+    }
+    cents = 0;
+    for (char c : units + (decimals + "00").substr(0, 2)) {
+        if (c < '0' || c > '9') return false;
+        cents = cents * 10 + (c - '0');
+    }
+    return true;
+}
+
+inline std::string formatPrice(Cents cents) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof buffer, "%lld.%02lld", static_cast<long long>(cents / 100),
+                  static_cast<long long>(cents % 100));
+    return buffer;
+}
+
+// Paliers de prix selon la part de la section déjà prise (vendue ou retenue), en pour mille :
+// le prix de base jusqu'à la moitié, puis +10 %, +25 % et +50 % pour les dernières places.
+struct PriceTier {
+    uint32_t takenPermille;
+    uint32_t percent;
+};
+constexpr PriceTier kPriceTiers[] = {{0, 100}, {500, 110}, {750, 125}, {900, 150}};
+
+// Prix des sections d'un événement, recalculés à chaque place prise ou rendue.
+//
+// Chaque section tient dans un seul mot atomique : places prises (32 bits de poids faible) et
+// prix courant en centimes (32 bits de poids fort). Une vente fait un compare-and-swap sur ce
+// mot et ne change le prix qu'en franchissant un palier, sans relire le plan de salle ; un
+// devis (price) est une simple lecture atomique, jamais bloquée par une vente en cours, et
+// donne toujours un prix cohérent avec le nombre de places prises.
+//
+// Comme le SeatMap, taken/released peuvent être appelés par plusieurs threads à la fois.
+class SectionPricing {
+public:
+    SectionPricing() = default;
+
+    // basePrices[s] : prix de base de la section s (0 si absent) ; les places déjà prises
+    // dans le plan de salle sont comptées
+    SectionPricing(const SeatMap& seats, const std::vector<Cents>& basePrices) {
+        const size_t n = seats.sectionList().size();
+        sections.resize(n);
+        state.reset(new std::atomic<uint64_t>[n]);
+        for (uint32_t s = 0; s < n; ++s) {
+            Section& sec = sections[s];
+            const SeatMap::Section& layout = seats.sectionList()[s];
+            for (uint32_t r = 0; r < layout.rowCount; ++r) sec.capacity += seats.rowSeats(layout.firstRow + r);
+            sec.base = s < basePrices.size() ? basePrices[s] : 0;
+            const uint32_t taken = sec.capacity - static_cast<uint32_t>(seats.freeInSection(s));
+            state[s].store(pack(taken, priceFor(sec, taken)), std::memory_order_relaxed);
+        }
+    }
+
+    size_t sectionCount() const { return sections.size(); }
+    Cents basePrice(uint32_t section) const { return sections[section].base; }
+
+    // Prix courant d'une place de la section
+    Cents price(uint32_t section) const {
+        return static_cast<Cents>(state[section].load(std::memory_order_acquire) >> 32);
+    }
+
+    uint32_t takenCount(uint32_t section) const {
+        return static_cast<uint32_t>(state[section].load(std::memory_order_acquire));
+    }
+
+    // count places viennent d'être prises ; renvoie le prix unitaire auquel elles sont vendues
+    // (celui d'avant la vente : c'est le prix affiché à l'acheteur)
+    Cents taken(uint32_t section, uint32_t count) {
+        return update(section, static_cast<int64_t>(count));
+    }
+
+    void released(uint32_t section, uint32_t count) {
+        update(section, -static_cast<int64_t>(count));
+    }
+
+private:
+    struct Section {
+        uint32_t capacity = 0;
+        Cents base = 0;
+    };
+
+    std::vector<Section> sections;
+    std::unique_ptr<std::atomic<uint64_t>[]> state;
+
+    static uint64_t pack(uint32_t taken, Cents price) {
+        return static_cast<uint64_t>(price) << 32 | taken;
+    }
+
+    static Cents priceFor(const Section& sec, uint32_t taken) {
+        uint32_t percent = kPriceTiers[0].percent;
+        for (const PriceTier& tier : kPriceTiers) {
+            if (uint64_t(taken) * 1000 >= uint64_t(tier.takenPermille) * sec.capacity) percent = tier.percent;
+        }
+        return sec.base * percent / 100;
+    }
+
+    Cents update(uint32_t section, int64_t delta) {
+        uint64_t current = state[section].load(std::memory_order_relaxed);
+        while (true) {
+            const int64_t taken = static_cast<int64_t>(static_cast<uint32_t>(current)) + delta;
+            const uint32_t next = taken < 0 ? 0 : static_cast<uint32_t>(taken);
+            if (state[section].compare_exchange_weak(current, pack(next, priceFor(sections[section], next)),
+                                                     std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return static_cast<Cents>(current >> 32);
+            }
+        }
+    }
+};
+
+#endif // SECTION_PRICING_H
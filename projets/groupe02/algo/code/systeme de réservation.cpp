@@ -1,18 +1,33 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <thread>
 #include <chrono>
+#include <climits>
+#include <limits>
+#include <ctime>
+#include <cstdio>
 #include <regex>
 #include <stack>
 #include <vector>
 #include <stdexcept>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <filesystem>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+#include "concurrent_booking.h"
+#include "messages.h"
+#include "reservation_batch.h"
+#include "reservation_engine.h"
+#include "reservation_shards.h"
+
 // Couleurs ANSI
 #define RESET   "\033[0m"
 #define RED     "\033[31m"
@@ -22,43 +37,70 @@
 #define CYAN    "\033[36m"
 #define MAGENTA "\033[35m"
 
-const std::string DATA_FILE = "reservations.txt";
-enum Language { FRENCH, ENGLISH };
 Language currentLang = FRENCH;
 
-struct Event {
-    std::string name;
-    std::string date;
-    std::string location;
-    std::vector<std::string> availableSeats;
+std::string_view tr(Msg id) {
+    return message(currentLang, id);
+}
 
-    Event(std::string n, std::string d, std::string l, std::vector<std::string> seats)
-        : name(n), date(d), location(l), availableSeats(seats) {}
-};
+std::string tr(Msg id, std::initializer_list<std::string_view> args) {
+    std::string text;
+    appendMessage(text, tr(id), args);
+    return text;
+}
+
+// Sortie de l'interface : un écran est composé dans un tampon réutilisé d'un écran à l'autre,
+// puis écrit d'un seul bloc par flush, juste avant chaque saisie (prompt) ; les lignes centrées
+// sont formatées directement dans le tampon, sans chaîne intermédiaire.
+class Screen {
+public:
+    void line(std::string_view text, const char* color = RESET, int width = 80) {
+        pad(text.size(), color, width);
+        buffer.append(text);
+        buffer.append(RESET "\n");
+    }
 
-struct ReservationNode {
-    int reservationNumber;
-    std::string eventName;
-    std::string clientName;
-    std::string date;
-    std::string seatNumber;
-    ReservationNode* next;
+    void line(Msg id, const char* color = RESET) {
+        line(tr(id), color);
+    }
+
+    void line(Msg id, std::initializer_list<std::string_view> args, const char* color = RESET, int width = 80) {
+        const std::string_view text = tr(id);
+        pad(messageLength(text, args), color, width);
+        appendMessage(buffer, text, args);
+        buffer.append(RESET "\n");
+    }
+
+    void blank() { buffer.push_back('\n'); }
+
+    // Question sans retour à la ligne, affichée avant d'attendre la réponse
+    void prompt(std::string_view text) {
+        buffer.append(text);
+        flush();
+    }
 
-    static int nextReservationNumber;
+    void prompt(Msg id) { prompt(tr(id)); }
 
-    ReservationNode(std::string event, std::string name, std::string d, std::string seat)
-        : eventName(event), clientName(name), date(d), seatNumber(seat), next(nullptr) {
-        reservationNumber = nextReservationNumber++;
+    void flush() {
+        std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::cout.flush();
+        buffer.clear();
     }
 
-    std::string toFileString() const {
-        return std::to_string(reservationNumber) + "|" + eventName + "|" + clientName + "|" + date + "|" + seatNumber;
+private:
+    std::string buffer;
+
+    void pad(size_t length, const char* color, int width) {
+        const int padding = (width - static_cast<int>(length)) / 2;
+        buffer.append(color);
+        if (padding > 0) buffer.append(static_cast<size_t>(padding), ' ');
     }
 };
 
-int ReservationNode::nextReservationNumber = 1;
+Screen screen;
 
 void clearScreen() {
+    screen.flush();
 #ifdef _WIN32
     system("cls");
 #else
@@ -66,14 +108,9 @@ void clearScreen() {
 #endif
 }
 
-void printCentered(const std::string& text, int width = 80, const std::string& color = RESET) {
-    int padding = (width - static_cast<int>(text.length())) / 2;
-    if (padding < 0) padding = 0;
-    std::cout << color << std::string(padding, ' ') << text << RESET << std::endl;
-}
-
 void loadingAnimation(int points = 5, int delay = 200) {
-    printCentered("Chargement", 80, BLUE);
+    screen.line("Chargement", BLUE);
+    screen.flush();
     for (int i = 0; i < points; i++) {
         std::cout << "." << std::flush;
         std::this_thread::sleep_for(std::chrono::milliseconds(delay));
@@ -81,186 +118,601 @@ void loadingAnimation(int points = 5, int delay = 200) {
     std::cout << std::endl;
 }
 
+std::string formatTime(int64_t secs) {
+    const std::time_t t = static_cast<std::time_t>(secs);
+    char buffer[16];
+    std::strftime(buffer, sizeof buffer, "%H:%M:%S", std::localtime(&t));
+    return buffer;
+}
+
+// Réponse affirmative, quelle que soit la langue (oui, yes, sí)
+bool isYes(const std::string& answer) {
+    return !answer.empty() && std::string_view("oOyYsS").find(answer[0]) != std::string_view::npos;
+}
+
+// Interface terminal du moteur de réservation
 class ReservationSystem {
 private:
-    ReservationNode* head;
-    std::vector<Event> eventList;
+    ReservationEngine engine;
 
 public:
-    ReservationSystem() : head(nullptr) {
-        initializeEvents();
-        loadFromFile();
+    ReservationSystem() {
+        if (!engine.catalogueLoaded()) {
+            std::cerr << tr(Msg::CatalogueNotFound, {EngineConfig().eventsFile}) << std::endl;
+        }
+        for (size_t line : engine.catalogueLineErrors()) {
+            std::cerr << tr(Msg::CatalogueLineIgnored, {EngineConfig().eventsFile, std::to_string(line)}) << std::endl;
+        }
     }
 
-    ~ReservationSystem() {
-        saveToFile();
-        while (head) {
-            ReservationNode* temp = head;
-            head = head->next;
-            delete temp;
+    static std::string statusMessage(BookingStatus status) {
+        switch (status) {
+            case BookingStatus::Ok: break;
+            case BookingStatus::UnknownEvent: return std::string(tr(Msg::InvalidChoice));
+            case BookingStatus::SoldOut: return std::string(tr(Msg::SoldOut));
+            case BookingStatus::NotEnoughSeats: return std::string(tr(Msg::NotEnoughSeats));
+            case BookingStatus::InvalidSeat: return std::string(tr(Msg::InvalidSeat));
+            case BookingStatus::UnknownHold: return std::string(tr(Msg::UnknownHold));
+            case BookingStatus::UnknownReservation: return std::string(tr(Msg::UnknownReservation));
+            case BookingStatus::UnknownWait: return std::string(tr(Msg::UnknownWait));
+            case BookingStatus::InvalidRequest: return tr(Msg::WaitSeatsRange, {std::to_string(Waitlist::kMaxSeats)});
         }
+        return std::string();
     }
 
-    void initializeEvents() {
-        eventList.push_back(Event("Concert Symphonique", "15/12/2023", "Opéra National", {"A1", "A2", "B1", "B2"}));
-        eventList.push_back(Event("Festival Rock", "20/11/2023", "Stade de la Ville", {"C1", "C2", "D1", "D2"}));
-        eventList.push_back(Event("Match de Football", "25/11/2023", "Stade Municipal", {"E1", "E2", "F1", "F2"}));
-        eventList.push_back(Event("Dîner Gastronomique", "30/11/2023", "Restaurant Étoilé", {"Table 1", "Table 2", "Table 3"}));
+    static void check(BookingStatus status) {
+        if (status != BookingStatus::Ok) throw std::invalid_argument(statusMessage(status));
     }
 
-    void displayEvents() {
-        printCentered(currentLang == FRENCH ? "=== ÉVÉNEMENTS DISPONIBLES ===" : "=== AVAILABLE EVENTS ===", 80, MAGENTA);
-
-        for (size_t i = 0; i < eventList.size(); ++i) {
-            const Event& e = eventList[i];
-            printCentered(std::to_string(i + 1) + ". " + e.name, 80, CYAN);
-            printCentered("Date: " + e.date, 80, YELLOW);
-            printCentered("Lieu/Location: " + e.location, 80, BLUE);
+    // Rend les opérations durables, puis annonce les places attribuées aux listes d'attente.
+    // Un commit échoué a annulé l'opération : elle est refusée comme les autres erreurs.
+    void commit() {
+        if (!engine.commit()) throw std::runtime_error(std::string(tr(Msg::SaveError)));
+        for (const ReservationEngine::WaitAllocation& a : engine.takeAllocations()) {
             std::string seats;
-            for (const auto& s : e.availableSeats) seats += s + " ";
-            printCentered("Places: " + seats, 80, GREEN);
-            std::cout << std::endl;
+            for (int n : a.reservations) seats += " " + engine.reservationTable().findByNumber(n)->seatNumber;
+            screen.line(Msg::WaitAllocated,
+                        {std::to_string(a.waitNumber), a.client, engine.eventTable().name(a.event), seats}, GREEN);
+        }
+    }
+
+    void offerWaitlist(EventTable::EventId eventId, const std::string& name, uint32_t seats) {
+        screen.prompt(Msg::JoinWaitlistPrompt);
+        std::string answer;
+        std::getline(std::cin >> std::ws, answer);
+        if (!isYes(answer)) return;
+        if (seats == 0) {
+            screen.prompt(Msg::AdjacentCountPrompt);
+            std::cin >> seats;
+            std::cin.ignore();
+            if (!std::cin) {
+                std::cin.clear();
+                seats = 0;
+            }
+        }
+        int waitNumber = 0;
+        check(engine.joinWaitlist(eventId, name, seats, 0, &waitNumber));
+        commit();
+        screen.line(Msg::WaitJoined, {std::to_string(waitNumber)}, YELLOW);
+    }
+
+    void leaveWaitlist() {
+        screen.prompt(Msg::WaitNumberPrompt);
+        int number;
+        std::cin >> number;
+        std::cin.ignore();
+        if (!std::cin) {
+            std::cin.clear();
+            check(BookingStatus::UnknownWait);
+        }
+        check(engine.leaveWaitlist(number));
+        commit();
+        screen.line(Msg::WaitLeft, GREEN);
+    }
+
+    void displayEvent(EventTable::EventId id) {
+        const SeatMap& seats = engine.eventTable().seats(id);
+        screen.line(std::to_string(id + 1) + ". " + engine.eventTable().name(id), CYAN);
+        screen.line(Msg::EventDate, {formatDate(engine.eventTable().day(id))}, YELLOW);
+        screen.line(Msg::EventVenue, {engine.eventTable().venue(id)}, BLUE);
+        // Petite salle : la liste des places ; grande salle : les places libres par section
+        std::string free;
+        if (seats.freeCount() <= 40) {
+            seats.forEachFree([&](const SeatId& s) { free += seats.label(s) + " "; });
+        } else {
+            const std::vector<SeatMap::Section>& sections = seats.sectionList();
+            for (uint32_t s = 0; s < sections.size(); ++s) {
+                free += sections[s].name + " " + std::to_string(seats.freeInSection(s)) + "  ";
+            }
+        }
+        screen.line(Msg::EventSeats, {free}, GREEN);
+        // Prix courant de chaque section, qui monte à mesure que la section se remplit
+        const SectionPricing& pricing = engine.eventTable().pricing(id);
+        std::string prices;
+        for (uint32_t s = 0; s < pricing.sectionCount(); ++s) {
+            const std::string& section = seats.sectionList()[s].name;
+            prices += (section.empty() ? "" : section + " ") + tr(Msg::Price, {formatPrice(pricing.price(s))}) + "  ";
+        }
+        screen.line(Msg::EventPrices, {prices}, MAGENTA);
+        screen.blank();
+    }
+
+    // Petit catalogue : tout est affiché ; sinon l'utilisateur choisit des dates et un lieu
+    void displayEvents() {
+        std::vector<EventTable::EventId> shown;
+        if (engine.eventTable().size() <= 20) {
+            shown = engine.eventTable().between(INT_MIN, INT_MAX);
+        } else {
+            std::string from, to, venue;
+            screen.prompt(Msg::FromPrompt);
+            std::getline(std::cin >> std::ws, from);
+            screen.prompt(Msg::ToPrompt);
+            std::getline(std::cin >> std::ws, to);
+            screen.prompt(Msg::VenuePrompt);
+            std::getline(std::cin >> std::ws, venue);
+
+            int fromDay, toDay;
+            if (!parseDate(from, fromDay) || !parseDate(to, toDay)) {
+                throw std::invalid_argument(std::string(tr(Msg::InvalidDate)));
+            }
+            const int venueId = venue == "*" ? -1 : engine.eventTable().findVenue(venue);
+            if (venue != "*" && venueId < 0) {
+                throw std::invalid_argument(std::string(tr(Msg::UnknownVenue)));
+            }
+            shown = engine.eventTable().between(fromDay, toDay, venueId);
         }
+
+        screen.line(Msg::EventsTitle, MAGENTA);
+        for (EventTable::EventId id : shown) displayEvent(id);
     }
 
     void makeReservation() {
         displayEvents();
         int choice;
-        std::cout << (currentLang == FRENCH ? "Choisissez un événement (numéro): " : "Choose an event (number): ");
+        screen.prompt(Msg::ChooseEventPrompt);
         std::cin >> choice;
         std::cin.ignore();
 
-        if (choice < 1 || choice > static_cast<int>(eventList.size())) {
-            throw std::invalid_argument(currentLang == FRENCH ? "Choix invalide!" : "Invalid choice!");
+        if (!std::cin || choice < 1 || choice > static_cast<int>(engine.eventTable().size())) {
+            std::cin.clear();
+            check(BookingStatus::UnknownEvent);
         }
 
-        Event& selected = eventList[choice - 1];
+        const EventTable::EventId eventId = static_cast<EventTable::EventId>(choice - 1);
         std::string name;
-        std::cout << (currentLang == FRENCH ? "Nom du client : " : "Client name: ");
+        screen.prompt(Msg::ClientNamePrompt);
         std::getline(std::cin, name);
 
-        if (selected.availableSeats.empty()) {
-            printCentered(currentLang == FRENCH ? "Aucune place disponible." : "No seats available.", 80, RED);
+        if (engine.freeCount(eventId) == 0) {
+            screen.line(statusMessage(BookingStatus::SoldOut), RED);
+            offerWaitlist(eventId, name, 0);
             return;
         }
 
-        printCentered(currentLang == FRENCH ? "Places disponibles:" : "Available seats:", 80, GREEN);
-        for (size_t i = 0; i < selected.availableSeats.size(); ++i) {
-            std::cout << "[" << i + 1 << "] " << selected.availableSeats[i] << "  ";
+        screen.prompt(Msg::SeatRequestPrompt);
+        std::string request;
+        std::getline(std::cin >> std::ws, request);
+
+        // Les places sont retenues le temps de la confirmation
+        int holdNumber;
+        const BookingStatus status = engine.hold(eventId, name, request, nowSecs(), &holdNumber);
+        if (status == BookingStatus::NotEnoughSeats || status == BookingStatus::SoldOut) {
+            // Demande de places côte à côte impossible pour l'instant : la liste d'attente
+            screen.line(statusMessage(status), RED);
+            offerWaitlist(eventId, name, static_cast<uint32_t>(std::stoul(request)));
+            return;
         }
-        std::cout << std::endl;
+        // Demande de 0 place : le message de InvalidRequest est celui des listes d'attente
+        check(status == BookingStatus::InvalidRequest ? BookingStatus::InvalidSeat : status);
+        commit();
+        const SeatHold* hold = engine.holdTable().find(holdNumber);
+        Cents total = 0;
+        for (Cents price : hold->prices) total += price;
+        screen.line(Msg::HeldUntil, {formatTime(hold->expiresAt), std::to_string(holdNumber)}, YELLOW);
+        screen.line(Msg::HoldTotal, {formatPrice(total)}, YELLOW);
+
+        screen.prompt(Msg::ConfirmNowPrompt);
+        std::string answer;
+        std::getline(std::cin >> std::ws, answer);
+        if (isYes(answer)) {
+            confirmHold(holdNumber);
+        } else {
+            screen.line(Msg::ConfirmLater, YELLOW);
+        }
+    }
 
-        int seatChoice;
-        std::cout << (currentLang == FRENCH ? "Choisissez une place (numéro) : " : "Choose a seat (number): ");
-        std::cin >> seatChoice;
-        std::cin.ignore();
+    void expireHolds() {
+        engine.expireHolds(nowSecs());
+        commit();
+    }
 
-        if (seatChoice < 1 || seatChoice > static_cast<int>(selected.availableSeats.size())) {
-            throw std::invalid_argument(currentLang == FRENCH ? "Place invalide!" : "Invalid seat!");
+    void confirmHold(int number) {
+        std::vector<int> numbers;
+        check(engine.confirm(number, nowSecs(), &numbers));
+        commit();
+        for (int n : numbers) {
+            const Reservation* r = engine.reservationTable().findByNumber(n);
+            screen.line(Msg::ReservationLine, {r->seatNumber, std::to_string(n), formatPrice(r->price)}, GREEN);
         }
+        screen.line(Msg::ReservationConfirmed, GREEN);
+    }
 
-        std::string seat = selected.availableSeats[seatChoice - 1];
-        ReservationNode* newNode = new ReservationNode(selected.name, name, selected.date, seat);
-        newNode->next = head;
-        head = newNode;
-        selected.availableSeats.erase(selected.availableSeats.begin() + seatChoice - 1);
+    void confirmReservation() {
+        screen.prompt(Msg::HoldNumberPrompt);
+        int number;
+        std::cin >> number;
+        std::cin.ignore();
+        if (!std::cin) {
+            std::cin.clear();
+            check(BookingStatus::UnknownHold);
+        }
+        confirmHold(number);
+    }
 
-        printCentered(currentLang == FRENCH ? "Réservation confirmée!" : "Reservation confirmed!", 80, GREEN);
+    void printReservation(const Reservation& r) {
+        screen.line("#" + std::to_string(r.reservationNumber) + "  " + r.clientName + "  " + r.eventName
+                    + "  " + r.date + "  " + r.seatNumber + "  " + tr(Msg::Price, {formatPrice(r.price)}), CYAN);
     }
 
-    void saveToFile() {
-        std::ofstream out(DATA_FILE);
-        if (!out) {
-            std::cerr << "Erreur de sauvegarde." << std::endl;
-            return;
+    void searchReservations() {
+        screen.prompt(Msg::SearchPrompt);
+        std::string query;
+        std::getline(std::cin >> std::ws, query);
+
+        std::vector<const Reservation*> found;
+        if (!query.empty() && query.find_first_not_of("0123456789") == std::string::npos) {
+            if (const Reservation* r = engine.reservationTable().findByNumber(std::stoi(query))) found.push_back(r);
+        } else {
+            found = engine.reservationTable().findByClient(query);
+            if (found.empty()) found = engine.reservationTable().findByEvent(query);
         }
 
-        ReservationNode* curr = head;
-        while (curr) {
-            out << curr->toFileString() << std::endl;
-            curr = curr->next;
+        if (found.empty()) {
+            screen.line(Msg::NoReservationFound, RED);
+            return;
         }
+        for (const Reservation* r : found) printReservation(*r);
     }
 
-    void loadFromFile() {
-        std::ifstream in(DATA_FILE);
-        if (!in) return;
-
-        std::string line;
-        while (std::getline(in, line)) {
-            std::stringstream ss(line);
-            std::string token;
-            std::vector<std::string> parts;
-            while (std::getline(ss, token, '|')) {
-                parts.push_back(token);
-            }
-            if (parts.size() == 5) {
-                ReservationNode* node = new ReservationNode(parts[1], parts[2], parts[3], parts[4]);
-                node->reservationNumber = std::stoi(parts[0]);
-                node->next = head;
-                head = node;
-                if (node->reservationNumber >= ReservationNode::nextReservationNumber) {
-                    ReservationNode::nextReservationNumber = node->reservationNumber + 1;
-                }
-            }
+    void cancelReservation() {
+        screen.prompt(Msg::CancelPrompt);
+        int number;
+        std::cin >> number;
+        std::cin.ignore();
+        if (!std::cin) {
+            std::cin.clear();
+            check(BookingStatus::UnknownReservation);
         }
+        check(engine.cancel(number));
+        commit();
+        screen.line(Msg::ReservationCancelled, GREEN);
     }
 };
 
 void displayWelcome() {
     clearScreen();
-    printCentered("=== SYSTEME DE RESERVATION ===", 80, CYAN);
+    screen.line("=== SYSTEME DE RESERVATION ===", CYAN);
     loadingAnimation();
 }
 
+// Une ligne par langue du catalogue, chacune dans sa propre langue
 void languageMenu() {
     clearScreen();
-    printCentered("1. Français", 80, YELLOW);
-    printCentered("2. English", 80, YELLOW);
-    std::cout << "Choisissez votre langue / Choose your language: ";
+    for (int lang = 0; lang < kLanguageCount; ++lang) {
+        screen.line(std::to_string(lang + 1) + ". " + std::string(message(Language(lang), Msg::LanguageName)), YELLOW);
+    }
+    screen.prompt("Choisissez votre langue / Choose your language / Elija su idioma: ");
     int lang;
     std::cin >> lang;
-    currentLang = (lang == 2) ? ENGLISH : FRENCH;
+    currentLang = (lang >= 1 && lang <= kLanguageCount) ? Language(lang - 1) : FRENCH;
 }
 
+// Le menu et sa question forment un seul écran, écrit d'un bloc
 void mainMenu() {
-    printCentered(currentLang == FRENCH ? "=== MENU PRINCIPAL ===" : "=== MAIN MENU ===", 80, MAGENTA);
-    printCentered(currentLang == FRENCH ? "[1] Voir les événements" : "[1] View events", 80, BLUE);
-    printCentered(currentLang == FRENCH ? "[2] Langue" : "[2] Language", 80, BLUE);
-    printCentered(currentLang == FRENCH ? "[3] Quitter" : "[3] Exit", 80, RED);
+    screen.line(Msg::MenuTitle, MAGENTA);
+    for (Msg item : {Msg::MenuEvents, Msg::MenuFind, Msg::MenuCancel, Msg::MenuConfirm, Msg::MenuLeaveWait,
+                     Msg::MenuLanguage}) {
+        screen.line(item, BLUE);
+    }
+    screen.line(Msg::MenuExit, RED);
+    screen.prompt(Msg::ChoicePrompt);
+}
+
+// --stress [threads] : des acheteurs concurrents se disputent les mêmes places, puis vident
+// un stade de 60 000 places pendant qu'un lecteur demande les prix sans arrêt ; vérifie
+// qu'aucune place n'est vendue deux fois et que chaque prix lu est cohérent
+int runStressTest(unsigned threadCount) {
+    auto buildStadium = [](SeatMap& seats) {
+        for (const char* stand : {"Nord", "Sud", "Est", "Ouest"}) seats.addSection(stand, 50, 300);
+    };
+    // Vérifie les ventes de tous les threads : chaque place et chaque numéro une seule fois
+    auto check = [](const SeatMap& seats, const std::vector<std::vector<Booking>>& sold, size_t expected) {
+        std::vector<bool> seatSeen(seats.capacity(), false);
+        std::vector<bool> numberSeen(seats.capacity() + 1, false);
+        size_t total = 0;
+        for (const std::vector<Booking>& bookings : sold) {
+            for (const Booking& b : bookings) {
+                const size_t index = (size_t(b.seat.section) * 50 + b.seat.row) * 300 + b.seat.number;
+                const size_t number = size_t(b.reservationNumber);
+                if (seatSeen[index] || number >= numberSeen.size() || numberSeen[number]) return false;
+                seatSeen[index] = true;
+                numberSeen[number] = true;
+                ++total;
+            }
+        }
+        return total == expected;
+    };
+    auto runThreads = [threadCount](auto body) {
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; ++t) threads.emplace_back(body, t);
+        for (std::thread& th : threads) th.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    bool ok = true;
+
+    // 1. Tous les threads tentent les 1 000 mêmes places, dans le même ordre
+    {
+        SeatMap seats;
+        buildStadium(seats);
+        ReservationTable table;
+        std::vector<std::vector<Booking>> sold(threadCount);
+        const double seconds = runThreads([&](unsigned t) {
+            for (uint32_t i = 0; i < 1000; ++i) bookSeat(seats, table, SeatId{0, i / 300, i % 300}, sold[t]);
+        });
+        const bool valid = check(seats, sold, 1000) && seats.freeCount() == seats.capacity() - 1000;
+        ok = ok && valid;
+        std::cout << "places disputées    : " << threadCount << " threads x 1000 tentatives sur les mêmes places, "
+                  << (valid ? "1000 vendues une seule fois" : "ERREUR : double vente") << " ("
+                  << static_cast<long>(threadCount * 1000 / seconds) << " tentatives/s)" << std::endl;
+    }
+
+    // 2. Les threads vident le stade par groupes de 1 à 4 places côte à côte ; un thread de
+    // plus lit les prix en continu : ils ne doivent jamais baisser ni sortir des paliers
+    {
+        SeatMap seats;
+        buildStadium(seats);
+        SectionPricing pricing(seats, {4500, 4500, 3000, 3000});
+        ReservationTable table;
+        std::vector<std::vector<Booking>> sold(threadCount);
+        std::atomic<size_t> requests{0};
+        std::atomic<bool> selling{true};
+        size_t quotes = 0;
+        bool quotesValid = true;
+        std::thread reader([&] {
+            std::vector<Cents> last(pricing.sectionCount(), 0);
+            while (selling.load(std::memory_order_acquire)) {
+                for (uint32_t s = 0; s < pricing.sectionCount(); ++s) {
+                    const Cents price = pricing.price(s);
+                    bool isTier = false;
+                    for (const PriceTier& tier : kPriceTiers) isTier = isTier || price == pricing.basePrice(s) * tier.percent / 100;
+                    quotesValid = quotesValid && isTier && price >= last[s];
+                    last[s] = price;
+                    ++quotes;
+                }
+            }
+        });
+        const double seconds = runThreads([&](unsigned t) {
+            std::mt19937 rng(t + 1);
+            uint32_t startRow = static_cast<uint32_t>(t * seats.rowCount() / threadCount);
+            size_t local = 0;
+            for (uint32_t count = 1 + rng() % 4; ; count = 1 + rng() % 4) {
+                ++local;
+                if (!bookAdjacent(seats, table, count, startRow, sold[t], &pricing)) {
+                    // Plus de groupe de cette taille : on finit place par place
+                    while (bookAdjacent(seats, table, 1, startRow, sold[t], &pricing)) ++local;
+                    break;
+                }
+            }
+            requests += local;
+        });
+        selling.store(false, std::memory_order_release);
+        reader.join();
+        size_t bookings = 0;
+        Cents revenue = 0;
+        for (const std::vector<Booking>& b : sold) {
+            bookings += b.size();
+            for (const Booking& booking : b) revenue += booking.price;
+        }
+        bool valid = check(seats, sold, seats.capacity()) && seats.freeCount() == 0;
+        for (uint32_t s = 0; s < pricing.sectionCount(); ++s) {
+            valid = valid && pricing.takenCount(s) == 15000 && pricing.price(s) == pricing.basePrice(s) * 3 / 2;
+        }
+        for (unsigned t = 0; t < threadCount; ++t) commitBookings(table, seats, sold[t], "Stress", "Client", "01/01/2024");
+        valid = valid && table.size() == seats.capacity() && quotesValid;
+        ok = ok && valid;
+        std::cout << "stade vidé          : " << bookings << " places en " << static_cast<long>(seconds * 1000)
+                  << " ms, " << static_cast<long>(requests / seconds) << " achats/s, "
+                  << static_cast<long>(bookings / seconds) << " places/s, "
+                  << (valid ? "aucune double vente" : "ERREUR : double vente, place perdue ou prix incohérent") << std::endl;
+        std::cout << "prix dynamiques     : " << quotes << " devis lus pendant la vente, recette "
+                  << formatPrice(revenue) << " EUR" << std::endl;
+    }
+    return ok ? 0 : 1;
 }
 
-int main() {
+// --churn [attentes] : un événement complet, une longue liste d'attente, puis des annulations
+// au hasard dont chaque place repart aussitôt vers l'attente ; mesure le coût d'une annulation
+// avec sa réattribution et vérifie qu'aucune place n'est perdue ni vendue deux fois
+int runChurnTest(size_t waiters) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / ("churn-" + std::to_string(std::time(nullptr)));
+    fs::create_directories(dir);
+    EngineConfig config;
+    config.eventsFile = (dir / "evenements.txt").string();
+    config.dataFile = (dir / "reservations.log").string();
+    config.legacyDataFile = (dir / "reservations.txt").string();
+    config.layoutFile = (dir / "reservations.shards").string();
+    std::ofstream(config.eventsFile) << "Churn|01/01/2030|Arena|Salle=20x500\n";
+
+    bool ok = true;
+    {
+        ReservationEngine engine(config);
+        const ReservationEngine::EventId event = 0;
+        const size_t capacity = engine.eventTable().seats(event).capacity();
+        std::mt19937 rng(42);
+        std::vector<int> sold;
+        while (engine.book(event, "Client", std::to_string(1 + rng() % 4), &sold) == BookingStatus::Ok) {}
+        while (engine.book(event, "Client", "1", &sold) == BookingStatus::Ok) {}
+        for (size_t i = 0; i < waiters; ++i) {
+            engine.joinWaitlist(event, "Attente", 1 + rng() % 4, static_cast<int>(rng() % 10));
+        }
+        engine.commit();
+
+        const size_t rounds = 200000;
+        std::vector<double> latencies;
+        latencies.reserve(rounds);
+        size_t served = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds && !sold.empty(); ++i) {
+            const size_t pick = rng() % sold.size();
+            const int number = sold[pick];
+            sold[pick] = sold.back();
+            sold.pop_back();
+            const auto t0 = std::chrono::steady_clock::now();
+            engine.cancel(number);
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+            // Un nouvel inscrit remplace chaque attente servie : la liste garde sa longueur. Il peut
+            // être servi aussitôt, d'où la boucle jusqu'à ce qu'il n'y ait plus d'attribution.
+            for (auto batch = engine.takeAllocations(); !batch.empty(); batch = engine.takeAllocations()) {
+                for (const ReservationEngine::WaitAllocation& a : batch) {
+                    sold.insert(sold.end(), a.reservations.begin(), a.reservations.end());
+                    ++served;
+                    engine.joinWaitlist(event, "Attente", 1 + rng() % 4, static_cast<int>(rng() % 10));
+                }
+            }
+            if (i % 1000 == 999) engine.commit();
+        }
+        engine.commit();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) { return latencies.empty() ? 0.0 : latencies[size_t(p * (latencies.size() - 1))]; };
+        ok = sold.size() == engine.reservationTable().size() &&
+             sold.size() + engine.freeCount(event) == capacity &&
+             engine.eventTable().seats(event).freeCount() == engine.freeCount(event);
+        std::cout << "liste d'attente     : " << capacity << " places, " << engine.waitTable().size() << " attentes, "
+                  << latencies.size() << " annulations en " << static_cast<long>(seconds * 1000) << " ms ("
+                  << static_cast<long>(latencies.size() / seconds) << "/s), " << served << " attentes servies"
+                  << std::endl;
+        std::cout << "annulation + réattribution : p50 " << percentile(0.5) << " us, p99 " << percentile(0.99)
+                  << " us, max " << (latencies.empty() ? 0.0 : latencies.back()) << " us, "
+                  << (ok ? "aucune place perdue ni vendue deux fois" : "ERREUR : places incohérentes") << std::endl;
+    }
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--stress") {
+        unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+        return runStressTest(threads > 0 ? threads : 4);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--churn") {
+        const long waiters = argc > 2 ? std::atol(argv[2]) : 100000;
+        return runChurnTest(waiters > 0 ? static_cast<size_t>(waiters) : 100000);
+    }
+
+    // --batch [fichier] [--shards N] : commandes sur l'entrée standard (ou dans le fichier),
+    // réponses sur la sortie ; avec --shards, les événements sont répartis sur N cœurs
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        const char* path = nullptr;
+        unsigned shardCount = 1;
+        for (int i = 2; i < argc; ++i) {
+            if (std::string(argv[i]) == "--shards" && i + 1 < argc) {
+                shardCount = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+            } else {
+                path = argv[i];
+            }
+        }
+        unsigned recorded = 0;
+        if (!ReservationShards::checkLayout(EngineConfig(), shardCount, &recorded)) {
+            std::cerr << "Données écrites avec " << recorded << " shard(s) : relancer "
+                      << (recorded > 1 ? "avec --shards " + std::to_string(recorded) : "sans --shards") << std::endl;
+            return 1;
+        }
+        std::FILE* in = path ? std::fopen(path, "rb") : stdin;
+        if (!in) {
+            std::cerr << "Impossible d'ouvrir " << path << std::endl;
+            return 1;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        BatchStats stats;
+        if (shardCount > 1) {
+            ReservationShards shards(EngineConfig(), shardCount);
+            ShardedBatchSession session(shards);
+            stats = session.run(in, stdout);
+        } else {
+            ReservationEngine engine;
+            BatchSession session(engine);
+            stats = session.run(in, stdout);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (in != stdin) std::fclose(in);
+        std::cerr << stats.commands << " commandes (" << stats.failures << " refusées) en "
+                  << static_cast<long>(seconds * 1000) << " ms, "
+                  << static_cast<long>(stats.commands / (seconds > 0 ? seconds : 1e-9)) << " commandes/s" << std::endl;
+        return 0;
+    }
+
     displayWelcome();
     languageMenu();
 
+    // Le menu n'ouvre que le moteur non découpé : des données écrites en shards y seraient ignorées
+    unsigned recorded = 0;
+    if (!ReservationShards::checkLayout(EngineConfig(), 1, &recorded)) {
+        screen.line(Msg::ShardedData, {std::to_string(recorded), std::to_string(recorded)}, RED);
+        screen.flush();
+        return 1;
+    }
+
     ReservationSystem system;
     int choice;
 
     do {
         mainMenu();
-        std::cout << (currentLang == FRENCH ? "Votre choix : " : "Your choice: ");
-        std::cin >> choice;
+        if (!(std::cin >> choice)) {
+            if (std::cin.eof()) break; // Fin de l'entrée : on quitte comme avec [7]
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            choice = 0;
+        }
 
         try {
+            system.expireHolds();
             switch (choice) {
                 case 1:
                     system.makeReservation();
                     break;
                 case 2:
-                    languageMenu();
+                    system.searchReservations();
                     break;
                 case 3:
-                    printCentered(currentLang == FRENCH ? "Merci et à bientôt !" : "Thank you and goodbye!", 80, CYAN);
+                    system.cancelReservation();
+                    break;
+                case 4:
+                    system.confirmReservation();
+                    break;
+                case 5:
+                    system.leaveWaitlist();
+                    break;
+                case 6:
+                    languageMenu();
+                    break;
+                case 7:
+                    screen.line(Msg::Goodbye, CYAN);
                     break;
                 default:
-                    printCentered(currentLang == FRENCH ? "Choix invalide." : "Invalid choice.", 80, RED);
+                    screen.line(Msg::InvalidChoice, RED);
             }
         } catch (const std::exception& e) {
-            printCentered(e.what(), 80, RED);
+            screen.line(e.what(), RED);
         }
 
-    } while (choice != 3);
+    } while (choice != 7);
+    screen.flush();
 
     return 0;
 }
@@ -0,0 +1,159 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Roue de temporisation hiérarchique (comme celle du noyau Linux) : 4 niveaux de 64 cases.
+// Le niveau 0 couvre les 64 prochains ticks, le niveau 1 les 64 x 64 suivants, etc.
+// (16,7 millions de ticks au total, 194 jours avec un tick d'une seconde).
+// Ajout et annulation en O(1) ; à chaque tick, seule la case courante du niveau 0 est vidée,
+// et une case d'un niveau supérieur n'est redistribuée vers le bas que tous les 64 ticks
+// de son niveau inférieur : O(1) amorti par échéance, quel que soit le nombre de minuteries.
+//
+// Les entrées vivent dans un pool et sont chaînées dans leur case par indices ; un Handle
+// porte une génération pour qu'une annulation tardive ne touche pas une case réutilisée.
+template <typename T>
+class TimerWheel {
+public:
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    explicit TimerWheel(uint64_t startTick = 0) : now(startTick) {
+        for (auto& level : slots) {
+            for (uint32_t& head : level) head = kNil;
+        }
+    }
+
+    uint64_t currentTick() const { return now; }
+    size_t size() const { return count; }
+
+    // Échéance au tick expiresAt (au plus tôt au prochain tick)
+    Handle add(uint64_t expiresAt, const T& value) {
+        uint32_t index;
+        if (!freeEntries.empty()) {
+            index = freeEntries.back();
+            freeEntries.pop_back();
+        } else {
+            index = static_cast<uint32_t>(entries.size());
+            entries.emplace_back();
+        }
+        Entry& e = entries[index];
+        e.expires = expiresAt > now ? expiresAt : now + 1;
+        e.value = value;
+        e.used = true;
+        link(index);
+        ++count;
+        return Handle{index, e.generation};
+    }
+
+    bool cancel(const Handle& h) {
+        if (h.index >= entries.size() || !entries[h.index].used || entries[h.index].generation != h.generation) {
+            return false;
+        }
+        unlink(h.index);
+        release(h.index);
+        return true;
+    }
+
+    // Avance jusqu'au tick target ; onExpire(value) est appelé pour chaque échéance atteinte
+    template <typename F>
+    void advance(uint64_t target, F onExpire) {
+        while (now < target) {
+            if (count == 0) {
+                now = target; // Rien en attente : inutile de parcourir les ticks
+                return;
+            }
+            ++now;
+            // Début d'un bloc de 64 ticks : la case correspondante du niveau 1 descend d'un
+            // niveau, et ainsi de suite tant que le niveau du dessous recommence aussi un tour
+            for (int level = 1; level < kLevels && (now & ((uint64_t(1) << (kBits * level)) - 1)) == 0; ++level) {
+                cascade(level);
+            }
+            uint32_t& head = slots[0][now & kMask];
+            while (head != kNil) {
+                const uint32_t index = head;
+                unlink(index);
+                const T value = entries[index].value;
+                release(index);
+                onExpire(value);
+            }
+        }
+    }
+
+private:
+    static constexpr int kBits = 6;
+    static constexpr int kLevels = 4;
+    static constexpr uint32_t kMask = (1u << kBits) - 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Entry {
+        uint64_t expires = 0;
+        T value{};
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 0;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool used = false;
+    };
+
+    uint64_t now;
+    uint32_t slots[kLevels][1u << kBits];
+    std::vector<Entry> entries;
+    std::vector<uint32_t> freeEntries;
+    size_t count = 0;
+
+    void link(uint32_t index) {
+        Entry& e = entries[index];
+        const uint64_t delta = e.expires - now;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (uint64_t(1) << (kBits * (level + 1)))) ++level;
+        // Au-delà de la portée de la roue, l'entrée attend dans la dernière case atteignable
+        const uint64_t at = level == kLevels - 1 && delta >= (uint64_t(1) << (kBits * kLevels))
+                                ? now + (uint64_t(1) << (kBits * kLevels)) - 1
+                                : e.expires;
+        e.level = static_cast<uint8_t>(level);
+        e.slot = static_cast<uint8_t>((at >> (kBits * level)) & kMask);
+        uint32_t& head = slots[level][e.slot];
+        e.prev = kNil;
+        e.next = head;
+        if (head != kNil) entries[head].prev = index;
+        head = index;
+    }
+
+    void unlink(uint32_t index) {
+        Entry& e = entries[index];
+        if (e.prev != kNil) {
+            entries[e.prev].next = e.next;
+        } else {
+            slots[e.level][e.slot] = e.next;
+        }
+        if (e.next != kNil) entries[e.next].prev = e.prev;
+    }
+
+    void release(uint32_t index) {
+        Entry& e = entries[index];
+        e.used = false;
+        e.value = T{};
+        ++e.generation;
+        freeEntries.push_back(index);
+        --count;
+    }
+
+    // Redistribue la case courante d'un niveau dans les niveaux inférieurs
+    void cascade(int level) {
+        uint32_t index = slots[level][(now >> (kBits * level)) & kMask];
+        slots[level][(now >> (kBits * level)) & kMask] = kNil;
+        while (index != kNil) {
+            const uint32_t next = entries[index].next;
+            link(index);
+            index = next;
+        }
+    }
+};
+
+#endif // TIMER_WHEEL_H
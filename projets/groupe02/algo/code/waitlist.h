@@ -0,0 +1,114 @@
+#ifndef WAITLIST_H
+#define WAITLIST_H
+
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Listes d'attente des événements complets. Une attente demande de 1 à kMaxSeats places côte
+// à côte ; les attentes passent par priorité décroissante puis par ordre d'inscription.
+//
+// Chaque événement a un tas par nombre de places demandé : quand des places se libèrent, seuls
+// les sommets des tas dont la demande tient dans les places libres sont comparés, et une
+// attribution coûte O(log n). Une attente retirée (remove) reste dans son tas, marquée morte,
+// et n'en sort que lorsqu'elle arrive au sommet.
+class Waitlist {
+public:
+    static constexpr uint32_t kMaxSeats = 8;
+
+    struct Entry {
+        int number = 0;
+        uint32_t event = 0;
+        std::string client;
+        uint32_t seats = 1;
+        int priority = 0;
+    };
+
+    // number = 0 : nouveau numéro ; sinon numéro relu depuis le journal. Les numéros croissent
+    // avec l'inscription : ils servent aussi d'ordre d'arrivée.
+    const Entry& add(uint32_t event, const std::string& client, uint32_t seats, int priority, int number = 0) {
+        if (number == 0) number = nextNumber;
+        if (number >= nextNumber) nextNumber = number + 1;
+        Entry& e = entries[number];
+        e = Entry{number, event, client, seats, priority};
+        queues[event].bySeats[seats - 1].push(Key{priority, number});
+        return e;
+    }
+
+    bool remove(int number) {
+        return entries.erase(number) > 0;
+    }
+
+    const Entry* find(int number) const {
+        auto it = entries.find(number);
+        return it == entries.end() ? nullptr : &it->second;
+    }
+
+    size_t size() const { return entries.size(); }
+
+    bool hasWaiting(uint32_t event) const { return queues.count(event) > 0; }
+
+    // Attribue des places tant qu'il y en a : tryAllocate(const Entry&) prend les places de
+    // l'attente (true) ou ne trouve pas assez de places côte à côte (false, cette taille de
+    // demande est alors écartée jusqu'au prochain appel). freeSeats(void) donne les places libres.
+    // Une attente servie est retirée de la liste.
+    template <typename Free, typename F>
+    void allocate(uint32_t event, Free freeSeats, F tryAllocate) {
+        auto it = queues.find(event);
+        if (it == queues.end()) return;
+        EventQueues& q = it->second;
+        bool blocked[kMaxSeats] = {};
+        while (true) {
+            const uint32_t available = freeSeats();
+            int best = -1;
+            for (uint32_t s = 0; s < kMaxSeats && s < available; ++s) {
+                if (blocked[s] || !dropDead(q.bySeats[s])) continue;
+                if (best < 0 || q.bySeats[best].top() < q.bySeats[s].top()) best = static_cast<int>(s);
+            }
+            if (best < 0) break;
+            const int number = q.bySeats[best].top().number;
+            if (tryAllocate(static_cast<const Entry&>(entries[number]))) {
+                q.bySeats[best].pop();
+                entries.erase(number);
+            } else {
+                blocked[best] = true;
+            }
+        }
+        bool empty = true;
+        for (auto& heap : q.bySeats) empty = empty && !dropDead(heap);
+        if (empty) queues.erase(it);
+    }
+
+    template <typename F>
+    void forEach(F f) const {
+        for (const auto& entry : entries) f(entry.second);
+    }
+
+private:
+    // Ordre du tas : le sommet est la plus forte priorité, puis le plus petit numéro
+    struct Key {
+        int priority;
+        int number;
+        bool operator<(const Key& o) const {
+            return priority != o.priority ? priority < o.priority : number > o.number;
+        }
+    };
+
+    struct EventQueues {
+        std::priority_queue<Key> bySeats[kMaxSeats];
+    };
+
+    std::unordered_map<int, Entry> entries;
+    std::unordered_map<uint32_t, EventQueues> queues;
+    int nextNumber = 1;
+
+    // Retire du sommet les attentes mortes ; false si le tas est vide
+    bool dropDead(std::priority_queue<Key>& heap) const {
+        while (!heap.empty() && entries.count(heap.top().number) == 0) heap.pop();
+        return !heap.empty();
+    }
+};
+
+#endif // WAITLIST_H
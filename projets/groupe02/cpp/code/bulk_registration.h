@@ -0,0 +1,368 @@
+#ifndef BULK_REGISTRATION_H
+#define BULK_REGISTRATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "prerequisite_graph.h"
+
+// Issue d'une UE demandée, dans l'ordre des vérifications
+enum class RequestStatus : uint8_t { Registered, UnknownCourse, Duplicate, Prerequisites, Credits, Full, Count };
+
+inline const char* statusLabel(RequestStatus status) {
+    switch (status) {
+        case RequestStatus::Registered: return "inscrit";
+        case RequestStatus::UnknownCourse: return "inconnue";
+        case RequestStatus::Duplicate: return "doublon";
+        case RequestStatus::Prerequisites: return "prerequis";
+        case RequestStatus::Credits: return "credits";
+        case RequestStatus::Full: return "complet";
+        case RequestStatus::Count: break;
+    }
+    return "";
+}
+
+// Exécute body(i) pour i dans [0, n) sur threads threads, par tranches distribuées à la demande
+template <typename Body>
+void parallelFor(size_t n, unsigned threads, Body body) {
+    const size_t chunk = 256;
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t start = next.fetch_add(chunk); start < n; start = next.fetch_add(chunk)) {
+            for (size_t i = start; i < std::min(n, start + chunk); ++i) body(i);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread& th : pool) th.join();
+}
+
+// Inscriptions en masse : toute une promotion, à l'ouverture des inscriptions.
+//
+//   1. lecture   : le fichier de demandes, une ligne "étudiant,UE1;UE2;..." par étudiant, en
+//                  tableaux compacts (identifiants d'UE bout à bout, un décalage par étudiant)
+//   2. historique: les UE validées de chaque étudiant (students/<id>.txt), en parallèle
+//   3. validation: en parallèle par étudiant, chaque UE dans l'ordre de la demande : prérequis
+//                  (ET de mots avec la fermeture), plafond de crédits, puis une place prise par
+//                  fetch_add sur le compteur atomique de l'UE, rendue si l'UE est pleine
+//   4. attribution: pour les modes équitables seulement (voir Allocation)
+//   5. écriture  : tous les résultats dans un seul fichier, en une passe
+//
+// En mode FirstCome, quand une UE est trop demandée, les places vont aux premiers threads
+// arrivés : l'ordre entre étudiants n'est pas garanti, seule la capacité l'est. Les modes
+// Lottery et Stable lisent chaque demande comme une liste de voeux classés : la validation
+// ne fait plus que les contrôles propres à chaque étudiant, puis les places sont attribuées
+// d'après un tirage au sort (un rang par étudiant, le même pour toutes les UE). En mode
+// Stable, chaque UE classe d'abord ses candidats selon les UE qu'elle leur ouvrirait ; le
+// tirage ne départage que les ex aequo.
+class BulkRegistration {
+public:
+    enum class Allocation {
+        FirstCome,   // Premier arrivé, premier servi, en parallèle
+        Lottery,     // Dictature sérielle aléatoire : chaque étudiant, dans l'ordre du tirage, prend
+                     // ses voeux dans l'ordre tant qu'il reste des places et des crédits
+        Stable       // Acceptation différée, les étudiants proposent : une UE pleine garde les
+                     // mieux classés selon sa propre priorité (voir unlocks) et renvoie les
+                     // autres vers leurs voeux suivants
+    };
+
+    struct Report {
+        size_t students = 0;
+        size_t requests = 0;
+        size_t byStatus[static_cast<size_t>(RequestStatus::Count)] = {};
+        double ingestSeconds = 0, historySeconds = 0, validateSeconds = 0, allocateSeconds = 0, writeSeconds = 0;
+        bool ok = false;
+    };
+
+    // credits[id] : crédits de l'UE (-1 si l'identifiant n'est pas une UE du catalogue) ;
+    // capacity[id] : places de l'UE (0 : sans limite)
+    BulkRegistration(const PrerequisiteGraph& graph, std::vector<int> credits, std::vector<int> capacity,
+                     int maxCredits = 30)
+        : graph(graph), credits(std::move(credits)), capacity(std::move(capacity)), maxCredits(maxCredits) {}
+
+    // seed : graine du tirage au sort des modes Lottery et Stable
+    Report run(const std::string& requestsPath, const std::string& historyDir, const std::string& outputPath,
+               unsigned threads, Allocation mode = Allocation::FirstCome, uint32_t seed = 1) {
+        Report report;
+        threads = std::max(1u, threads);
+        auto elapsed = [](std::chrono::steady_clock::time_point since) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        if (!ingest(requestsPath)) return report;
+        report.ingestSeconds = elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        loadHistories(historyDir, threads);
+        report.historySeconds = elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        validate(threads, mode);
+        report.validateSeconds = elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        if (mode != Allocation::FirstCome) allocate(mode, seed);
+        report.allocateSeconds = elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        report.ok = write(outputPath);
+        report.writeSeconds = elapsed(start);
+
+        report.students = students.size();
+        report.requests = requested.size();
+        for (RequestStatus s : status) ++report.byStatus[static_cast<size_t>(s)];
+        return report;
+    }
+
+    // Places prises dans l'UE à l'issue de la validation
+    int taken(PrerequisiteGraph::CourseId id) const { return takenSeats[id].load(std::memory_order_relaxed); }
+
+private:
+    const PrerequisiteGraph& graph;
+    std::vector<int> credits;
+    std::vector<int> capacity;
+    int maxCredits;
+
+    std::vector<std::string> students;
+    std::vector<uint32_t> firstRequest;                 // Demandes de l'étudiant s : [firstRequest[s], firstRequest[s + 1])
+    std::vector<PrerequisiteGraph::CourseId> requested;
+    std::unordered_map<uint32_t, std::string> unknownCodes;   // Demande -> code hors catalogue
+    std::vector<RequestStatus> status;
+    std::vector<uint64_t> completed;                    // Ligne s : UE validées par l'étudiant s
+    std::unique_ptr<std::atomic<int>[]> takenSeats;
+
+    bool ingest(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) return false;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            const size_t comma = line.find(',');
+            if (line.empty() || comma == std::string::npos) continue;
+            students.push_back(line.substr(0, comma));
+            firstRequest.push_back(static_cast<uint32_t>(requested.size()));
+            for (size_t start = comma + 1; start <= line.size();) {
+                size_t end = line.find(';', start);
+                if (end == std::string::npos) end = line.size();
+                if (end > start) {
+                    const std::string code = line.substr(start, end - start);
+                    const PrerequisiteGraph::CourseId id = graph.find(code);
+                    if (id == PrerequisiteGraph::kNone) unknownCodes.emplace(static_cast<uint32_t>(requested.size()), code);
+                    requested.push_back(id);
+                }
+                start = end + 1;
+            }
+        }
+        firstRequest.push_back(static_cast<uint32_t>(requested.size()));
+        status.assign(requested.size(), RequestStatus::Registered);
+        return true;
+    }
+
+    void loadHistories(const std::string& dir, unsigned threads) {
+        const size_t words = graph.wordCount();
+        completed.assign(students.size() * words, 0);
+        parallelFor(students.size(), threads, [&](size_t s) {
+            std::ifstream file(dir + "/" + students[s] + ".txt");
+            uint64_t* row = &completed[s * words];
+            std::string course;
+            while (std::getline(file, course)) {
+                if (!course.empty() && course.back() == '\r') course.pop_back();
+                const PrerequisiteGraph::CourseId id = graph.find(course);
+                if (id != PrerequisiteGraph::kNone) row[id / 64] |= uint64_t(1) << (id % 64);
+            }
+        });
+    }
+
+    void validate(unsigned threads, Allocation mode) {
+        const size_t words = graph.wordCount();
+        takenSeats.reset(new std::atomic<int>[credits.size()]);
+        for (size_t c = 0; c < credits.size(); ++c) takenSeats[c].store(0, std::memory_order_relaxed);
+
+        parallelFor(students.size(), threads, [&](size_t s) {
+            const uint64_t* done = &completed[s * words];
+            int total = 0;
+            for (uint32_t r = firstRequest[s]; r < firstRequest[s + 1]; ++r) {
+                const PrerequisiteGraph::CourseId c = requested[r];
+                if (c == PrerequisiteGraph::kNone || c >= credits.size() || credits[c] < 0) {
+                    status[r] = RequestStatus::UnknownCourse;
+                } else if (std::find(requested.begin() + firstRequest[s], requested.begin() + r, c) !=
+                           requested.begin() + r) {
+                    status[r] = RequestStatus::Duplicate;
+                } else if (!graph.eligible(c, done, words)) {
+                    status[r] = RequestStatus::Prerequisites;
+                } else if (mode != Allocation::FirstCome) {
+                    status[r] = RequestStatus::Registered;   // Voeu recevable, attribué par allocate
+                } else if (total + credits[c] > maxCredits) {
+                    status[r] = RequestStatus::Credits;
+                } else if (capacity[c] > 0 && takenSeats[c].fetch_add(1, std::memory_order_relaxed) >= capacity[c]) {
+                    // UE déjà pleine : une place n'est jamais rendue après un succès, donc le
+                    // compteur redescend toujours au nombre exact d'inscrits
+                    takenSeats[c].fetch_sub(1, std::memory_order_relaxed);
+                    status[r] = RequestStatus::Full;
+                } else {
+                    if (capacity[c] == 0) takenSeats[c].fetch_add(1, std::memory_order_relaxed);
+                    total += credits[c];
+                    status[r] = RequestStatus::Registered;
+                }
+            }
+        });
+    }
+
+    // Attribue les voeux recevables (Registered après validate). Chaque couple étudiant-UE est
+    // proposé au plus une fois : le tout est linéaire en nombre de voeux, à un log près pour
+    // les tas des UE pleines, plus en mode Stable le calcul des priorités (voir unlocks).
+    void allocate(Allocation mode, uint32_t seed) {
+        const size_t n = students.size();
+        std::vector<uint32_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937 rng(seed);
+        std::shuffle(order.begin(), order.end(), rng);
+        std::vector<uint32_t> rank(n);
+        for (uint32_t i = 0; i < n; ++i) rank[order[i]] = i;
+
+        enum : uint8_t { Pending, Held, Rejected };
+        std::vector<uint8_t> state(requested.size(), Pending);
+        std::vector<uint32_t> owner(requested.size());
+        for (uint32_t s = 0; s < n; ++s) {
+            for (uint32_t r = firstRequest[s]; r < firstRequest[s + 1]; ++r) owner[r] = s;
+        }
+        std::vector<int> held(n, 0);   // Crédits retenus par étudiant
+        std::vector<int> seats(credits.size(), 0);
+
+        if (mode == Allocation::Lottery) {
+            for (uint32_t s : order) {
+                for (uint32_t r = firstRequest[s]; r < firstRequest[s + 1]; ++r) {
+                    const PrerequisiteGraph::CourseId c = requested[r];
+                    if (status[r] != RequestStatus::Registered) continue;
+                    if (held[s] + credits[c] > maxCredits) continue;
+                    if (capacity[c] > 0 && seats[c] >= capacity[c]) {
+                        state[r] = Rejected;
+                        continue;
+                    }
+                    ++seats[c];
+                    held[s] += credits[c];
+                    state[r] = Held;
+                }
+            }
+        } else {
+            // Priorité de chaque voeu auprès de son UE (voir unlocks)
+            const std::vector<std::vector<PrerequisiteGraph::CourseId>> next = dependants();
+            std::vector<uint16_t> priority(requested.size(), 0);
+            for (uint32_t r = 0; r < requested.size(); ++r) {
+                const PrerequisiteGraph::CourseId c = requested[r];
+                if (status[r] != RequestStatus::Registered || capacity[c] == 0) continue;
+                priority[r] = static_cast<uint16_t>(std::min(unlocks(r, owner[r], next[c]), 0xffff));
+            }
+            // holders[c] : demandes retenues par l'UE c, en tas dont le sommet est le plus mal classé
+            std::vector<std::vector<uint32_t>> holders(credits.size());
+            auto better = [&](uint32_t a, uint32_t b) {
+                if (priority[a] != priority[b]) return priority[a] > priority[b];
+                return rank[owner[a]] < rank[owner[b]];
+            };
+            std::vector<uint32_t> waiting(order.rbegin(), order.rend());
+            while (!waiting.empty()) {
+                const uint32_t s = waiting.back();
+                waiting.pop_back();
+                // Repart du premier voeu : un rejet a pu libérer les crédits d'un voeu sauté
+                for (uint32_t r = firstRequest[s]; r < firstRequest[s + 1]; ++r) {
+                    const PrerequisiteGraph::CourseId c = requested[r];
+                    if (status[r] != RequestStatus::Registered || state[r] != Pending) continue;
+                    if (held[s] + credits[c] > maxCredits) continue;
+                    state[r] = Held;
+                    held[s] += credits[c];
+                    if (capacity[c] == 0) continue;
+                    std::vector<uint32_t>& heap = holders[c];
+                    heap.push_back(r);
+                    std::push_heap(heap.begin(), heap.end(), better);
+                    if (heap.size() <= static_cast<size_t>(capacity[c])) continue;
+                    std::pop_heap(heap.begin(), heap.end(), better);
+                    const uint32_t evicted = heap.back();
+                    heap.pop_back();
+                    state[evicted] = Rejected;
+                    held[owner[evicted]] -= credits[c];
+                    if (owner[evicted] != s) waiting.push_back(owner[evicted]);
+                }
+            }
+            for (uint32_t r = 0; r < requested.size(); ++r) {
+                if (state[r] == Held) ++seats[requested[r]];
+            }
+        }
+
+        for (uint32_t r = 0; r < requested.size(); ++r) {
+            if (status[r] != RequestStatus::Registered) continue;
+            // Un voeu jamais proposé est resté hors du plafond de crédits
+            status[r] = state[r] == Held ? RequestStatus::Registered
+                      : state[r] == Rejected ? RequestStatus::Full : RequestStatus::Credits;
+        }
+        for (size_t c = 0; c < credits.size(); ++c) takenSeats[c].store(seats[c], std::memory_order_relaxed);
+    }
+
+    // UE du catalogue qui demandent c, directement ou non, pour chaque UE c à places limitées
+    std::vector<std::vector<PrerequisiteGraph::CourseId>> dependants() const {
+        std::vector<std::vector<PrerequisiteGraph::CourseId>> result(credits.size());
+        for (PrerequisiteGraph::CourseId d = 0; d < credits.size(); ++d) {
+            if (credits[d] < 0 || graph.isBlocked(d)) continue;
+            for (PrerequisiteGraph::CourseId c = 0; c < credits.size(); ++c) {
+                if (capacity[c] > 0 && graph.requires(d, c)) result[c].push_back(d);
+            }
+        }
+        return result;
+    }
+
+    // Priorité du voeu r auprès de son UE c : nombre d'UE que c ouvrirait à l'étudiant, celles
+    // qui la demandent et dont il a validé tous les autres prérequis. Qui n'attend plus que c
+    // pour avancer passe avant qui la prend sans en avoir besoin.
+    int unlocks(uint32_t r, uint32_t student, const std::vector<PrerequisiteGraph::CourseId>& next) const {
+        const size_t words = graph.wordCount();
+        const PrerequisiteGraph::CourseId c = requested[r];
+        const uint64_t* done = &completed[student * words];
+        int count = 0;
+        for (PrerequisiteGraph::CourseId d : next) {
+            if (done[d / 64] >> (d % 64) & 1) continue;
+            const uint64_t* row = graph.prerequisites(d);
+            bool missing = false;
+            for (size_t w = 0; w < words && !missing; ++w) {
+                const uint64_t own = w == c / 64 ? uint64_t(1) << (c % 64) : 0;
+                missing = (row[w] & ~(done[w] | own)) != 0;
+            }
+            if (!missing) ++count;
+        }
+        return count;
+    }
+
+    // Une ligne "étudiant,UE,issue" par UE demandée, composée dans un seul tampon
+    bool write(const std::string& path) const {
+        std::string out;
+        out.reserve(requested.size() * 24);
+        for (size_t s = 0; s < students.size(); ++s) {
+            for (uint32_t r = firstRequest[s]; r < firstRequest[s + 1]; ++r) {
+                out += students[s];
+                out += ',';
+                out += requested[r] == PrerequisiteGraph::kNone ? unknownCodes.at(r) : graph.code(requested[r]);
+                out += ',';
+                out += statusLabel(status[r]);
+                out += '\n';
+            }
+        }
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        const bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+        return std::fclose(file) == 0 && ok;
+    }
+};
+
+#endif // BULK_REGISTRATION_H
@@ -0,0 +1,161 @@
+#ifndef PREREQUISITE_GRAPH_H
+#define PREREQUISITE_GRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Ensemble d'UE : un bit par identifiant d'UE, 64 UE par mot
+using CourseSet = std::vector<uint64_t>;
+
+// Graphe des prérequis : chaque code d'UE reçoit un identifiant entier, et chaque UE garde la
+// fermeture transitive de ses prérequis sous forme d'ensemble de bits. Pour s'inscrire à une
+// UE, il faut avoir validé tous ses prérequis, directs ou non : la vérification est un ET
+// mot à mot entre la fermeture de l'UE et le complément des UE validées.
+//
+// La fermeture est calculée dans l'ordre topologique (algorithme de Kahn) : la ligne d'une UE
+// est le OU des lignes de ses prérequis directs, 64 UE à la fois. Les UE qui n'ont pas d'ordre
+// topologique sont prises dans un cycle, ou en dépendent : elles sont bloquées.
+class PrerequisiteGraph {
+public:
+    using CourseId = uint32_t;
+    static constexpr CourseId kNone = UINT32_MAX;
+
+    enum class Status { Ok, Duplicate, UnknownPrerequisite, Cycle };
+
+    CourseId find(const std::string& code) const {
+        auto it = ids.find(code);
+        return it == ids.end() ? kNone : it->second;
+    }
+
+    // Identifiant du code, créé au besoin (une UE peut être citée comme prérequis avant d'être
+    // déclarée, ou ne jamais l'être : ancienne UE que des étudiants ont validée)
+    CourseId intern(const std::string& code) {
+        auto it = ids.find(code);
+        if (it != ids.end()) return it->second;
+        const CourseId id = static_cast<CourseId>(codes.size());
+        ids.emplace(code, id);
+        codes.push_back(code);
+        direct.emplace_back();
+        declared.push_back(false);
+        return id;
+    }
+
+    const std::string& code(CourseId id) const { return codes[id]; }
+    size_t size() const { return codes.size(); }
+    size_t wordCount() const { return words; }
+    bool isBlocked(CourseId id) const { return id < blocked.size() && blocked[id]; }
+
+    // Déclaration au chargement du catalogue : la fermeture n'est recalculée que par build()
+    void declare(const std::string& code, const std::vector<std::string>& prerequisites) {
+        const CourseId id = intern(code);
+        std::vector<CourseId> pre;
+        for (const std::string& p : prerequisites) pre.push_back(intern(p));   // intern peut agrandir direct
+        declared[id] = true;
+        direct[id] = std::move(pre);
+    }
+
+    // Recalcule la fermeture de toutes les UE ; renvoie les UE bloquées par un cycle
+    std::vector<CourseId> build() {
+        const size_t n = codes.size();
+        words = n == 0 ? 1 : (n + 63) / 64;
+        closure.assign(n * words, 0);
+        blocked.assign(n, true);
+
+        std::vector<std::vector<CourseId>> dependents(n);
+        std::vector<size_t> pending(n);
+        std::vector<CourseId> ready;
+        for (CourseId c = 0; c < n; ++c) {
+            pending[c] = direct[c].size();
+            for (CourseId p : direct[c]) dependents[p].push_back(c);
+            if (pending[c] == 0) ready.push_back(c);
+        }
+        while (!ready.empty()) {
+            const CourseId c = ready.back();
+            ready.pop_back();
+            blocked[c] = false;
+            uint64_t* row = &closure[c * words];
+            for (CourseId p : direct[c]) {
+                const uint64_t* pre = &closure[p * words];
+                for (size_t w = 0; w < words; ++w) row[w] |= pre[w];
+                row[p / 64] |= uint64_t(1) << (p % 64);
+            }
+            for (CourseId d : dependents[c]) {
+                if (--pending[d] == 0) ready.push_back(d);
+            }
+        }
+
+        std::vector<CourseId> cycle;
+        for (CourseId c = 0; c < n; ++c) {
+            if (blocked[c]) cycle.push_back(c);
+        }
+        return cycle;
+    }
+
+    // Création d'une UE par le secrétariat : refusée si le code existe déjà, si un prérequis
+    // est inconnu, ou si elle fermerait un cycle (l'UE est déjà un prérequis, direct ou non,
+    // de l'un de ses propres prérequis)
+    Status add(const std::string& code, const std::vector<std::string>& prerequisites) {
+        const CourseId existing = find(code);
+        if (existing != kNone && declared[existing]) return Status::Duplicate;
+        for (const std::string& pre : prerequisites) {
+            const CourseId p = find(pre);
+            if (p == kNone) return Status::UnknownPrerequisite;
+            if (existing != kNone && (p == existing || requires(p, existing))) return Status::Cycle;
+        }
+        declare(code, prerequisites);
+        build();
+        return Status::Ok;
+    }
+
+    // prerequisite fait-il partie des prérequis, directs ou non, de course ?
+    bool requires(CourseId course, CourseId prerequisite) const {
+        if (course >= blocked.size() || prerequisite >= blocked.size()) return false;
+        return closure[course * words + prerequisite / 64] >> (prerequisite % 64) & 1;
+    }
+
+    // Prérequis, directs ou non, de course : wordCount() mots (nullptr si l'UE est inconnue de build())
+    const uint64_t* prerequisites(CourseId course) const {
+        return course < blocked.size() ? &closure[course * words] : nullptr;
+    }
+
+    // Ensemble des UE connues parmi codes (les codes inconnus sont ignorés)
+    CourseSet courseSet(const std::vector<std::string>& courseCodes) const {
+        CourseSet set(words, 0);
+        for (const std::string& c : courseCodes) {
+            const CourseId id = find(c);
+            if (id != kNone) set[id / 64] |= uint64_t(1) << (id % 64);
+        }
+        return set;
+    }
+
+    // Tous les prérequis, directs ou non, de course sont-ils dans completed ?
+    bool eligible(CourseId course, const CourseSet& completed) const {
+        return eligible(course, completed.data(), completed.size());
+    }
+
+    // Même test sur completedWords mots rangés à partir de completed
+    bool eligible(CourseId course, const uint64_t* completed, size_t completedWords) const {
+        if (course >= blocked.size() || blocked[course]) return false;
+        const uint64_t* row = &closure[course * words];
+        for (size_t w = 0; w < words; ++w) {
+            const uint64_t done = w < completedWords ? completed[w] : 0;
+            if (row[w] & ~done) return false;
+        }
+        return true;
+    }
+
+private:
+    std::unordered_map<std::string, CourseId> ids;
+    std::vector<std::string> codes;
+    std::vector<std::vector<CourseId>> direct;   // Prérequis directs
+    std::vector<bool> declared;                  // UE du catalogue (et non simple prérequis cité)
+
+    size_t words = 1;
+    std::vector<uint64_t> closure;   // Ligne c : prérequis directs et indirects de c
+    std::vector<bool> blocked;       // UE dans un cycle, ou qui dépend d'un cycle
+};
+
+#endif // PREREQUISITE_GRAPH_H